@@ -0,0 +1,159 @@
+#ifndef BASELINE_H
+#define BASELINE_H
+
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <FEHLCD.h>
+#include <math.h>
+
+//The original open-loop drive loops from Robot_Design_Code, kept so benchmarks have something to compare against
+namespace Baseline
+{
+    //Rest period the original code used after every move
+    const float OLD_REST = 0.1;
+
+    inline void linearMove(FEHMotor &leftMotor, FEHMotor &rightMotor, DigitalEncoder &leftEncoder, DigitalEncoder &rightEncoder, float distance, float speed)
+    {
+        float x = (318.0/(2.5*3.1415))*fabs(distance);
+        leftEncoder.ResetCounts();
+        rightEncoder.ResetCounts();
+        rightMotor.SetPercent(distance > 0 ? speed : -speed);
+        leftMotor.SetPercent(distance > 0 ? speed : -speed);
+        while(leftEncoder.Counts() < x)
+        {
+        }
+        leftMotor.Stop();
+        rightMotor.Stop();
+    }
+
+    inline void pivot(FEHMotor &leftMotor, FEHMotor &rightMotor, DigitalEncoder &leftEncoder, DigitalEncoder &rightEncoder, float degrees, float speed)
+    {
+        float x = ((318*7.5)/(360*2.5))*fabs(degrees);
+        leftEncoder.ResetCounts();
+        rightEncoder.ResetCounts();
+        if (degrees > 0)
+        {
+            rightMotor.SetPercent(-speed);
+            leftMotor.SetPercent(speed);
+            while ((leftEncoder.Counts()) <= x)
+            {
+            }
+        } else if (degrees < 0)
+        {
+            rightMotor.SetPercent(speed);
+            leftMotor.SetPercent(-speed);
+            while ((rightEncoder.Counts()) <= x)
+            {
+            }
+        }
+        leftMotor.Stop();
+        rightMotor.Stop();
+    }
+
+    //Optosensor break values and line following states from Robot_Design_Code
+    const float LINE_LEFT_BREAK = 1.0;
+    const float LINE_CENTER_BREAK = 1.27;
+    const float LINE_RIGHT_BREAK = 2.68;
+    enum {ON_LINE, LINE_ON_RIGHT, LINE_ON_LEFT, LINE_FAR_RIGHT, LINE_FAR_LEFT, OFF_LINE};
+
+    /*One pass of the original lineFollow() loop ending on checkCondition(2), reading the sensors wherever
+     the if/else chain needs them. Returns false where the loop would have ended*/
+    inline bool lineFollowStep(AnalogInputPin &leftLine, AnalogInputPin &centerLine, AnalogInputPin &rightLine, FEHMotor &leftMotor, FEHMotor &rightMotor, int *state, int *time)
+    {
+        const float RIGHT_BREAK = LINE_RIGHT_BREAK, CENTER_BREAK = LINE_CENTER_BREAK, LEFT_BREAK = LINE_LEFT_BREAK;
+        if (rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
+        {
+            return false;
+        }
+        if(rightLine.Value() < RIGHT_BREAK && centerLine.Value() > CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
+        {
+            *state = ON_LINE;
+            if(*time == 0)
+            {
+                *time = TimeNow();
+            }
+        } else if (rightLine.Value() > RIGHT_BREAK && centerLine.Value() > CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
+        {
+            *state = LINE_ON_RIGHT;
+            *time = 0;
+        }else if (rightLine.Value() < RIGHT_BREAK && centerLine.Value() > CENTER_BREAK && leftLine.Value() > LEFT_BREAK)
+        {
+            *state = LINE_ON_LEFT;
+            *time = 0;
+        }else if (rightLine.Value() > RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
+        {
+            *state = LINE_FAR_RIGHT;
+            *time = 0;
+        }else if (rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() > LEFT_BREAK)
+        {
+            *state = LINE_FAR_LEFT;
+            *time = 0;
+        }else if (rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
+        {
+            *state = OFF_LINE;
+            *time = 0;
+        }
+        switch(*state)
+        {
+        case ON_LINE:
+            if(TimeNow() - *time < 2.0)
+            {
+                rightMotor.SetPercent(-10);
+                leftMotor.SetPercent(-10);
+            }else if (TimeNow() - *time >= 2.0)
+            {
+                rightMotor.SetPercent(-20);
+                leftMotor.SetPercent(-20);
+            }
+            break;
+        case LINE_ON_RIGHT:
+            rightMotor.SetPercent(-20);
+            leftMotor.SetPercent(-10);
+            break;
+        case LINE_ON_LEFT:
+            rightMotor.SetPercent(-10);
+            leftMotor.SetPercent(-20);
+            break;
+        case LINE_FAR_RIGHT:
+            rightMotor.SetPercent(-30);
+            leftMotor.SetPercent(-10);
+            break;
+        case LINE_FAR_LEFT:
+            rightMotor.SetPercent(-10);
+            leftMotor.SetPercent(-30);
+            break;
+        default:
+            rightMotor.Stop();
+            leftMotor.Stop();
+            break;
+        }
+        return true;
+    }
+
+    //Color codes and the original cdsColor() from Robot_Design_Code, clearing the screen on every call
+    enum {CDSRED, CDSBLUE, NO_COLOR, NO_READING};
+
+    inline int cdsColor(AnalogInputPin &CdS)
+    {
+        if (CdS.Value() > 0 && CdS.Value() <= 0.90)
+        {
+            LCD.Clear(FEHLCD::Red);
+            return CDSRED;
+        } else if (CdS.Value() > 0.90 && CdS.Value() <= 1.8)
+        {
+            LCD.Clear(FEHLCD::Blue);
+            return CDSBLUE;
+        } else if (CdS.Value() > 1.80 && CdS.Value() <= 3.3)
+        {
+            LCD.Clear(FEHLCD::Black);
+            LCD.Write("No colored light detected");
+            return NO_COLOR;
+        } else
+        {
+            return NO_READING;
+        }
+    }
+}
+
+#endif
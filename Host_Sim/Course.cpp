@@ -0,0 +1,379 @@
+#include "Course.h"
+#include "FEHHost.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+//Closest a chassis corner can get to a wall, and how close it has to be to press a bump switch
+#define CONTACT 0.03
+#define SWITCH_TRAVEL 0.06
+//Width of the tape lines and of the optosensor spot, the reading ramps over the spot as it crosses an edge
+#define TAPE_WIDTH 0.75
+#define OPTO_SPOT 0.15
+//CdS cell voltages under a red light, a blue light and with no colored light
+#define CDS_RED 0.5
+#define CDS_BLUE 1.3
+#define CDS_AMBIENT 2.6
+//Servo angles past which the fork has turned the burger wheel and the arm is low enough to catch the ticket
+#define FORK_TURNED 60
+#define ARM_DOWN 60
+
+//FEHIO pins Robot_Design_Code wires the sensors to, the line sensors and switches are consecutive
+#define PIN_CDS 2
+#define PIN_LINE_LEFT 8
+#define PIN_LINE_CENTER 9
+#define PIN_LINE_RIGHT 10
+#define PIN_FRONT_LEFT 16
+#define PIN_FRONT_RIGHT 17
+#define PIN_FORK 18
+#define PIN_BACK_LEFT 19
+#define PIN_BACK_RIGHT 20
+#define SERVO_ARM 0
+#define SERVO_FORK 1
+
+Course::Course()
+{
+    lever = 0;
+    strcpy(jukebox, "");
+    //Milkshake 2 measured from the axle center
+    front = 4.5;
+    back = -4.5;
+    halfWidth = 4.0;
+    lineX = -4.0;
+    lineSpacing = 0.6;
+    cdsX = 3.5;
+    armReach = 6.0;
+    //0.23 s per 60 degrees of horn travel on servos calibrated from 500 to 2350 us
+    servoSpeed = 280.0;
+
+    _wallCount = _lineCount = _lightCount = _goalCount = 0;
+    _lightX = _lightY = 0;
+    _lightR = -1;
+    _lightOn = 0;
+    _arm = _fork = _armCmd = _forkCmd = 0;
+    Sense();
+}
+
+bool Course::Load(const char *filename)
+{
+    FILE *file = fopen(filename, "r");
+    char text[256], word[COURSE_NAME], name[COURSE_NAME], color[COURSE_NAME];
+    double a, b, c, d;
+    int number = 0;
+    bool ok = true;
+
+    if (!file)
+    {
+        fprintf(stderr, "Course: can't open %s\n", filename);
+        return false;
+    }
+    while (ok && fgets(text, sizeof(text), file))
+    {
+        number++;
+        if (strchr(text, '#'))
+        {
+            *strchr(text, '#') = 0;
+        }
+        if (sscanf(text, "%15s", word) != 1)
+        {
+            continue;
+        }
+        if (strcmp(word, "start") == 0 && sscanf(text, "%*s %lf %lf %lf", &a, &b, &c) == 3)
+        {
+            x = a;
+            y = b;
+            heading = c*M_PI/180.0;
+        } else if (strcmp(word, "startlight") == 0 && sscanf(text, "%*s %lf %lf %lf %lf", &a, &b, &c, &d) == 4)
+        {
+            _lightX = a;
+            _lightY = b;
+            _lightR = c;
+            _lightOn = d;
+        } else if ((strcmp(word, "wall") == 0 || strcmp(word, "line") == 0) && sscanf(text, "%*s %lf %lf %lf %lf", &a, &b, &c, &d) == 4)
+        {
+            Segment *s = (word[0] == 'w') ? &_walls[_wallCount++] : &_lines[_lineCount++];
+            s->x1 = a;
+            s->y1 = b;
+            s->x2 = c;
+            s->y2 = d;
+            ok = _wallCount < COURSE_MAX && _lineCount < COURSE_MAX;
+        } else if (strcmp(word, "light") == 0 && sscanf(text, "%*s %15s %lf %lf %lf %15s", name, &a, &b, &c, color) == 5)
+        {
+            Spot *s = &_lights[_lightCount++];
+            strcpy(s->name, name);
+            s->x = a;
+            s->y = b;
+            s->r = c;
+            s->kind = (strcmp(color, "red") == 0) ? 0 : 1;
+            ok = _lightCount < COURSE_MAX;
+        } else if ((strcmp(word, "button") == 0 || strcmp(word, "fork") == 0 || strcmp(word, "arm") == 0)
+                   && sscanf(text, "%*s %15s %lf %lf %lf", name, &a, &b, &c) == 4)
+        {
+            Spot *s = &_goals[_goalCount++];
+            strcpy(s->name, name);
+            s->x = a;
+            s->y = b;
+            s->r = c;
+            s->kind = (word[0] == 'b') ? GOAL_FRONT : (word[0] == 'f') ? GOAL_FORK : GOAL_ARM;
+            s->scored = -1;
+            ok = _goalCount < COURSE_MAX;
+        } else
+        {
+            ok = false;
+        }
+    }
+    fclose(file);
+    Sense();
+    if (!ok)
+    {
+        fprintf(stderr, "Course: %s line %d not understood: %s", filename, number, text);
+    }
+    return ok;
+}
+
+int Course::GoalCount()
+{
+    return _goalCount;
+}
+
+const char *Course::GoalName(int i)
+{
+    return _goals[i].name;
+}
+
+double Course::GoalTime(int i)
+{
+    return _goals[i].scored;
+}
+
+double Course::StartTime()
+{
+    return _lightOn;
+}
+
+const Course::Segment *Course::Walls(int *count)
+{
+    *count = _wallCount;
+    return _walls;
+}
+
+const Course::Segment *Course::Lines(int *count)
+{
+    *count = _lineCount;
+    return _lines;
+}
+
+const Course::Spot *Course::Lights(int *count)
+{
+    *count = _lightCount;
+    return _lights;
+}
+
+const Course::Spot *Course::Goals(int *count)
+{
+    *count = _goalCount;
+    return _goals;
+}
+
+void Course::Step(double dt)
+{
+    int i;
+    DiffDrive::Step(dt);
+    Slew(&_arm, _armCmd, servoSpeed*dt);
+    Slew(&_fork, _forkCmd, servoSpeed*dt);
+    Sense();
+    for (i = 0; i < _goalCount; i++)
+    {
+        Spot &g = _goals[i];
+        if (g.scored >= 0)
+        {
+            continue;
+        }
+        if ((g.kind == GOAL_FRONT && Near(g, front + SWITCH_TRAVEL, 0))
+            || (g.kind == GOAL_FORK && _fork > FORK_TURNED && Near(g, back - SWITCH_TRAVEL, 0))
+            || (g.kind == GOAL_ARM && _arm > ARM_DOWN && Near(g, 0, -armReach)))
+        {
+            g.scored = FEHHost::Now();
+        }
+    }
+}
+
+void Course::Sense()
+{
+    double wx, wy;
+    int i;
+
+    Place(x, y, heading, cdsX, 0, &wx, &wy);
+    _cds = CDS_AMBIENT;
+    if (FEHHost::Now() >= _lightOn && hypot(wx - _lightX, wy - _lightY) < _lightR)
+    {
+        _cds = CDS_RED;
+    }
+    for (i = 0; i < _lightCount; i++)
+    {
+        if (strcmp(_lights[i].name, jukebox) == 0 && hypot(wx - _lights[i].x, wy - _lights[i].y) < _lights[i].r)
+        {
+            _cds = (_lights[i].kind == 0) ? CDS_RED : CDS_BLUE;
+        }
+    }
+
+    //The optosensors are at the back and named looking the way line following drives, so "left" is on the robot's right
+    _line[0] = LineValue(lineX, -lineSpacing, 0.5, 1.8);
+    _line[1] = LineValue(lineX, 0, 0.7, 2.2);
+    _line[2] = LineValue(lineX, lineSpacing, 2.3, 3.1);
+
+    _pressed[0] = Touching(front, halfWidth);
+    _pressed[1] = Touching(front, -halfWidth);
+    _pressed[2] = false;
+    _pressed[3] = Touching(back, halfWidth);
+    _pressed[4] = Touching(back, -halfWidth);
+    for (i = 0; i < _goalCount; i++)
+    {
+        if (_goals[i].kind == GOAL_FORK && Near(_goals[i], back - SWITCH_TRAVEL, 0))
+        {
+            _pressed[2] = true;
+        }
+    }
+}
+
+void Course::SetServo(int port, float degree)
+{
+    if (port == SERVO_ARM)
+    {
+        _armCmd = degree;
+    } else if (port == SERVO_FORK)
+    {
+        _forkCmd = degree;
+    }
+}
+
+float Course::ServoAngle(int port)
+{
+    return (port == SERVO_ARM) ? _arm : (port == SERVO_FORK) ? _fork : 0;
+}
+
+void Course::Slew(float *angle, float command, double step)
+{
+    if (fabs(command - *angle) <= step)
+    {
+        *angle = command;
+    } else
+    {
+        *angle += (command > *angle) ? step : -step;
+    }
+}
+
+float Course::AnalogValue(int pin)
+{
+    if (pin == PIN_CDS)
+    {
+        return _cds;
+    }
+    if (pin >= PIN_LINE_LEFT && pin <= PIN_LINE_RIGHT)
+    {
+        return _line[pin - PIN_LINE_LEFT];
+    }
+    return 3.3;
+}
+
+bool Course::DigitalValue(int pin)
+{
+    //Switches are pulled up, so a pressed switch reads false
+    if (pin >= PIN_FRONT_LEFT && pin <= PIN_BACK_RIGHT)
+    {
+        return !_pressed[pin - PIN_FRONT_LEFT];
+    }
+    return true;
+}
+
+bool Course::RPSPose(float *rx, float *ry, float *rheading)
+{
+    double degrees = fmod(heading*180.0/M_PI, 360.0);
+    *rx = x;
+    *ry = y;
+    *rheading = (degrees < 0) ? degrees + 360 : degrees;
+    return true;
+}
+
+int Course::IceCream()
+{
+    return lever;
+}
+
+bool Course::Allowed(double nx, double ny, double nheading)
+{
+    const double cornerX[4] = {front, front, back, back};
+    const double cornerY[4] = {halfWidth, -halfWidth, halfWidth, -halfWidth};
+    double wx, wy, ox, oy, after;
+    int i;
+    for (i = 0; i < 4; i++)
+    {
+        Place(nx, ny, nheading, cornerX[i], cornerY[i], &wx, &wy);
+        after = WallDistance(wx, wy);
+        if (after < CONTACT)
+        {
+            //Moving away from a wall it is already against is always fine
+            Place(x, y, heading, cornerX[i], cornerY[i], &ox, &oy);
+            if (after <= WallDistance(ox, oy))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void Course::Place(double nx, double ny, double nheading, double px, double py, double *wx, double *wy)
+{
+    *wx = nx + px*cos(nheading) - py*sin(nheading);
+    *wy = ny + px*sin(nheading) + py*cos(nheading);
+}
+
+double Course::SegmentDistance(const Segment *segs, int count, double px, double py)
+{
+    double best = 1e9, dx, dy, t, d;
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        const Segment &s = segs[i];
+        dx = s.x2 - s.x1;
+        dy = s.y2 - s.y1;
+        t = ((px - s.x1)*dx + (py - s.y1)*dy)/(dx*dx + dy*dy);
+        t = (t < 0) ? 0 : (t > 1) ? 1 : t;
+        d = hypot(px - s.x1 - t*dx, py - s.y1 - t*dy);
+        if (d < best)
+        {
+            best = d;
+        }
+    }
+    return best;
+}
+
+double Course::WallDistance(double wx, double wy)
+{
+    return SegmentDistance(_walls, _wallCount, wx, wy);
+}
+
+bool Course::Touching(double px, double py)
+{
+    double wx, wy;
+    Place(x, y, heading, px, py, &wx, &wy);
+    return WallDistance(wx, wy) < SWITCH_TRAVEL;
+}
+
+bool Course::Near(const Spot &spot, double px, double py)
+{
+    double wx, wy;
+    Place(x, y, heading, px, py, &wx, &wy);
+    return hypot(wx - spot.x, wy - spot.y) < spot.r;
+}
+
+float Course::LineValue(double px, double py, float off, float on)
+{
+    double wx, wy, d, cover;
+    Place(x, y, heading, px, py, &wx, &wy);
+    d = SegmentDistance(_lines, _lineCount, wx, wy);
+    cover = (TAPE_WIDTH/2 + OPTO_SPOT - d)/(2*OPTO_SPOT);
+    cover = (cover < 0) ? 0 : (cover > 1) ? 1 : cover;
+    return off + (on - off)*cover;
+}
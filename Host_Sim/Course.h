@@ -0,0 +1,114 @@
+#ifndef COURSE_H
+#define COURSE_H
+
+#include "DiffDrive.h"
+
+//Most of each kind of feature a course map can hold
+#define COURSE_MAX 64
+//Longest feature name in a course map
+#define COURSE_NAME 16
+
+//Kinds of course objectives, see Course::Load() for what each one needs to score
+#define GOAL_FRONT 0
+#define GOAL_FORK 1
+#define GOAL_ARM 2
+
+/*The competition course as seen by the robot's sensors. The robot is a DiffDrive with a rectangular
+ chassis that walls stop, and every FEHIO input Robot_Design_Code uses is synthesized from where the
+ chassis sits on the map: the CdS cell from the start and jukebox lights, the optosensors from the tape
+ lines, the bump switches from wall contact and the fork switch from the burger wheel.
+
+ Coordinates are inches with x along the long side of the course, headings are degrees counter-clockwise
+ from +x like RPS reports them. Nothing is random, so the same map and settings always give the same run*/
+class Course : public DiffDrive
+{
+public:
+    Course();
+
+    /*Reads a map, one feature per line, # starts a comment:
+       start x y heading               where the robot is placed
+       startlight x y radius seconds   red light under the robot that turns on after seconds
+       wall x1 y1 x2 y2                a wall or any other edge the chassis can't cross
+       line x1 y1 x2 y2                a strip of tape the optosensors can see
+       light name x y radius red|blue  a colored light the CdS cell can see
+       button name x y radius          scored when the front of the robot reaches it (sink, levers, buttons)
+       fork name x y radius            presses the fork switch, scored if the fork servo turns while pressed
+       arm name x y radius             scored when the lowered arm tip reaches it
+     Returns false and prints the offending line if the map can't be read*/
+    bool Load(const char *filename);
+
+    //Which ice cream lever RPS reports
+    int lever;
+    //Name of the jukebox light that is lit, an empty name leaves them all off
+    char jukebox[COURSE_NAME];
+
+    //Objective results, time is -1 until the objective is scored
+    int GoalCount();
+    const char *GoalName(int i);
+    double GoalTime(int i);
+    //Time the start light turned on
+    double StartTime();
+
+    struct Segment
+    {
+        double x1, y1, x2, y2;
+    };
+    struct Spot
+    {
+        char name[COURSE_NAME];
+        double x, y, r;
+        //0 red and 1 blue for lights, a GOAL_ kind for objectives
+        int kind;
+        double scored;
+    };
+    //The map as loaded, for tools that draw the course
+    const Segment *Walls(int *count);
+    const Segment *Lines(int *count);
+    const Spot *Lights(int *count);
+    const Spot *Goals(int *count);
+
+    void Step(double dt);
+    void SetServo(int port, float degree);
+    //Where the arm or fork servo actually is, it lags the last command by servoSpeed
+    float ServoAngle(int port);
+    float AnalogValue(int pin);
+    bool DigitalValue(int pin);
+    bool RPSPose(float *x, float *y, float *heading);
+    int IceCream();
+
+    //Chassis outline and sensor positions in inches from the wheel axle center, +x is the front
+    double front, back, halfWidth;
+    double lineX, lineSpacing;
+    double cdsX;
+    double armReach;
+    //How fast the arm and fork servos follow their commands, commanded degrees per second
+    double servoSpeed;
+
+protected:
+    bool Allowed(double nx, double ny, double nheading);
+
+private:
+    Segment _walls[COURSE_MAX], _lines[COURSE_MAX];
+    Spot _lights[COURSE_MAX], _goals[COURSE_MAX];
+    int _wallCount, _lineCount, _lightCount, _goalCount;
+    double _lightX, _lightY, _lightR, _lightOn;
+    float _arm, _fork, _armCmd, _forkCmd;
+    //Sensor readings for the current pose, worked out once per physics step rather than on every read
+    float _cds, _line[3];
+    bool _pressed[5];
+
+    void Sense();
+    //Moves a servo angle up to step degrees towards its command
+    static void Slew(float *angle, float command, double step);
+    //Point at robot frame position (px, py) for a pose
+    void Place(double nx, double ny, double nheading, double px, double py, double *wx, double *wy);
+    //Distance from a point to the nearest of a list of segments
+    static double SegmentDistance(const Segment *segs, int count, double px, double py);
+    double WallDistance(double wx, double wy);
+    bool Touching(double px, double py);
+    bool Near(const Spot &spot, double px, double py);
+    //Optosensor voltage at a robot frame point, blending between off and on across the tape edge
+    float LineValue(double px, double py, float off, float on);
+};
+
+#endif
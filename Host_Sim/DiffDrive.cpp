@@ -0,0 +1,121 @@
+#include "DiffDrive.h"
+#include <math.h>
+
+DiffDrive::DiffDrive(int leftPort, int rightPort, int leftPin, int rightPin)
+{
+    wheel = 2.5;
+    track = 7.5;
+    countsPerRev = 318;
+    maxRevs = 2.4;
+    tau = 0.08;
+    deadband = 4.0;
+    //The right IGWAN on Milkshake 2 is noticeably weaker, this is what makes open-loop moves drift
+    leftGain = 1.0;
+    rightGain = 0.94;
+
+    x = y = heading = 0;
+    leftSpeed = rightSpeed = 0;
+    leftTravel = rightTravel = 0;
+
+    _leftPort = leftPort;
+    _rightPort = rightPort;
+    _leftPin = leftPin;
+    _rightPin = rightPin;
+    _leftCmd = _rightCmd = 0;
+    _leftEdges = _rightEdges = 0;
+}
+
+double DiffDrive::Target(float percent, double gain)
+{
+    if (fabs(percent) < deadband)
+    {
+        return 0;
+    }
+    return percent/100.0*maxRevs*gain*wheel*M_PI;
+}
+
+void DiffDrive::Step(double dt)
+{
+    double a = dt/(tau + dt);
+
+    //First order lag from command to wheel speed
+    leftSpeed += (Target(_leftCmd, leftGain) - leftSpeed)*a;
+    rightSpeed += (Target(_rightCmd, rightGain) - rightSpeed)*a;
+
+    //Against a wall the free side keeps driving and swings the robot square, skidding the pinned wheel
+    //backwards if it has to, and only once it can't turn any further does it stall
+    if (Move(leftSpeed, rightSpeed, dt))
+    {
+        return;
+    }
+    if (Move(0, rightSpeed, dt) || Move(-rightSpeed/2, rightSpeed, dt))
+    {
+        leftSpeed = 0;
+        return;
+    }
+    if (Move(leftSpeed, 0, dt) || Move(leftSpeed, -leftSpeed/2, dt))
+    {
+        rightSpeed = 0;
+        return;
+    }
+    //Pinned, the wheels stall so the encoders stop counting too
+    leftSpeed = rightSpeed = 0;
+}
+
+bool DiffDrive::Move(double left, double right, double dt)
+{
+    double v = (left + right)/2.0;
+    double w = (right - left)/track;
+    double nheading = heading + w*dt;
+    double nx = x + v*cos(heading + w*dt/2.0)*dt;
+    double ny = y + v*sin(heading + w*dt/2.0)*dt;
+
+    if (!Allowed(nx, ny, nheading))
+    {
+        return false;
+    }
+    x = nx;
+    y = ny;
+    heading = nheading;
+
+    leftTravel += left*dt;
+    rightTravel += right*dt;
+    //Encoders only count edges, they do not know which way the wheel is turning
+    _leftEdges += fabs(left*dt)/(wheel*M_PI)*countsPerRev;
+    _rightEdges += fabs(right*dt)/(wheel*M_PI)*countsPerRev;
+    return true;
+}
+
+void DiffDrive::SetMotor(int port, float percent)
+{
+    if (port == _leftPort)
+    {
+        _leftCmd = percent;
+    } else if (port == _rightPort)
+    {
+        _rightCmd = percent;
+    }
+}
+
+int DiffDrive::EncoderCounts(int pin)
+{
+    if (pin == _leftPin)
+    {
+        return (int)_leftEdges;
+    } else if (pin == _rightPin)
+    {
+        return (int)_rightEdges;
+    }
+    return 0;
+}
+
+void DiffDrive::ResetEncoder(int pin)
+{
+    if (pin == _leftPin)
+    {
+        _leftEdges = 0;
+    } else if (pin == _rightPin)
+    {
+        _rightEdges = 0;
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef DIFFDRIVE_H
+#define DIFFDRIVE_H
+
+#include "FEHHost.h"
+
+//Plant model of a differential drive robot with IGWAN motors and shaft encoders
+class DiffDrive : public FEHHost::Plant
+{
+public:
+    //Wiring of the drive, defaults match Robot_Design_Code
+    DiffDrive(int leftPort = 3, int rightPort = 2, int leftPin = 0, int rightPin = 1);
+
+    void Step(double dt);
+    void SetMotor(int port, float percent);
+    int EncoderCounts(int pin);
+    void ResetEncoder(int pin);
+
+    //Physical parameters, public so benchmarks can perturb them
+    double wheel;        //wheel diameter in inches
+    double track;        //wheel to wheel distance in inches
+    double countsPerRev; //encoder edges per wheel revolution
+    double maxRevs;      //wheel revolutions per second at 100% of 12V
+    double tau;          //motor time constant in seconds
+    double deadband;     //percent of 12V below which the motor does not turn
+    double leftGain, rightGain;
+
+    //Pose in inches and radians, heading 0 is along +x and positive is counter-clockwise
+    double x, y, heading;
+    //Wheel surface speeds in inches per second
+    double leftSpeed, rightSpeed;
+    //Total distance each wheel has rolled, signed, in inches
+    double leftTravel, rightTravel;
+
+protected:
+    //Gives subclasses a chance to stop the robot (walls), returns false if the move is blocked
+    virtual bool Allowed(double nx, double ny, double nheading) { return true; }
+
+private:
+    int _leftPort, _rightPort, _leftPin, _rightPin;
+    float _leftCmd, _rightCmd;
+    double _leftEdges, _rightEdges;
+
+    double Target(float percent, double gain);
+    //Moves the robot with the given wheel speeds if Allowed() lets it, returns false if blocked
+    bool Move(double left, double right, double dt);
+};
+
+#endif
@@ -0,0 +1,28 @@
+#include "FEHAccel.h"
+#include "FEHHost.h"
+
+FEHAccel Accel;
+
+float FEHAccel::X()
+{
+    float x, y, z;
+    FEHHost::Advance(FEHHost::COST_ANALOG);
+    FEHHost::GetPlant()->Acceleration(&x, &y, &z);
+    return x;
+}
+
+float FEHAccel::Y()
+{
+    float x, y, z;
+    FEHHost::Advance(FEHHost::COST_ANALOG);
+    FEHHost::GetPlant()->Acceleration(&x, &y, &z);
+    return y;
+}
+
+float FEHAccel::Z()
+{
+    float x, y, z;
+    FEHHost::Advance(FEHHost::COST_ANALOG);
+    FEHHost::GetPlant()->Acceleration(&x, &y, &z);
+    return z;
+}
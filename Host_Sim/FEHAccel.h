@@ -0,0 +1,15 @@
+#ifndef FEHACCEL_H
+#define FEHACCEL_H
+
+//Host version of the accelerometer, readings in g come from the installed FEHHost::Plant
+class FEHAccel
+{
+public:
+    float X();
+    float Y();
+    float Z();
+};
+
+extern FEHAccel Accel;
+
+#endif
@@ -0,0 +1,10 @@
+#include "FEHBattery.h"
+#include "FEHHost.h"
+
+FEHBattery Battery;
+
+float FEHBattery::Voltage()
+{
+    FEHHost::Advance(FEHHost::COST_ANALOG);
+    return FEHHost::GetPlant()->BatteryVoltage();
+}
@@ -0,0 +1,13 @@
+#ifndef FEHBATTERY_H
+#define FEHBATTERY_H
+
+//Host version of the battery monitor
+class FEHBattery
+{
+public:
+    float Voltage();
+};
+
+extern FEHBattery Battery;
+
+#endif
@@ -0,0 +1,34 @@
+#include "FEHBuzzer.h"
+#include "FEHHost.h"
+
+FEHBuzzer Buzzer;
+
+void FEHBuzzer::Off()
+{
+    _on = false;
+}
+
+void FEHBuzzer::On()
+{
+    _on = true;
+}
+
+void FEHBuzzer::Beep()
+{
+    Buzz(500);
+}
+
+void FEHBuzzer::Buzz(int duration)
+{
+    FEHHost::Advance(duration/1000.0);
+}
+
+void FEHBuzzer::Buzz(float duration)
+{
+    FEHHost::Advance(duration);
+}
+
+void FEHBuzzer::Tone(int frequency, int duration)
+{
+    FEHHost::Advance(duration/1000.0);
+}
@@ -0,0 +1,23 @@
+#ifndef FEHBUZZER_H
+#define FEHBUZZER_H
+
+//Host version of the buzzer, silent but it takes as long as the real one
+class FEHBuzzer
+{
+public:
+    void Off();
+    void On();
+    void Beep();
+    //Buzzes for duration milliseconds
+    void Buzz(int duration);
+    //Buzzes for duration seconds
+    void Buzz(float duration);
+    void Tone(int frequency, int duration);
+
+private:
+    bool _on;
+};
+
+extern FEHBuzzer Buzzer;
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef FEHFILE_H
+#define FEHFILE_H
+
+#include <stdio.h>
+
+//Host version of the FEH SD file handle, wraps a file in the FEHHOST_SD folder
+struct FEHFile
+{
+    FILE *fil;
+    int fileIdNum;
+};
+
+#endif
@@ -0,0 +1,286 @@
+#include "FEHHost.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//Largest time step handed to the plant at once, keeps the integration stable during long Sleep() calls
+#define MAX_STEP 0.0005
+//Number of FEHIO pins that sensors can be attached to
+#define PIN_COUNT 33
+//Most touches that can be queued at once
+#define MAX_TOUCHES 32
+
+namespace FEHHost
+{
+    //Costs measured on the Proteus with a scope, rounded up
+    double COST_ENCODER = 2e-6;
+    double COST_MOTOR = 5e-6;
+    double COST_TIME = 1e-6;
+    double COST_ANALOG = 25e-6;
+    double COST_DIGITAL = 1e-6;
+    double COST_SERVO = 5e-6;
+    //A full screen fill is 76800 pixels over SPI
+    double COST_LCD_CLEAR = 0.045;
+    //Per character written
+    double COST_LCD_TEXT = 0.0004;
+    double COST_LCD_DRAW = 0.002;
+    double COST_TOUCH = 0.0002;
+    double COST_RPS = 1e-6;
+    double COST_SD_OPEN = 0.05;
+    double COST_SD_WRITE = 0.002;
+
+    static Plant idle;
+    static Plant *plant = &idle;
+    static Sensor *sensors[PIN_COUNT];
+    static double now = 0;
+    //Time up to which the plant has been stepped, lags now by less than MAX_STEP
+    static double plantTime = 0;
+
+    struct Touch
+    {
+        double start, end;
+        float x, y;
+    };
+    static Touch touches[MAX_TOUCHES];
+    static int touchCount = 0;
+
+    static bool configured = false;
+    static double timeLimit = 600;
+    static bool echo = false;
+    static const char *sdFolder = "sd";
+    static void (*limitHandler)() = 0;
+
+    //Reads the environment the first time the clock is used
+    static void Configure()
+    {
+        const char *value;
+        configured = true;
+        value = getenv("FEHHOST_TIME_LIMIT");
+        if (value)
+        {
+            timeLimit = atof(value);
+        }
+        value = getenv("FEHHOST_LCD");
+        echo = value && strcmp(value, "0") != 0;
+        value = getenv("FEHHOST_SD");
+        if (value)
+        {
+            sdFolder = value;
+        }
+    }
+
+    static void DefaultLimitHandler()
+    {
+        fprintf(stderr, "FEHHost: virtual time limit of %.1f s reached, stopping\n", timeLimit);
+        exit(0);
+    }
+
+    void SetPlant(Plant *p)
+    {
+        plant = p ? p : &idle;
+        plantTime = now;
+    }
+
+    Plant *GetPlant()
+    {
+        return plant;
+    }
+
+    void AttachSensor(int pin, Sensor *sensor)
+    {
+        if (pin >= 0 && pin < PIN_COUNT)
+        {
+            sensors[pin] = sensor;
+        }
+    }
+
+    Sensor *GetSensor(int pin)
+    {
+        if (pin >= 0 && pin < PIN_COUNT)
+        {
+            return sensors[pin];
+        }
+        return 0;
+    }
+
+    void QueueTouch(double start, double duration, float x, float y)
+    {
+        if (touchCount < MAX_TOUCHES)
+        {
+            touches[touchCount].start = start;
+            touches[touchCount].end = start + duration;
+            touches[touchCount].x = x;
+            touches[touchCount].y = y;
+            touchCount++;
+        }
+    }
+
+    bool QueuedTouch(float *x, float *y)
+    {
+        int i;
+        for (i = 0; i < touchCount; i++)
+        {
+            if (now >= touches[i].start && now < touches[i].end)
+            {
+                *x = touches[i].x;
+                *y = touches[i].y;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    double Now()
+    {
+        return now;
+    }
+
+    void Advance(double seconds)
+    {
+        if (!configured)
+        {
+            Configure();
+        }
+        double target = now;
+        if (seconds > 0)
+        {
+            target += seconds;
+        }
+        //Only step the plant in chunks so tight polling loops don't cost a physics update per call.
+        //The clock is moved along with each step so the plant sees the time of the step it is in
+        while (target - plantTime >= MAX_STEP)
+        {
+            double dt = target - plantTime;
+            if (dt > MAX_STEP)
+            {
+                dt = MAX_STEP;
+            }
+            now = plantTime + dt;
+            plant->Step(dt);
+            plantTime += dt;
+        }
+        now = target;
+        if (timeLimit > 0 && now > timeLimit)
+        {
+            if (limitHandler)
+            {
+                limitHandler();
+            } else
+            {
+                DefaultLimitHandler();
+            }
+        }
+    }
+
+    void Reset()
+    {
+        int i;
+        now = 0;
+        plantTime = 0;
+        touchCount = 0;
+        for (i = 0; i < PIN_COUNT; i++)
+        {
+            sensors[i] = 0;
+        }
+    }
+
+    void SetTimeLimit(double seconds)
+    {
+        if (!configured)
+        {
+            Configure();
+        }
+        timeLimit = seconds;
+    }
+
+    void SetTimeLimitHandler(void (*handler)())
+    {
+        limitHandler = handler;
+    }
+
+    bool EchoLCD()
+    {
+        if (!configured)
+        {
+            Configure();
+        }
+        return echo;
+    }
+
+    const char *SDFolder()
+    {
+        if (!configured)
+        {
+            Configure();
+        }
+        return sdFolder;
+    }
+
+    TraceSensor::TraceSensor(const double *times, const float *values, int count)
+    {
+        _times = times;
+        _values = values;
+        _count = count;
+        _last = 0;
+        _ownTimes = 0;
+        _ownValues = 0;
+    }
+
+    TraceSensor::~TraceSensor()
+    {
+        free(_ownTimes);
+        free(_ownValues);
+    }
+
+    bool TraceSensor::Load(const char *filename)
+    {
+        FILE *file = fopen(filename, "r");
+        double t;
+        float v;
+        int size = 256;
+        if (!file)
+        {
+            return false;
+        }
+        free(_ownTimes);
+        free(_ownValues);
+        _ownTimes = (double *)malloc(size*sizeof(double));
+        _ownValues = (float *)malloc(size*sizeof(float));
+        _count = 0;
+        while (fscanf(file, "%lf %f", &t, &v) == 2)
+        {
+            if (_count == size)
+            {
+                size *= 2;
+                _ownTimes = (double *)realloc(_ownTimes, size*sizeof(double));
+                _ownValues = (float *)realloc(_ownValues, size*sizeof(float));
+            }
+            _ownTimes[_count] = t;
+            _ownValues[_count] = v;
+            _count++;
+        }
+        fclose(file);
+        _times = _ownTimes;
+        _values = _ownValues;
+        _last = 0;
+        return _count > 0;
+    }
+
+    float TraceSensor::Value(double t)
+    {
+        if (_count == 0)
+        {
+            return 0;
+        }
+        //Readings mostly move forward in time, so search from the last sample used
+        if (t < _times[_last])
+        {
+            _last = 0;
+        }
+        while (_last + 1 < _count && _times[_last + 1] <= t)
+        {
+            _last++;
+        }
+        return _values[_last];
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef FEHHOST_H
+#define FEHHOST_H
+
+/*Host-side stand-in for the Proteus hardware so robot code can be built and timed on a laptop.
+ Time is virtual: it only moves forward when the robot code touches the "hardware" (each access is
+ charged a modeled cost) or sleeps, so a busy-wait loop runs exactly as many times as it would on the robot.
+
+ Inputs come from the installed Plant (the robot and course model) unless a Sensor has been attached to
+ that pin, which lets a benchmark replay a recorded trace on one pin while the plant handles the rest.
+ A few environment variables configure programs that are built unchanged against this library:
+   FEHHOST_TIME_LIMIT  virtual seconds before the program is stopped (default 600)
+   FEHHOST_LCD         set to 1 to echo everything written to the LCD on stdout
+   FEHHOST_SD          folder that stands in for the SD card (default ./sd)*/
+namespace FEHHost
+{
+    //Interface for whatever is pretending to be the robot and the course, the defaults are a robot sitting
+    //on a bench with nothing pressed, no light on the CdS cell and no RPS signal
+    class Plant
+    {
+    public:
+        virtual ~Plant() {}
+        //Advances the physical state by dt seconds
+        virtual void Step(double dt) {}
+        //Motor command from FEHMotor, port is 0-3 and percent is -100 to 100 of 12V
+        virtual void SetMotor(int port, float percent) {}
+        //Servo command from FEHServo in degrees, port is 0-7
+        virtual void SetServo(int port, float degree) {}
+        //Number of encoder edges seen on an FEHIO pin since its last reset
+        virtual int EncoderCounts(int pin) { return 0; }
+        virtual void ResetEncoder(int pin) {}
+        //Voltage on an analog pin, 0 to 3.3
+        virtual float AnalogValue(int pin) { return 3.3; }
+        //Level on a digital pin, inputs are pulled up so an open microswitch reads true
+        virtual bool DigitalValue(int pin) { return true; }
+        virtual void DigitalWrite(int pin, bool value) {}
+        //Touch screen, returns true and the position while it is being pressed
+        virtual bool Touch(float *x, float *y) { return false; }
+        //RPS fix in inches and degrees, returns false when there is no signal
+        virtual bool RPSPose(float *x, float *y, float *heading) { return false; }
+        //Which ice cream lever RPS reports, 0-2
+        virtual int IceCream() { return 0; }
+        //Acceleration in g
+        virtual void Acceleration(float *x, float *y, float *z) { *x = 0; *y = 0; *z = 1; }
+        virtual float BatteryVoltage() { return 11.7; }
+    };
+
+    //Source of readings for a single pin, overrides the plant for that pin
+    class Sensor
+    {
+    public:
+        virtual ~Sensor() {}
+        //Reading at virtual time t, digital pins read true above 0.5
+        virtual float Value(double t) = 0;
+    };
+
+    //Replays a recorded trace, holding each sample until the next one
+    class TraceSensor : public Sensor
+    {
+    public:
+        TraceSensor(const double *times = 0, const float *values = 0, int count = 0);
+        ~TraceSensor();
+        //Loads "time value" pairs, one per line, returns false if the file could not be read
+        bool Load(const char *filename);
+        float Value(double t);
+
+    private:
+        const double *_times;
+        const float *_values;
+        int _count;
+        int _last;
+        double *_ownTimes;
+        float *_ownValues;
+    };
+
+    //Installs the plant that the FEH classes talk to, passing 0 puts back the idle bench plant
+    void SetPlant(Plant *plant);
+    Plant *GetPlant();
+
+    //Attaches a sensor to an FEHIO pin, passing 0 gives the pin back to the plant
+    void AttachSensor(int pin, Sensor *sensor);
+    Sensor *GetSensor(int pin);
+
+    //Presses the touch screen at x, y from start for duration seconds, on top of whatever the plant reports
+    void QueueTouch(double start, double duration, float x, float y);
+    //Used by FEHLCD::Touch, returns true while a queued touch is active
+    bool QueuedTouch(float *x, float *y);
+
+    //Current virtual time in seconds since the last Reset()
+    double Now();
+    //Moves the virtual clock forward, stepping the plant along with it
+    void Advance(double seconds);
+    //Sets the clock back to zero and clears attached sensors and queued touches without touching the plant
+    void Reset();
+
+    //Virtual time at which the program is stopped, 0 for no limit
+    void SetTimeLimit(double seconds);
+    //Called when the time limit is reached, the default prints a note and exits. A handler may throw to unwind
+    //the robot code instead
+    void SetTimeLimitHandler(void (*handler)());
+
+    //True if LCD output should be echoed to stdout
+    bool EchoLCD();
+    //Folder that stands in for the SD card
+    const char *SDFolder();
+
+    //Modeled cost in seconds of each kind of hardware access
+    extern double COST_ENCODER;
+    extern double COST_MOTOR;
+    extern double COST_TIME;
+    extern double COST_ANALOG;
+    extern double COST_DIGITAL;
+    extern double COST_SERVO;
+    extern double COST_LCD_CLEAR;
+    extern double COST_LCD_TEXT;
+    extern double COST_LCD_DRAW;
+    extern double COST_TOUCH;
+    extern double COST_RPS;
+    extern double COST_SD_OPEN;
+    extern double COST_SD_WRITE;
+}
+
+#endif
@@ -0,0 +1,74 @@
+#include "FEHIO.h"
+#include "FEHHost.h"
+
+AnalogInputPin::AnalogInputPin(FEHIO::FEHIOPin pin)
+{
+    _pin = pin;
+}
+
+float AnalogInputPin::Value()
+{
+    FEHHost::Sensor *sensor = FEHHost::GetSensor(_pin);
+    FEHHost::Advance(FEHHost::COST_ANALOG);
+    if (sensor)
+    {
+        return sensor->Value(FEHHost::Now());
+    }
+    return FEHHost::GetPlant()->AnalogValue(_pin);
+}
+
+DigitalInputPin::DigitalInputPin(FEHIO::FEHIOPin pin)
+{
+    _pin = pin;
+}
+
+bool DigitalInputPin::Value()
+{
+    FEHHost::Sensor *sensor = FEHHost::GetSensor(_pin);
+    FEHHost::Advance(FEHHost::COST_DIGITAL);
+    if (sensor)
+    {
+        return sensor->Value(FEHHost::Now()) > 0.5;
+    }
+    return FEHHost::GetPlant()->DigitalValue(_pin);
+}
+
+DigitalOutputPin::DigitalOutputPin(FEHIO::FEHIOPin pin)
+{
+    _pin = pin;
+    _status = false;
+}
+
+void DigitalOutputPin::Write(bool value)
+{
+    FEHHost::Advance(FEHHost::COST_DIGITAL);
+    _status = value;
+    FEHHost::GetPlant()->DigitalWrite(_pin, value);
+}
+
+bool DigitalOutputPin::Status()
+{
+    return _status;
+}
+
+void DigitalOutputPin::Toggle()
+{
+    Write(!_status);
+}
+
+DigitalEncoder::DigitalEncoder(FEHIO::FEHIOPin pin, FEHIO::FEHIOInterruptTrigger trigger)
+{
+    _pin = pin;
+}
+
+int DigitalEncoder::Counts()
+{
+    FEHHost::Advance(FEHHost::COST_ENCODER);
+    return FEHHost::GetPlant()->EncoderCounts(_pin);
+}
+
+void DigitalEncoder::ResetCounts()
+{
+    FEHHost::Advance(FEHHost::COST_ENCODER);
+    FEHHost::GetPlant()->ResetEncoder(_pin);
+}
@@ -0,0 +1,74 @@
+#ifndef FEHIO_H
+#define FEHIO_H
+
+//Host version of the FEH IO pins, values come from an attached FEHHost::Sensor or the installed FEHHost::Plant
+class FEHIO
+{
+public:
+    typedef enum
+    {
+        P0_0 = 0, P0_1, P0_2, P0_3, P0_4, P0_5, P0_6, P0_7,
+        P1_0, P1_1, P1_2, P1_3, P1_4, P1_5, P1_6, P1_7,
+        P2_0, P2_1, P2_2, P2_3, P2_4, P2_5, P2_6, P2_7,
+        P3_0, P3_1, P3_2, P3_3, P3_4, P3_5, P3_6, P3_7,
+        BATTERY_VOLTAGE
+    } FEHIOPin;
+
+    typedef enum
+    {
+        RisingEdge = 0,
+        FallingEdge,
+        EitherEdge
+    } FEHIOInterruptTrigger;
+};
+
+class AnalogInputPin
+{
+public:
+    AnalogInputPin(FEHIO::FEHIOPin pin);
+
+    //Voltage from 0 to 3.3, every call is a separate ADC conversion
+    float Value();
+
+private:
+    FEHIO::FEHIOPin _pin;
+};
+
+class DigitalInputPin
+{
+public:
+    DigitalInputPin(FEHIO::FEHIOPin pin);
+
+    bool Value();
+
+private:
+    FEHIO::FEHIOPin _pin;
+};
+
+class DigitalOutputPin
+{
+public:
+    DigitalOutputPin(FEHIO::FEHIOPin pin);
+
+    void Write(bool value);
+    bool Status();
+    void Toggle();
+
+private:
+    FEHIO::FEHIOPin _pin;
+    bool _status;
+};
+
+class DigitalEncoder
+{
+public:
+    DigitalEncoder(FEHIO::FEHIOPin pin, FEHIO::FEHIOInterruptTrigger trigger = FEHIO::EitherEdge);
+
+    int Counts();
+    void ResetCounts();
+
+private:
+    FEHIO::FEHIOPin _pin;
+};
+
+#endif
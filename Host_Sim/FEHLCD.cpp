@@ -0,0 +1,367 @@
+#include "FEHLCD.h"
+#include "FEHHost.h"
+#include <stdio.h>
+#include <string.h>
+
+//Pixel size of a character in the firmware font
+#define CHAR_WIDTH 12
+#define CHAR_HEIGHT 17
+
+FEHLCD LCD;
+
+FEHLCD::FEHLCD()
+{
+    _clears = 0;
+    ClearBuffer();
+}
+
+void FEHLCD::Initialize()
+{
+}
+
+void FEHLCD::SetOrientation(FEHLCDOrientation orientation)
+{
+}
+
+bool FEHLCD::Touch(float *x, float *y)
+{
+    FEHHost::Advance(FEHHost::COST_TOUCH);
+    if (FEHHost::QueuedTouch(x, y))
+    {
+        return true;
+    }
+    return FEHHost::GetPlant()->Touch(x, y);
+}
+
+bool FEHLCD::Touch(int *x, int *y)
+{
+    float fx, fy;
+    bool pressed = Touch(&fx, &fy);
+    *x = (int)fx;
+    *y = (int)fy;
+    return pressed;
+}
+
+//Clears the host text buffer only, the screen itself is untouched
+void FEHLCD::ClearBuffer()
+{
+    int i;
+    for (i = 0; i < LCD_ROWS; i++)
+    {
+        _rows[i][0] = '\0';
+    }
+    _row = _col = 0;
+}
+
+void FEHLCD::Clear(FEHLCDColor color)
+{
+    Clear();
+}
+
+void FEHLCD::Clear(unsigned int color)
+{
+    Clear();
+}
+
+void FEHLCD::Clear()
+{
+    FEHHost::Advance(FEHHost::COST_LCD_CLEAR);
+    ClearBuffer();
+    _clears++;
+    if (FEHHost::EchoLCD())
+    {
+        printf("[%9.4f] LCD clear\n", FEHHost::Now());
+    }
+}
+
+void FEHLCD::SetFontColor(FEHLCDColor color)
+{
+}
+
+void FEHLCD::SetFontColor(unsigned int color)
+{
+}
+
+void FEHLCD::SetBackgroundColor(FEHLCDColor color)
+{
+}
+
+void FEHLCD::SetBackgroundColor(unsigned int color)
+{
+}
+
+void FEHLCD::DrawPixel(int x, int y)
+{
+    FEHHost::Advance(FEHHost::COST_DIGITAL);
+}
+
+void FEHLCD::DrawHorizontalLine(int y, int x1, int x2)
+{
+    FEHHost::Advance(FEHHost::COST_LCD_DRAW);
+}
+
+void FEHLCD::DrawVerticalLine(int x, int y1, int y2)
+{
+    FEHHost::Advance(FEHHost::COST_LCD_DRAW);
+}
+
+void FEHLCD::DrawLine(int x1, int y1, int x2, int y2)
+{
+    FEHHost::Advance(FEHHost::COST_LCD_DRAW);
+}
+
+void FEHLCD::DrawRectangle(int x, int y, int width, int height)
+{
+    FEHHost::Advance(4*FEHHost::COST_LCD_DRAW);
+}
+
+void FEHLCD::FillRectangle(int x, int y, int width, int height)
+{
+    //Filling costs in proportion to the area, relative to a full screen clear
+    FEHHost::Advance(FEHHost::COST_LCD_CLEAR*width*height/76800.0);
+}
+
+void FEHLCD::DrawCircle(int x0, int y0, int r)
+{
+    FEHHost::Advance(4*FEHHost::COST_LCD_DRAW);
+}
+
+void FEHLCD::FillCircle(int x0, int y0, int r)
+{
+    FEHHost::Advance(FEHHost::COST_LCD_CLEAR*3.14*r*r/76800.0);
+}
+
+void FEHLCD::Text(const char *str, bool newline)
+{
+    int n = strlen(str), i;
+    FEHHost::Advance(n*FEHHost::COST_LCD_TEXT);
+    if (FEHHost::EchoLCD())
+    {
+        printf("[%9.4f] LCD %s\n", FEHHost::Now(), str);
+    }
+    for (i = 0; i < n; i++)
+    {
+        if (_col == LCD_COLS)
+        {
+            _row++;
+            _col = 0;
+        }
+        //Text past the bottom of the screen scrolls back to the top like the firmware
+        if (_row == LCD_ROWS)
+        {
+            _row = 0;
+        }
+        if (_col == 0)
+        {
+            _rows[_row][0] = '\0';
+        }
+        _rows[_row][_col++] = str[i];
+        _rows[_row][_col] = '\0';
+    }
+    if (newline)
+    {
+        _row = (_row + 1) % LCD_ROWS;
+        _col = 0;
+        _rows[_row][0] = '\0';
+    }
+}
+
+void FEHLCD::TextAt(const char *str, int row, int col)
+{
+    int n = strlen(str), i, len;
+    FEHHost::Advance(n*FEHHost::COST_LCD_TEXT);
+    if (FEHHost::EchoLCD())
+    {
+        printf("[%9.4f] LCD (%d,%d) %s\n", FEHHost::Now(), row, col, str);
+    }
+    if (row < 0 || row >= LCD_ROWS || col < 0 || col >= LCD_COLS)
+    {
+        return;
+    }
+    len = strlen(_rows[row]);
+    while (len < col)
+    {
+        _rows[row][len++] = ' ';
+    }
+    for (i = 0; i < n && col + i < LCD_COLS; i++)
+    {
+        _rows[row][col + i] = str[i];
+    }
+    if (col + i > len)
+    {
+        _rows[row][col + i] = '\0';
+    } else
+    {
+        _rows[row][len] = '\0';
+    }
+}
+
+const char *FEHLCD::Row(int row)
+{
+    return (row >= 0 && row < LCD_ROWS) ? _rows[row] : "";
+}
+
+int FEHLCD::Clears()
+{
+    return _clears;
+}
+
+//Number formatting matches the firmware: floats with three decimals
+static void Format(char *buf, int size, int i)
+{
+    snprintf(buf, size, "%d", i);
+}
+
+static void Format(char *buf, int size, double d)
+{
+    snprintf(buf, size, "%.3f", d);
+}
+
+static void Format(char *buf, int size, bool b)
+{
+    snprintf(buf, size, "%s", b ? "true" : "false");
+}
+
+static void Format(char *buf, int size, char c)
+{
+    snprintf(buf, size, "%c", c);
+}
+
+void FEHLCD::Write(const char *str) { Text(str, false); }
+void FEHLCD::Write(int i) { char b[32]; Format(b, 32, i); Text(b, false); }
+void FEHLCD::Write(float f) { char b[32]; Format(b, 32, (double)f); Text(b, false); }
+void FEHLCD::Write(double d) { char b[32]; Format(b, 32, d); Text(b, false); }
+void FEHLCD::Write(bool v) { char b[32]; Format(b, 32, v); Text(b, false); }
+void FEHLCD::Write(char c) { char b[32]; Format(b, 32, c); Text(b, false); }
+
+void FEHLCD::WriteLine(const char *str) { Text(str, true); }
+void FEHLCD::WriteLine(int i) { char b[32]; Format(b, 32, i); Text(b, true); }
+void FEHLCD::WriteLine(float f) { char b[32]; Format(b, 32, (double)f); Text(b, true); }
+void FEHLCD::WriteLine(double d) { char b[32]; Format(b, 32, d); Text(b, true); }
+void FEHLCD::WriteLine(bool v) { char b[32]; Format(b, 32, v); Text(b, true); }
+void FEHLCD::WriteLine(char c) { char b[32]; Format(b, 32, c); Text(b, true); }
+
+void FEHLCD::WriteAt(const char *str, int x, int y) { TextAt(str, y/CHAR_HEIGHT, x/CHAR_WIDTH); }
+void FEHLCD::WriteAt(int i, int x, int y) { char b[32]; Format(b, 32, i); WriteAt(b, x, y); }
+void FEHLCD::WriteAt(float f, int x, int y) { char b[32]; Format(b, 32, (double)f); WriteAt(b, x, y); }
+void FEHLCD::WriteAt(double d, int x, int y) { char b[32]; Format(b, 32, d); WriteAt(b, x, y); }
+void FEHLCD::WriteAt(bool v, int x, int y) { char b[32]; Format(b, 32, v); WriteAt(b, x, y); }
+void FEHLCD::WriteAt(char c, int x, int y) { char b[32]; Format(b, 32, c); WriteAt(b, x, y); }
+
+void FEHLCD::WriteRC(const char *str, int row, int col) { TextAt(str, row, col); }
+void FEHLCD::WriteRC(int i, int row, int col) { char b[32]; Format(b, 32, i); TextAt(b, row, col); }
+void FEHLCD::WriteRC(float f, int row, int col) { char b[32]; Format(b, 32, (double)f); TextAt(b, row, col); }
+void FEHLCD::WriteRC(double d, int row, int col) { char b[32]; Format(b, 32, d); TextAt(b, row, col); }
+void FEHLCD::WriteRC(bool v, int row, int col) { char b[32]; Format(b, 32, v); TextAt(b, row, col); }
+void FEHLCD::WriteRC(char c, int row, int col) { char b[32]; Format(b, 32, c); TextAt(b, row, col); }
+
+namespace FEHIcon
+{
+    Icon::Icon()
+    {
+        _label[0] = '\0';
+        _x = _y = _width = _height = 0;
+        _color = _textColor = 0;
+        _set = 0;
+    }
+
+    void Icon::SetProperties(char name[20], int start_x, int start_y, int width, int height, unsigned int color, unsigned int text_color)
+    {
+        strncpy(_label, name, 19);
+        _label[19] = '\0';
+        _x = start_x;
+        _y = start_y;
+        _width = width;
+        _height = height;
+        _color = color;
+        _textColor = text_color;
+    }
+
+    void Icon::Draw()
+    {
+        LCD.DrawRectangle(_x, _y, _width, _height);
+        LCD.WriteAt(_label, _x + 2, _y + _height/2);
+    }
+
+    void Icon::Select()
+    {
+        LCD.DrawRectangle(_x + 1, _y + 1, _width - 2, _height - 2);
+        _set = 1;
+    }
+
+    void Icon::Deselect()
+    {
+        LCD.DrawRectangle(_x + 1, _y + 1, _width - 2, _height - 2);
+        _set = 0;
+    }
+
+    //Mode 0 toggles the selection on a press, mode 1 only reports it
+    int Icon::Pressed(float x, float y, int mode)
+    {
+        if (x >= _x && x <= _x + _width && y >= _y && y <= _y + _height)
+        {
+            if (mode == 0)
+            {
+                if (_set)
+                {
+                    Deselect();
+                } else
+                {
+                    Select();
+                }
+            }
+            return 1;
+        }
+        return 0;
+    }
+
+    int Icon::WhilePressed(float xi, float yi)
+    {
+        float x = xi, y = yi;
+        while (LCD.Touch(&x, &y))
+        {
+            if (!Pressed(x, y, 1))
+            {
+                break;
+            }
+        }
+        return 1;
+    }
+
+    void Icon::ChangeLabelString(const char new_label[20])
+    {
+        strncpy(_label, new_label, 19);
+        _label[19] = '\0';
+        LCD.FillRectangle(_x + 2, _y + 2, _width - 4, _height - 4);
+        LCD.WriteAt(_label, _x + 2, _y + _height/2);
+    }
+
+    void Icon::ChangeLabelFloat(float val)
+    {
+        char b[20];
+        snprintf(b, 20, "%.3f", val);
+        ChangeLabelString(b);
+    }
+
+    void Icon::ChangeLabelInt(int val)
+    {
+        char b[20];
+        snprintf(b, 20, "%d", val);
+        ChangeLabelString(b);
+    }
+
+    void DrawIconArray(Icon icon[], int rows, int cols, int top, int bot, int left, int right, char labels[][20], unsigned int col, unsigned int txtcol)
+    {
+        int width = (320 - left - right)/cols;
+        int height = (240 - top - bot)/rows;
+        int r, c;
+        for (r = 0; r < rows; r++)
+        {
+            for (c = 0; c < cols; c++)
+            {
+                icon[r*cols + c].SetProperties(labels[r*cols + c], left + c*width, top + r*height, width, height, col, txtcol);
+                icon[r*cols + c].Draw();
+            }
+        }
+    }
+}
@@ -0,0 +1,133 @@
+#ifndef FEHLCD_H
+#define FEHLCD_H
+
+#include "LCDColors.h"
+
+//Number of text rows and columns on the 320x240 screen with the 12x17 font
+#define LCD_ROWS 14
+#define LCD_COLS 26
+
+/*Host version of the FEH LCD. Nothing is drawn, but text is kept in a row buffer (and echoed to stdout
+ when FEHHOST_LCD is set) and every call charges the virtual clock what the SPI transfer would cost*/
+class FEHLCD
+{
+public:
+    typedef enum
+    {
+        Black = 0,
+        White,
+        Red,
+        Green,
+        Blue,
+        Scarlet,
+        Gray
+    } FEHLCDColor;
+
+    typedef enum
+    {
+        North = 0,
+        South,
+        East,
+        West
+    } FEHLCDOrientation;
+
+    FEHLCD();
+
+    void Initialize();
+    void SetOrientation(FEHLCDOrientation orientation);
+
+    bool Touch(float *x, float *y);
+    bool Touch(int *x, int *y);
+    void ClearBuffer();
+
+    void Clear(FEHLCDColor color);
+    void Clear(unsigned int color);
+    void Clear();
+
+    void SetFontColor(FEHLCDColor color);
+    void SetFontColor(unsigned int color);
+    void SetBackgroundColor(FEHLCDColor color);
+    void SetBackgroundColor(unsigned int color);
+
+    void DrawPixel(int x, int y);
+    void DrawHorizontalLine(int y, int x1, int x2);
+    void DrawVerticalLine(int x, int y1, int y2);
+    void DrawLine(int x1, int y1, int x2, int y2);
+    void DrawRectangle(int x, int y, int width, int height);
+    void FillRectangle(int x, int y, int width, int height);
+    void DrawCircle(int x0, int y0, int r);
+    void FillCircle(int x0, int y0, int r);
+
+    void Write(const char *str);
+    void Write(int i);
+    void Write(float f);
+    void Write(double d);
+    void Write(bool b);
+    void Write(char c);
+
+    void WriteLine(const char *str);
+    void WriteLine(int i);
+    void WriteLine(float f);
+    void WriteLine(double d);
+    void WriteLine(bool b);
+    void WriteLine(char c);
+
+    void WriteAt(const char *str, int x, int y);
+    void WriteAt(int i, int x, int y);
+    void WriteAt(float f, int x, int y);
+    void WriteAt(double d, int x, int y);
+    void WriteAt(bool b, int x, int y);
+    void WriteAt(char c, int x, int y);
+
+    void WriteRC(const char *str, int row, int col);
+    void WriteRC(int i, int row, int col);
+    void WriteRC(float f, int row, int col);
+    void WriteRC(double d, int row, int col);
+    void WriteRC(bool b, int row, int col);
+    void WriteRC(char c, int row, int col);
+
+    //Host only: text currently on a row, for benchmarks that check what the robot showed
+    const char *Row(int row);
+    //Host only: number of full screen clears so far
+    int Clears();
+
+private:
+    void Text(const char *str, bool newline);
+    void TextAt(const char *str, int row, int col);
+
+    char _rows[LCD_ROWS][LCD_COLS + 1];
+    int _row, _col;
+    int _clears;
+};
+
+extern FEHLCD LCD;
+
+namespace FEHIcon
+{
+    //Touch screen button drawn as a labeled rectangle
+    class Icon
+    {
+    public:
+        Icon();
+        void SetProperties(char name[20], int start_x, int start_y, int width, int height, unsigned int color, unsigned int text_color);
+        void Draw();
+        void Select();
+        void Deselect();
+        int Pressed(float x, float y, int mode);
+        int WhilePressed(float xi, float yi);
+        void ChangeLabelString(const char new_label[20]);
+        void ChangeLabelFloat(float val);
+        void ChangeLabelInt(int val);
+
+    private:
+        char _label[20];
+        int _x, _y, _width, _height;
+        unsigned int _color, _textColor;
+        int _set;
+    };
+
+    //Lays out a rows by cols grid of icons inside the screen minus the given margins
+    void DrawIconArray(Icon icon[], int rows, int cols, int top, int bot, int left, int right, char labels[][20], unsigned int col, unsigned int txtcol);
+}
+
+#endif
@@ -0,0 +1,31 @@
+#include "FEHMotor.h"
+#include "FEHHost.h"
+
+FEHMotor::FEHMotor(FEHMotorPort motorport, float max_voltage)
+{
+    _motorport = motorport;
+    //Same scaling as the firmware, percent is limited so the motor never sees more than max_voltage from the 12V rail
+    _max_percent = max_voltage/12.0*100.0;
+    if (_max_percent > 100)
+    {
+        _max_percent = 100;
+    }
+}
+
+void FEHMotor::Stop()
+{
+    SetPercent(0);
+}
+
+void FEHMotor::SetPercent(float percent)
+{
+    if (percent > 100)
+    {
+        percent = 100;
+    } else if (percent < -100)
+    {
+        percent = -100;
+    }
+    FEHHost::Advance(FEHHost::COST_MOTOR);
+    FEHHost::GetPlant()->SetMotor(_motorport, percent*_max_percent/100.0);
+}
@@ -0,0 +1,26 @@
+#ifndef FEHMOTOR_H
+#define FEHMOTOR_H
+
+//Host version of the FEH motor driver, commands are forwarded to the installed FEHHost::Plant
+class FEHMotor
+{
+public:
+    typedef enum
+    {
+        Motor0 = 0,
+        Motor1,
+        Motor2,
+        Motor3
+    } FEHMotorPort;
+
+    FEHMotor(FEHMotorPort motorport, float max_voltage);
+
+    void Stop();
+    void SetPercent(float percent);
+
+private:
+    FEHMotorPort _motorport;
+    float _max_percent;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#include "FEHRPS.h"
+#include "FEHHost.h"
+
+FEHRPS RPS;
+
+FEHRPS::FEHRPS()
+{
+    _region = -1;
+}
+
+void FEHRPS::InitializeTouchMenu()
+{
+    _region = 0;
+}
+
+int FEHRPS::CurrentRegion()
+{
+    return _region;
+}
+
+char FEHRPS::CurrentRegionLetter()
+{
+    return _region < 0 ? '?' : 'A' + _region;
+}
+
+float FEHRPS::X()
+{
+    float x, y, h;
+    FEHHost::Advance(FEHHost::COST_RPS);
+    return FEHHost::GetPlant()->RPSPose(&x, &y, &h) ? x : -1;
+}
+
+float FEHRPS::Y()
+{
+    float x, y, h;
+    FEHHost::Advance(FEHHost::COST_RPS);
+    return FEHHost::GetPlant()->RPSPose(&x, &y, &h) ? y : -1;
+}
+
+float FEHRPS::Heading()
+{
+    float x, y, h;
+    FEHHost::Advance(FEHHost::COST_RPS);
+    return FEHHost::GetPlant()->RPSPose(&x, &y, &h) ? h : -1;
+}
+
+int FEHRPS::GetIceCream()
+{
+    FEHHost::Advance(FEHHost::COST_RPS);
+    return FEHHost::GetPlant()->IceCream();
+}
+
+int FEHRPS::Time()
+{
+    return (int)FEHHost::Now();
+}
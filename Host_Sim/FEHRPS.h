@@ -0,0 +1,30 @@
+#ifndef FEHRPS_H
+#define FEHRPS_H
+
+//Host version of the Robot Positioning System, the pose comes from the installed FEHHost::Plant
+class FEHRPS
+{
+public:
+    FEHRPS();
+
+    //Picks the course region on the firmware, on the host it just marks RPS as ready
+    void InitializeTouchMenu();
+    int CurrentRegion();
+    char CurrentRegionLetter();
+
+    //Position in inches and heading in degrees, -1 when the robot is not seen
+    float X();
+    float Y();
+    float Heading();
+    //Which ice cream lever to flip, 0-2
+    int GetIceCream();
+    //Seconds since the match started
+    int Time();
+
+private:
+    int _region;
+};
+
+extern FEHRPS RPS;
+
+#endif
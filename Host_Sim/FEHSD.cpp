@@ -0,0 +1,128 @@
+#include "FEHSD.h"
+#include "FEHHost.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+FEHSD SD;
+
+FEHSD::FEHSD()
+{
+    int i;
+    for (i = 0; i < 25; i++)
+    {
+        _files[i] = 0;
+    }
+    _next = 0;
+}
+
+FEHFile *FEHSD::FOpen(const char *str, const char *mode)
+{
+    char path[512];
+    FEHFile *file;
+    FILE *f;
+    int i;
+
+    FEHHost::Advance(FEHHost::COST_SD_OPEN);
+    mkdir(FEHHost::SDFolder(), 0755);
+    snprintf(path, sizeof(path), "%s/%s", FEHHost::SDFolder(), str);
+    f = fopen(path, mode);
+    if (!f)
+    {
+        return 0;
+    }
+    for (i = 0; i < 25 && _files[i]; i++)
+    {
+    }
+    if (i == 25)
+    {
+        fclose(f);
+        return 0;
+    }
+    file = (FEHFile *)malloc(sizeof(FEHFile));
+    file->fil = f;
+    file->fileIdNum = _next++;
+    _files[i] = file;
+    return file;
+}
+
+int FEHSD::FClose(FEHFile *fptr)
+{
+    int i;
+    if (!fptr)
+    {
+        return -1;
+    }
+    FEHHost::Advance(FEHHost::COST_SD_WRITE);
+    for (i = 0; i < 25; i++)
+    {
+        if (_files[i] == fptr)
+        {
+            _files[i] = 0;
+        }
+    }
+    fclose(fptr->fil);
+    free(fptr);
+    return 0;
+}
+
+int FEHSD::FCloseAll()
+{
+    int i;
+    for (i = 0; i < 25; i++)
+    {
+        if (_files[i])
+        {
+            FClose(_files[i]);
+        }
+    }
+    return 0;
+}
+
+int FEHSD::FPrintf(FEHFile *fptr, const char *str, ...)
+{
+    va_list args;
+    int n;
+    if (!fptr)
+    {
+        return -1;
+    }
+    va_start(args, str);
+    n = vfprintf(fptr->fil, str, args);
+    va_end(args);
+    //Each call formats and writes a sector on the robot, so charge per call plus a little per byte
+    FEHHost::Advance(FEHHost::COST_SD_WRITE + n*1e-6);
+    return n;
+}
+
+int FEHSD::FScanf(FEHFile *fptr, const char *str, ...)
+{
+    va_list args;
+    int n;
+    if (!fptr)
+    {
+        return -1;
+    }
+    va_start(args, str);
+    n = vfscanf(fptr->fil, str, args);
+    va_end(args);
+    FEHHost::Advance(FEHHost::COST_SD_WRITE);
+    return n;
+}
+
+int FEHSD::FEof(FEHFile *fptr)
+{
+    int c;
+    if (!fptr)
+    {
+        return 1;
+    }
+    c = fgetc(fptr->fil);
+    if (c == EOF)
+    {
+        return 1;
+    }
+    ungetc(c, fptr->fil);
+    return 0;
+}
@@ -0,0 +1,27 @@
+#ifndef FEHSD_H
+#define FEHSD_H
+
+#include "FEHFile.h"
+
+//Host version of the FEH SD card, files live in the folder named by FEHHOST_SD
+class FEHSD
+{
+public:
+    FEHSD();
+
+    FEHFile *FOpen(const char *str, const char *mode);
+    int FClose(FEHFile *fptr);
+    int FCloseAll();
+    int FPrintf(FEHFile *fptr, const char *str, ...);
+    int FScanf(FEHFile *fptr, const char *str, ...);
+    int FEof(FEHFile *fptr);
+
+private:
+    //Most files open at once, same as the firmware
+    FEHFile *_files[25];
+    int _next;
+};
+
+extern FEHSD SD;
+
+#endif
@@ -0,0 +1,44 @@
+#include "FEHServo.h"
+#include "FEHHost.h"
+#include <stdio.h>
+
+FEHServo::FEHServo(FEHServoPort servo)
+{
+    _servo = servo;
+    //Firmware defaults in microseconds of pulse width
+    _min = 500;
+    _max = 2500;
+}
+
+void FEHServo::Calibrate()
+{
+    printf("FEHServo %d: calibration is only available on the robot\n", (int)_servo);
+}
+
+void FEHServo::SetDegree(float degree)
+{
+    if (degree < 0)
+    {
+        degree = 0;
+    } else if (degree > 180)
+    {
+        degree = 180;
+    }
+    FEHHost::Advance(FEHHost::COST_SERVO);
+    FEHHost::GetPlant()->SetServo(_servo, degree);
+}
+
+void FEHServo::SetMin(int min)
+{
+    _min = min;
+}
+
+void FEHServo::SetMax(int max)
+{
+    _max = max;
+}
+
+void FEHServo::Off()
+{
+    FEHHost::Advance(FEHHost::COST_SERVO);
+}
@@ -0,0 +1,34 @@
+#ifndef FEHSERVO_H
+#define FEHSERVO_H
+
+//Host version of the FEH servo driver, angles are forwarded to the installed FEHHost::Plant
+class FEHServo
+{
+public:
+    typedef enum
+    {
+        Servo0 = 0,
+        Servo1,
+        Servo2,
+        Servo3,
+        Servo4,
+        Servo5,
+        Servo6,
+        Servo7
+    } FEHServoPort;
+
+    FEHServo(FEHServoPort servo);
+
+    //Steps through the servo's range on the firmware, only prints here
+    void Calibrate();
+    void SetDegree(float degree);
+    void SetMin(int min);
+    void SetMax(int max);
+    void Off();
+
+private:
+    FEHServoPort _servo;
+    int _min, _max;
+};
+
+#endif
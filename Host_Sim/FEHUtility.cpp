@@ -0,0 +1,33 @@
+#include "FEHUtility.h"
+#include "FEHHost.h"
+
+void Sleep(int msec)
+{
+    FEHHost::Advance(msec/1000.0);
+}
+
+void Sleep(float seconds)
+{
+    FEHHost::Advance(seconds);
+}
+
+void Sleep(double seconds)
+{
+    FEHHost::Advance(seconds);
+}
+
+double TimeNow()
+{
+    FEHHost::Advance(FEHHost::COST_TIME);
+    return FEHHost::Now();
+}
+
+unsigned int TimeNowSec()
+{
+    return (unsigned int)TimeNow();
+}
+
+unsigned int TimeNowMSec()
+{
+    return (unsigned int)(TimeNow()*1000.0);
+}
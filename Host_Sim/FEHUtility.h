@@ -0,0 +1,13 @@
+#ifndef FEHUTILITY_H
+#define FEHUTILITY_H
+
+//Host versions of the FEH timing helpers, all of them run on FEHHost's virtual clock
+void Sleep(int msec);
+void Sleep(float seconds);
+void Sleep(double seconds);
+
+double TimeNow();
+unsigned int TimeNowSec();
+unsigned int TimeNowMSec();
+
+#endif
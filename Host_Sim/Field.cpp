@@ -0,0 +1,76 @@
+#include "Field.h"
+#include "FEHHost.h"
+#include <math.h>
+#include <stdlib.h>
+
+Field::Field()
+{
+    int i;
+    wheel = 2.45;
+    track = 7.9;
+    latency = 0.15;
+    period = 0.1;
+    noise = 0.25;
+    headingNoise = 1.5;
+    dropMin = 35;
+    dropMax = 45;
+    dropEvery = 10;
+    for (i = 0; i < FIELD_HISTORY; i++)
+    {
+        _x[i] = _y[i] = _h[i] = 0;
+    }
+    _newest = 0;
+    _packet = -1;
+    _sent = false;
+    _acc = 0;
+    _rx = _ry = _rh = 0;
+}
+
+float Field::Gauss()
+{
+    float sum = 0;
+    int i;
+    for (i = 0; i < 12; i++)
+    {
+        sum += rand()/(float)RAND_MAX;
+    }
+    return sum - 6;
+}
+
+void Field::Step(double dt)
+{
+    DiffDrive::Step(dt);
+    //Keeps the pose every FIELD_STEP for the delayed RPS reports
+    _acc += dt;
+    while (_acc >= FIELD_STEP)
+    {
+        _acc -= FIELD_STEP;
+        _newest = (_newest + 1) % FIELD_HISTORY;
+        _x[_newest] = x;
+        _y[_newest] = y;
+        _h[_newest] = heading;
+    }
+}
+
+bool Field::RPSPose(float *rx, float *ry, float *rheading)
+{
+    double now = FEHHost::Now(), degrees;
+    int back;
+    //A new packet every period, describing the robot latency before
+    if (_packet < 0 || now - _packet >= period)
+    {
+        _packet = now - fmod(now, period);
+        back = (int)(latency/FIELD_STEP);
+        back = (back >= FIELD_HISTORY) ? FIELD_HISTORY - 1 : back;
+        back = (_newest - back + FIELD_HISTORY) % FIELD_HISTORY;
+        _sent = !(_x[back] > dropMin && _x[back] < dropMax) && (dropEvery <= 0 || rand() % dropEvery != 0);
+        degrees = fmod(_h[back]*180.0/M_PI + headingNoise*Gauss(), 360.0);
+        _rx = _x[back] + noise*Gauss();
+        _ry = _y[back] + noise*Gauss();
+        _rh = (degrees < 0) ? degrees + 360 : degrees;
+    }
+    *rx = _rx;
+    *ry = _ry;
+    *rheading = _rh;
+    return _sent;
+}
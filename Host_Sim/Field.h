@@ -0,0 +1,40 @@
+#ifndef FIELD_H
+#define FIELD_H
+
+#include "DiffDrive.h"
+
+//Pose samples kept for RPS's latency, one every FIELD_STEP seconds
+#define FIELD_HISTORY 256
+#define FIELD_STEP 0.001
+
+/*The robot on an open field under an RPS with latency, noise and dropouts. The drive is deliberately off
+ from the numbers the robot code uses (wheels 2% smaller, effective track 5% wider) so odometry drifts.
+ RPS reports where the robot was latency seconds before, a new packet every period seconds, and sends
+ nothing while the robot is between dropMin and dropMax in x or for one packet in dropEvery (0 for none).
+ The noise is seeded, so the same settings always give the same run*/
+class Field : public DiffDrive
+{
+public:
+    Field();
+
+    void Step(double dt);
+    bool RPSPose(float *x, float *y, float *heading);
+
+    //RPS model: seconds of latency, seconds between packets, standard deviations of inches and degrees
+    double latency, period, noise, headingNoise;
+    //Dropout band in x, and one packet in dropEvery lost at random
+    double dropMin, dropMax;
+    int dropEvery;
+
+    //Random number with a roughly normal distribution
+    static float Gauss();
+
+private:
+    double _x[FIELD_HISTORY], _y[FIELD_HISTORY], _h[FIELD_HISTORY];
+    int _newest;
+    double _packet, _acc;
+    float _rx, _ry, _rh;
+    bool _sent;
+};
+
+#endif
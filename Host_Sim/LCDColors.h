@@ -0,0 +1,22 @@
+#ifndef LCDCOLORS_H
+#define LCDCOLORS_H
+
+//24-bit colors used with FEHLCD, same names and values as the firmware
+#define BLACK 0x000000u
+#define WHITE 0xFFFFFFu
+#define RED 0xFF0000u
+#define GREEN 0x008000u
+#define BLUE 0x0000FFu
+#define SCARLET 0xBB0000u
+#define GRAY 0x808080u
+#define GOLD 0xFFD700u
+#define ORANGE 0xFFA500u
+#define YELLOW 0xFFFF00u
+#define LIME 0x00FF00u
+#define CYAN 0x00FFFFu
+#define NAVY 0x000080u
+#define PURPLE 0x800080u
+#define DARKGRAY 0xA9A9A9u
+#define LIGHTGRAY 0xD3D3D3u
+
+#endif
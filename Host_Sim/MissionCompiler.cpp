@@ -0,0 +1,441 @@
+#include "MissionCompiler.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+//Longest source line
+#define MISSION_LINE 256
+//Most words on one source line, labels included
+#define MISSION_WORDS 8
+
+/*What each op takes, one letter per word after its name, numbers fill a, b and c in order:
+ d inches, r radius, g degrees, s speed, t seconds, k the word stop (arg 1), c the word contact (arg 1),
+ n a count (arg, negative for the other way), S servo, W wall side, E event, F follow condition, T task, V value to compare (arg), L label (target).
+ Words after [ can be left off*/
+struct OpSpec
+{
+    const char *name;
+    int op;
+    const char *args;
+    //What Robot_Design_Code calls it, for WriteTable()
+    const char *define;
+};
+
+//Each op with its define's name
+#define SPEC(name, op, args) {name, op, args, #op}
+
+static const OpSpec specs[] =
+{
+    SPEC("end", OP_END, ""),
+    SPEC("move", OP_MOVE, "ds[c"),
+    SPEC("pivot", OP_PIVOT, "gs"),
+    SPEC("arc", OP_ARC, "rgs"),
+    SPEC("sidestep", OP_SIDESTEP, "dds[c"),
+    SPEC("qline", OP_QLINE, "ds[k"),
+    SPEC("qpivot", OP_QPIVOT, "gs[k"),
+    SPEC("qrun", OP_QRUN, ""),
+    SPEC("drive_to", OP_GOTO, "ddg"),
+    SPEC("servo", OP_SERVO, "Sg[t"),
+    SPEC("servo_start", OP_SERVO_START, "Sg[t"),
+    SPEC("sync", OP_SYNC, ""),
+    SPEC("wall", OP_WALL, "Wsd"),
+    SPEC("until", OP_UNTIL, "Eds[t"),
+    SPEC("push", OP_PUSH, "Est"),
+    SPEC("follow", OP_FOLLOW, "F[dt"),
+    SPEC("sleep", OP_SLEEP, "t"),
+    SPEC("color", OP_COLOR, ""),
+    SPEC("lever", OP_LEVER, ""),
+    SPEC("jump", OP_JUMP, "L"),
+    SPEC("if", OP_IF, "VL"),
+    SPEC("task", OP_TASK, "T"),
+    SPEC("lanes", OP_LANES, "n"),
+};
+
+//Keywords, numbered the way Robot_Design_Code's main.cpp numbers them (servos, hitWall() sides, EVENT_ defines, lineFollow() conditions)
+static const char *const servoNames[] = {"arm", "fork"};
+static const char *const sideNames[] = {"front", "back"};
+static const char *const eventNames[] = {"front_any", "front_both", "back_any", "back_both", "fork", "line", "color"};
+static const char *const followNames[] = {"forever", "switches", "off_line"};
+static const char *const taskNames[] = MISSION_TASK_NAMES;
+//Colors in ColorSensor's order, for if after color
+static const char *const colorNames[] = {"red", "blue", "none", "no_reading"};
+
+//Largest distance and radius worth asking for, the course is 12 by 6 feet
+#define MISSION_REACH 144
+
+MissionCompiler::MissionCompiler()
+{
+    count = 0;
+    _defineCount = _labelCount = 0;
+}
+
+bool MissionCompiler::Compile(const char *filename, FILE *errors)
+{
+    char text[MISSION_LINE];
+    FILE *file = fopen(filename, "r");
+    bool ok = true;
+    int line = 0, i, j;
+    count = 0;
+    _defineCount = _labelCount = 0;
+    if (!file)
+    {
+        fprintf(errors, "%s: can't open\n", filename);
+        return false;
+    }
+    while (fgets(text, sizeof(text), file))
+    {
+        line++;
+        //A line that didn't fit is an error, the rest of it is skipped rather than read as the next line
+        if (!strchr(text, '\n') && !feof(file))
+        {
+            fprintf(errors, "%s:%d: longer than %d characters\n", filename, line, MISSION_LINE - 2);
+            while (fgets(text, sizeof(text), file) && !strchr(text, '\n'))
+            {
+            }
+            ok = false;
+            continue;
+        }
+        if (!Line(text, line, errors))
+        {
+            fprintf(errors, "%s:%d: %s", filename, line, text);
+            ok = false;
+        }
+    }
+    fclose(file);
+
+    //Jumps can go forward, so labels are only known once everything is read
+    for (i = 0; i < count; i++)
+    {
+        if (steps[i].op != OP_JUMP && steps[i].op != OP_IF)
+        {
+            continue;
+        }
+        for (j = 0; j < _labelCount && strcmp(_labels[j].name, _jumps[i]) != 0; j++)
+        {
+        }
+        if (j == _labelCount)
+        {
+            fprintf(errors, "%s:%d: no label %s\n", filename, lines[i], _jumps[i]);
+            ok = false;
+        } else if ((int)_labels[j].value >= count)
+        {
+            fprintf(errors, "%s:%d: label %s has no step after it\n", filename, lines[i], _jumps[i]);
+            ok = false;
+        } else
+        {
+            steps[i].target = (int)_labels[j].value;
+        }
+    }
+    if (count == 0 || steps[count - 1].op != OP_END)
+    {
+        fprintf(errors, "%s: the last step has to be end, the robot would run off the end of the mission\n", filename);
+        ok = false;
+    }
+    return ok;
+}
+
+bool MissionCompiler::Write(const char *filename)
+{
+    FILE *file = fopen(filename, "w");
+    int i;
+    if (!file)
+    {
+        return false;
+    }
+    fprintf(file, "mission %d %d\n", MISSION_VERSION, count);
+    for (i = 0; i < count; i++)
+    {
+        fprintf(file, "%d %d %d %g %g %g\n", steps[i].op, steps[i].arg, steps[i].target, steps[i].a, steps[i].b, steps[i].c);
+    }
+    fclose(file);
+    return true;
+}
+
+bool MissionCompiler::WriteTable(const char *filename, const char *name, const char *source)
+{
+    FILE *file = fopen(filename, "w");
+    char upper[MISSION_NAME];
+    const char *op;
+    int i, j;
+    if (!file)
+    {
+        return false;
+    }
+    for (i = 0; name[i] && i < MISSION_NAME - 1; i++)
+    {
+        upper[i] = toupper(name[i]);
+    }
+    upper[i] = 0;
+    fprintf(file, "//Generated by Host_Sim's mission_compile from %s, change that and run mission_compile -c %s again\n", source, name);
+    fprintf(file, "#ifndef %s_MISSION_H\n#define %s_MISSION_H\n\n#include \"Mission.h\"\n\n", upper, upper);
+    fprintf(file, "#define %s_MISSION_STEPS %d\n\n", upper, count);
+    fprintf(file, "//Each step with the line of %s it came from\n", source);
+    fprintf(file, "constexpr MissionStep %sMission[%s_MISSION_STEPS] =\n{\n", name, upper);
+    for (i = 0; i < count; i++)
+    {
+        for (j = 0, op = "?"; j < (int)(sizeof(specs)/sizeof(specs[0])); j++)
+        {
+            op = (specs[j].op == steps[i].op) ? specs[j].define : op;
+        }
+        fprintf(file, "    {%s, %d, %d, %g, %g, %g}, //%d\n", op, steps[i].arg, steps[i].target, steps[i].a, steps[i].b, steps[i].c, lines[i]);
+    }
+    fprintf(file, "};\n\nstatic_assert(MissionValid(%sMission, %s_MISSION_STEPS), \"%s compiled into a mission that can't run\");\n\n#endif\n",
+            name, upper, source);
+    fclose(file);
+    return true;
+}
+
+bool MissionCompiler::Line(char *text, int line, FILE *errors)
+{
+    char copy[MISSION_LINE], *words[MISSION_WORDS], *word, *hash;
+    const OpSpec *spec = 0;
+    MissionStep step;
+    float value, *slots[3] = {&step.a, &step.b, &step.c};
+    int n = 0, i, len, slot = 0, key, needed;
+    bool optional = false;
+    const char *arg;
+
+    strncpy(copy, text, sizeof(copy) - 1);
+    copy[sizeof(copy) - 1] = 0;
+    hash = strchr(copy, '#');
+    if (hash)
+    {
+        *hash = 0;
+    }
+    for (word = strtok(copy, " \t\r\n"); word; word = strtok(0, " \t\r\n"))
+    {
+        if (n == MISSION_WORDS)
+        {
+            fprintf(errors, "line %d: more than %d words\n", line, MISSION_WORDS);
+            return false;
+        }
+        words[n++] = word;
+    }
+    //Labels in front of the step they name
+    while (n > 0 && (len = strlen(words[0])) > 1 && words[0][len - 1] == ':')
+    {
+        words[0][len - 1] = 0;
+        if (!Define(_labels, &_labelCount, words[0], count, line, errors))
+        {
+            return false;
+        }
+        for (i = 1; i < n; i++)
+        {
+            words[i - 1] = words[i];
+        }
+        n--;
+    }
+    if (n == 0)
+    {
+        return true;
+    }
+    if (strcmp(words[0], "define") == 0)
+    {
+        if (n != 3 || !Number(words[2], &value))
+        {
+            fprintf(errors, "line %d: define takes a name and a number\n", line);
+            return false;
+        }
+        return Define(_defines, &_defineCount, words[1], value, line, errors);
+    }
+
+    for (i = 0; i < (int)(sizeof(specs)/sizeof(specs[0])); i++)
+    {
+        if (strcmp(words[0], specs[i].name) == 0)
+        {
+            spec = &specs[i];
+        }
+    }
+    if (!spec)
+    {
+        fprintf(errors, "line %d: unknown step %s\n", line, words[0]);
+        return false;
+    }
+    if (count == MISSION_MAX)
+    {
+        fprintf(errors, "line %d: more than %d steps\n", line, MISSION_MAX);
+        return false;
+    }
+
+    step.op = spec->op;
+    step.arg = step.target = 0;
+    step.a = step.b = step.c = 0;
+    _jumps[count][0] = 0;
+    lines[count] = line;
+    i = 1;
+    for (arg = spec->args; *arg; arg++)
+    {
+        if (*arg == '[')
+        {
+            optional = true;
+            continue;
+        }
+        if (i >= n)
+        {
+            if (optional)
+            {
+                break;
+            }
+            //The words before the [ are the ones it can't do without
+            needed = strcspn(spec->args, "[");
+            fprintf(errors, "line %d: %s needs %d words after it\n", line, spec->name, needed);
+            return false;
+        }
+        word = words[i++];
+        key = -1;
+        switch (*arg)
+        {
+        case 'd':
+        case 'r':
+        case 'g':
+        case 's':
+        case 't':
+            if (!Number(word, &value))
+            {
+                fprintf(errors, "line %d: %s is not a number or a define\n", line, word);
+                return false;
+            }
+            if (((*arg == 'd' || *arg == 'r') && fabs(value) > MISSION_REACH) || (*arg == 'r' && value == 0) ||
+                (*arg == 'g' && fabs(value) > 360) || (*arg == 's' && fabs(value) > 100) || (*arg == 't' && (value < 0 || value > 60)))
+            {
+                fprintf(errors, "line %d: %s is out of range for %s\n", line, word, spec->name);
+                return false;
+            }
+            *slots[slot++] = value;
+            break;
+        case 'n':
+            if (!Number(word, &value) || value != (int)value || value < -8 || value > 8)
+            {
+                fprintf(errors, "line %d: %s isn't a count %s can take\n", line, word, spec->name);
+                return false;
+            }
+            step.arg = (int)value;
+            break;
+        case 'k':
+            if (strcmp(word, "stop") != 0)
+            {
+                fprintf(errors, "line %d: expected stop, not %s\n", line, word);
+                return false;
+            }
+            step.arg = 1;
+            break;
+        case 'c':
+            if (strcmp(word, "contact") != 0)
+            {
+                fprintf(errors, "line %d: expected contact, not %s\n", line, word);
+                return false;
+            }
+            step.arg = 1;
+            break;
+        case 'S':
+            key = Keyword(word, servoNames, 2, &step.arg);
+            break;
+        case 'W':
+            key = Keyword(word, sideNames, 2, &step.arg);
+            break;
+        case 'E':
+            key = Keyword(word, eventNames, 7, &step.arg);
+            break;
+        case 'F':
+            key = Keyword(word, followNames, 3, &step.arg);
+            break;
+        case 'T':
+            key = Keyword(word, taskNames, TASK_COUNT, &step.arg);
+            break;
+        case 'V':
+            key = Keyword(word, colorNames, 4, &step.arg);
+            if (!key && Number(word, &value) && value == (int)value)
+            {
+                step.arg = (int)value;
+                key = 1;
+            }
+            break;
+        case 'L':
+            strncpy(_jumps[count], word, MISSION_NAME - 1);
+            _jumps[count][MISSION_NAME - 1] = 0;
+            break;
+        }
+        if (key == 0)
+        {
+            fprintf(errors, "line %d: %s doesn't know %s\n", line, spec->name, word);
+            return false;
+        }
+    }
+    if (i < n)
+    {
+        fprintf(errors, "line %d: too many words for %s\n", line, spec->name);
+        return false;
+    }
+    steps[count++] = step;
+    return true;
+}
+
+bool MissionCompiler::Number(const char *word, float *value)
+{
+    char *end;
+    const char *name = word;
+    float scale = 1;
+    int i;
+    *value = strtod(word, &end);
+    if (end != word && *end == 0)
+    {
+        return true;
+    }
+    //NAME, -NAME or number*NAME
+    if (end != word && *end == '*')
+    {
+        scale = *value;
+        name = end + 1;
+    } else if (word[0] == '-')
+    {
+        scale = -1;
+        name = word + 1;
+    }
+    for (i = 0; i < _defineCount; i++)
+    {
+        if (strcmp(_defines[i].name, name) == 0)
+        {
+            *value = scale*_defines[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MissionCompiler::Keyword(const char *word, const char *const *names, int count, int *value)
+{
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        if (strcmp(word, names[i]) == 0)
+        {
+            *value = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MissionCompiler::Define(Symbol *table, int *count, const char *name, float value, int line, FILE *errors)
+{
+    int i;
+    if (strlen(name) >= MISSION_NAME || *count == MISSION_SYMBOLS)
+    {
+        fprintf(errors, "line %d: %s is too long or there are too many names\n", line, name);
+        return false;
+    }
+    for (i = 0; i < *count; i++)
+    {
+        if (strcmp(table[i].name, name) == 0)
+        {
+            fprintf(errors, "line %d: %s was already given on line %d\n", line, name, table[i].line);
+            return false;
+        }
+    }
+    strcpy(table[*count].name, name);
+    table[*count].value = value;
+    table[*count].line = line;
+    (*count)++;
+    return true;
+}
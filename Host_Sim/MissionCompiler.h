@@ -0,0 +1,63 @@
+#ifndef MISSIONCOMPILER_H
+#define MISSIONCOMPILER_H
+
+#include <stdio.h>
+#include "Mission.h"
+
+//Longest label or define name in a mission source
+#define MISSION_NAME 24
+//Most labels and defines in one source
+#define MISSION_SYMBOLS 64
+
+/*Turns a mission source into the numbered steps Robot_Design_Code's Mission runs, checking it on the way.
+ One step per line, # starts a comment, and a word ending in : labels the next step:
+   define NAME value                   a number the rest of the source can use as NAME, -NAME or 0.75*NAME
+   move inches speed                   pivot degrees speed
+   arc radius degrees speed            sidestep right forward speed
+   qline inches speed [stop]           qpivot degrees speed [stop]           qrun
+   drive_to forward left turn          to a pose relative to where the robot is, turn counter-clockwise
+   servo arm|fork degrees [hold]       servo_start arm|fork degrees [hold]   sync
+   wall front|back speed limit         until event inches speed [timeout]    push event speed timeout
+   follow forever|switches|off_line    sleep seconds                         lanes count
+   color                               lever                                 task tray|icecream|burger|ticket|jukebox|final
+   jump label                          if value label                        end
+ Events are front_any, front_both, back_any, back_both, fork, line and color, and if takes a lever number or
+ red, blue, none or no_reading. Speeds are checked against -100 to 100, pivots against a full turn and
+ distances against the length of the course, and every jump has to land on a label*/
+class MissionCompiler
+{
+public:
+    MissionCompiler();
+
+    //Compiles a source file into steps, printing each problem to errors with its line number. Returns false on any
+    bool Compile(const char *filename, FILE *errors);
+    //Writes the steps in the format Mission::Open() reads
+    bool Write(const char *filename);
+    //Writes the steps as a C++ header with the table <name>Mission for Mission::Use(), naming source in its comments
+    bool WriteTable(const char *filename, const char *name, const char *source);
+
+    MissionStep steps[MISSION_MAX];
+    //Source line of each step
+    int lines[MISSION_MAX];
+    int count;
+
+private:
+    struct Symbol
+    {
+        char name[MISSION_NAME];
+        float value;
+        int line;
+    };
+
+    bool Line(char *text, int line, FILE *errors);
+    bool Number(const char *word, float *value);
+    bool Keyword(const char *word, const char *const *names, int count, int *value);
+    bool Define(Symbol *table, int *count, const char *name, float value, int line, FILE *errors);
+
+    Symbol _defines[MISSION_SYMBOLS], _labels[MISSION_SYMBOLS];
+    int _defineCount, _labelCount;
+    //Jumps waiting for their label, by step
+    char _jumps[MISSION_MAX][MISSION_NAME];
+};
+
+#endif
@@ -0,0 +1,132 @@
+#include "TelemetryLog.h"
+#include <string.h>
+
+//Longest line in a log, a full line of records and the newline
+#define TELEMETRY_LOG_LINE (2*TELEMETRY_LINE*TELEMETRY_RECORD + 16)
+
+//Value of a hex digit, -1 for anything else
+static int Hex(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+TelemetryLog::TelemetryLog()
+{
+    count = 0;
+    version = 0;
+    period = 0;
+    recorded = dropped = 0;
+    ended = false;
+    badLines = 0;
+    lost = 0;
+}
+
+bool TelemetryLog::Load(const char *filename, FILE *errors)
+{
+    char text[TELEMETRY_LOG_LINE];
+    unsigned char record[TELEMETRY_RECORD];
+    FILE *f = fopen(filename, "r");
+    int bytes, ms, line = 1, n, i, j, hi, lo;
+    if (!f)
+    {
+        fprintf(errors, "%s: can't open\n", filename);
+        return false;
+    }
+    count = 0;
+    recorded = dropped = 0;
+    ended = false;
+    badLines = 0;
+    lost = 0;
+    if (!fgets(text, sizeof(text), f) || sscanf(text, "telemetry %d %d %d", &version, &bytes, &ms) != 3)
+    {
+        fprintf(errors, "%s: not a telemetry log\n", filename);
+        fclose(f);
+        return false;
+    }
+    if (version != TELEMETRY_VERSION || bytes != TELEMETRY_RECORD)
+    {
+        fprintf(errors, "%s: version %d with %d byte records, this reads version %d with %d\n", filename, version, bytes,
+                TELEMETRY_VERSION, TELEMETRY_RECORD);
+        fclose(f);
+        return false;
+    }
+    period = ms/1000.0;
+    while (fgets(text, sizeof(text), f))
+    {
+        line++;
+        if (sscanf(text, "end %ld %ld", &recorded, &dropped) == 2)
+        {
+            ended = true;
+            break;
+        }
+        if (sscanf(text, "dropped %ld", &dropped) == 1)
+        {
+            continue;
+        }
+        n = strcspn(text, "\r\n");
+        if (n == 0 || n % (2*TELEMETRY_RECORD) != 0)
+        {
+            fprintf(errors, "%s:%d: %d hex digits isn't a whole number of records\n", filename, line, n);
+            badLines++;
+            continue;
+        }
+        for (i = 0; i < n; i += 2*TELEMETRY_RECORD)
+        {
+            for (j = 0; j < TELEMETRY_RECORD; j++)
+            {
+                hi = Hex(text[i + 2*j]);
+                lo = Hex(text[i + 2*j + 1]);
+                if (hi < 0 || lo < 0)
+                {
+                    break;
+                }
+                record[j] = (unsigned char)(hi << 4 | lo);
+            }
+            if (j < TELEMETRY_RECORD)
+            {
+                fprintf(errors, "%s:%d: bad hex digit\n", filename, line);
+                badLines++;
+                break;
+            }
+            if (count == TELEMETRY_LOG_MAX)
+            {
+                lost++;
+                continue;
+            }
+            Telemetry::Unpack(record, &samples[count++]);
+        }
+    }
+    fclose(f);
+    if (!ended)
+    {
+        //Cut off, the records on the card and the last dropped line are all there is to go on
+        recorded = count + lost + dropped;
+    }
+    return true;
+}
+
+bool TelemetryLog::WriteCSV(FILE *out)
+{
+    int i;
+    fprintf(out, "time,left_counts,right_counts,left_power,right_power,state,flags,cds_v,left_v,center_v,right_v,"
+                 "rps_x,rps_y,rps_heading,battery_v\n");
+    for (i = 0; i < count; i++)
+    {
+        const TelemetrySample &s = samples[i];
+        fprintf(out, "%.3f,%d,%d,%.0f,%.0f,%d,%d,%.3f,%.3f,%.3f,%.3f,%.2f,%.2f,%.1f,%.3f\n", s.time, s.leftCounts, s.rightCounts,
+                s.leftPower, s.rightPower, s.state, s.flags, s.cds, s.left, s.center, s.right, s.x, s.y, s.heading, s.battery);
+    }
+    return !ferror(out);
+}
@@ -0,0 +1,37 @@
+#ifndef TELEMETRYLOG_H
+#define TELEMETRYLOG_H
+
+#include <stdio.h>
+#include "Telemetry.h"
+
+//Most records one log can hold, ten minutes at TELEMETRY_PERIOD
+#define TELEMETRY_LOG_MAX 60000
+
+/*Reads a log Robot_Design_Code's Telemetry wrote to the SD card back into samples: the header line, lines of
+ hex records, the "dropped <count>" lines between them and the "end <records> <dropped>" line Close() adds.
+ A log cut off before Close() still loads, ended is false and recorded and dropped are what the records and
+ the last dropped line on the card account for*/
+class TelemetryLog
+{
+public:
+    TelemetryLog();
+
+    //Loads a log, printing each problem to errors with its line number. Returns false if it isn't a telemetry log
+    bool Load(const char *filename, FILE *errors);
+    //Writes the samples as CSV with a header row, one row per record
+    bool WriteCSV(FILE *out);
+
+    TelemetrySample samples[TELEMETRY_LOG_MAX];
+    int count;
+    //From the header, seconds between records
+    int version;
+    double period;
+    //From the end line, or the last dropped line, samples the robot took and those the ring had no room for
+    long recorded, dropped;
+    bool ended;
+    //Hex digits that weren't a whole record, and records past TELEMETRY_LOG_MAX
+    int badLines;
+    long lost;
+};
+
+#endif
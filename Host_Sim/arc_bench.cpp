@@ -0,0 +1,157 @@
+//Compares shifting sideways with a pivot, a short move, a pivot back and a move (what jukebox() did) against two queued
+//arcs making an S, then checks where DriveController::Curve() ends up against the circle it was asked to follow
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include <math.h>
+#include "FEHHost.h"
+#include "DiffDrive.h"
+#include "MotionQueue.h"
+#include "RobotConfig.h"
+
+#define REST 0.02
+
+FEHMotor leftMotor(FEHMotor::Motor3,9);
+FEHMotor rightMotor(FEHMotor::Motor2,9);
+DigitalEncoder leftEncoder(FEHIO::P0_0);
+DigitalEncoder rightEncoder(FEHIO::P0_1);
+
+//A shift of right inches to the right over forward inches, stepped with pivots of pivot degrees
+struct Shift
+{
+    const char *name;
+    float pivot;
+    float step;
+    float push;
+};
+
+const Shift shifts[] =
+{
+    {"jukebox button", 45, 1, 3},
+    {"2 in over 6", 30, 4, 2.54},
+    {"4 in over 10", 45, 5.66, 6},
+    {"back 1 in over 4", -45, -1.41, -3},
+};
+
+struct Arc
+{
+    float distance;
+    float curvature;
+};
+
+const Arc arcs[] =
+{
+    {12, 0},
+    {12, 1.0/12},
+    {12, -1.0/8},
+    {-10, 1.0/10},
+    {6, 1.0/4},
+    {3.2, 1.0/5},
+    {3.2, -1.0/5},
+};
+
+//Starts a fresh plant and controller, heading 0 along +x
+void place(DiffDrive &robot)
+{
+    FEHHost::Reset();
+    FEHHost::SetPlant(&robot);
+}
+
+//Runs the robot to a stop, returns the time it took
+double finish(DiffDrive &robot)
+{
+    double t = TimeNow();
+    Sleep(1.0);
+    FEHHost::SetPlant(0);
+    return t;
+}
+
+double stepped(const Shift &s, double *side, double *along, double *head)
+{
+    DiffDrive robot;
+    DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W);
+    double t;
+    place(robot);
+    drive.Turn(s.pivot, TURN);
+    Sleep(REST);
+    drive.Drive(s.step, MOVE);
+    Sleep(REST);
+    drive.Turn(-s.pivot, TURN);
+    Sleep(REST);
+    drive.Drive(s.push, MOVE);
+    Sleep(REST);
+    t = finish(robot);
+    *side = -robot.y;
+    *along = robot.x;
+    *head = robot.heading*180.0/M_PI;
+    return t;
+}
+
+//The same S sidestep() in Robot_Design_Code queues
+double curved(float right, float forward, double *side, double *along, double *head)
+{
+    DiffDrive robot;
+    DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W);
+    MotionQueue motion(drive);
+    float turn = 2*atan2(fabs(right), fabs(forward)), radius = fabs(forward)/(2*sin(turn));
+    double t;
+    place(robot);
+    turn = turn*180.0/M_PI;
+    radius = (forward < 0) ? -radius : radius;
+    turn = (right*forward < 0) ? -turn : turn;
+    motion.Arc(radius, turn, MOVE);
+    motion.Arc(radius, -turn, MOVE);
+    motion.Run();
+    Sleep(REST);
+    t = finish(robot);
+    *side = -robot.y;
+    *along = robot.x;
+    *head = robot.heading*180.0/M_PI;
+    return t;
+}
+
+int main()
+{
+    int n = sizeof(shifts)/sizeof(shifts[0]), m = sizeof(arcs)/sizeof(arcs[0]);
+    int i;
+    double tStep, tArc, sStep, sArc, aStep, aArc, hStep, hArc, right, forward;
+    double x, y, h, turned;
+
+    printf("%-18s %10s %8s %10s %8s %14s %14s\n", "shift", "stepped(s)", "arcs(s)", "saved", "target", "end err (in)", "heading (deg)");
+    for (i = 0; i < n; i++)
+    {
+        const Shift &s = shifts[i];
+        right = s.step*sin(s.pivot*M_PI/180.0);
+        forward = s.step*cos(s.pivot*M_PI/180.0) + s.push;
+        tStep = stepped(s, &sStep, &aStep, &hStep);
+        tArc = curved(right, forward, &sArc, &aArc, &hArc);
+        printf("%-18s %10.2f %8.2f %9.0f%% %4.2f,%-4.2f %6.2f/%-7.2f %6.1f/%-7.1f\n", s.name, tStep, tArc, 100.0*(tStep - tArc)/tStep,
+               right, forward, hypot(sStep - right, aStep - forward), hypot(sArc - right, aArc - forward), fabs(hStep), fabs(hArc));
+    }
+
+    printf("\n%-10s %12s %8s %12s %12s\n", "curve(in)", "curvature", "time(s)", "end err (in)", "heading (deg)");
+    for (i = 0; i < m; i++)
+    {
+        DiffDrive robot;
+        DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W);
+        place(robot);
+        drive.Curve(arcs[i].distance, arcs[i].curvature, MOVE);
+        Sleep(REST);
+        tArc = finish(robot);
+        //Positive curvature turns right, clockwise, by the distance travelled whichever way the robot goes
+        turned = -fabs(arcs[i].distance)*arcs[i].curvature;
+        if (arcs[i].curvature == 0)
+        {
+            x = arcs[i].distance;
+            y = 0;
+        } else
+        {
+            x = arcs[i].distance/fabs(arcs[i].distance)*sin(fabs(turned))/fabs(arcs[i].curvature);
+            y = (1 - cos(turned))/-arcs[i].curvature*(arcs[i].distance < 0 ? -1 : 1);
+        }
+        h = remainder(robot.heading - turned, 2*M_PI)*180.0/M_PI;
+        printf("%-10.1f %12.3f %8.2f %12.2f %12.1f\n", arcs[i].distance, arcs[i].curvature, tArc, hypot(robot.x - x, robot.y - y), fabs(h));
+    }
+    return 0;
+}
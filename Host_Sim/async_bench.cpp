@@ -0,0 +1,94 @@
+//Time the servo parts of burger() and ticket() take when every servo move is waited out before the robot
+//drives on, against the same moves overlapped with the drive through AsyncMotion the way Robot_Design_Code
+//runs them now. The drive and servos run on the scheduler either way, only the waiting changes
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHServo.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include "FEHHost.h"
+#include "DiffDrive.h"
+#include "AsyncMotion.h"
+#include "RobotConfig.h"
+
+FEHMotor leftMotor(FEHMotor::Motor3,9);
+FEHMotor rightMotor(FEHMotor::Motor2,9);
+DigitalEncoder leftEncoder(FEHIO::P0_0);
+DigitalEncoder rightEncoder(FEHIO::P0_1);
+FEHServo servo_arm(FEHServo::Servo0);
+FEHServo servo_fork(FEHServo::Servo1);
+DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W);
+Scheduler scheduler;
+AsyncMotion async(scheduler, drive);
+ServoController armMove(servo_arm, SERVO_ARM_MIN, SERVO_ARM_MAX, SERVO_SPEED);
+ServoController forkMove(servo_fork, SERVO_FORK_MIN, SERVO_FORK_MAX, SERVO_SPEED);
+
+//Either waits for a move on its own or hands it back to be waited on with the next one
+Motion start(Motion m, bool overlap)
+{
+    if (!overlap)
+    {
+        async.Await(m);
+    }
+    return m;
+}
+
+//From the fork reaching the wheel to facing the line to the ice cream machine
+void burger(bool overlap)
+{
+    Motion fork, back;
+    async.Await(async.Servo(forkMove, 95, FLIP_HOLD));
+    fork = start(async.Servo(forkMove, 0), overlap);
+    back = async.Drive(0.5, MOVE);
+    async.AllOf(fork, back);
+    async.Await(async.Turn(-90, TURN));
+}
+
+//From lining up with the ticket to facing the ramp
+void ticket(bool overlap)
+{
+    Motion turn, arm;
+    turn = start(async.Turn(45, TURN), overlap);
+    arm = async.Servo(armMove, 100);
+    async.AllOf(turn, arm);
+    async.Await(async.Turn(30, TURN));
+    async.Await(async.Drive(-2, MOVE));
+    async.Await(async.Turn(10, TURN));
+    async.Await(async.Drive(5, MOVE));
+    async.Await(async.Turn(-45, TURN));
+    arm = start(async.Servo(armMove, 0), overlap);
+    async.Await(async.Turn(45, TURN));
+    async.Await(async.Drive(8, MOVE));
+    async.Await(arm);
+    async.Await(async.Turn(90, TURN));
+}
+
+double run(void (*sequence)(bool), bool overlap)
+{
+    DiffDrive robot;
+    double start;
+    FEHHost::Reset();
+    FEHHost::SetPlant(&robot);
+    armMove.Move(0);
+    forkMove.Move(0);
+    armMove.Wait();
+    forkMove.Wait();
+    start = TimeNow();
+    sequence(overlap);
+    FEHHost::SetPlant(0);
+    return TimeNow() - start;
+}
+
+int main()
+{
+    double serial[2], overlapped[2];
+    serial[0] = run(burger, false);
+    overlapped[0] = run(burger, true);
+    serial[1] = run(ticket, false);
+    overlapped[1] = run(ticket, true);
+    printf("%-10s %9s %11s %7s\n", "sequence", "waited(s)", "overlapped(s)", "saved");
+    printf("%-10s %9.2f %11.2f %7.2f\n", "burger", serial[0], overlapped[0], serial[0] - overlapped[0]);
+    printf("%-10s %9.2f %11.2f %7.2f\n", "ticket", serial[1], overlapped[1], serial[1] - overlapped[1]);
+    printf("%.2f s off the course time\n", serial[0] + serial[1] - overlapped[0] - overlapped[1]);
+    return 0;
+}
@@ -0,0 +1,140 @@
+//Runs the drive calibration from Robot_Design_Code on the Field plant, whose wheels and track are off from WHEEL and
+//W2W, and compares how far a few move sequences end from where they should with the #defined geometry and with the
+//fitted one after a round trip through the SD card. RPS has its usual latency, noise and dropouts, and every run is
+//measured against the plant's true pose
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "FEHHost.h"
+#include "Field.h"
+#include "Kinematics.h"
+#include "RobotConfig.h"
+
+#define REST 0.02
+//Written where Robot_Design_Code won't pick it up in course_sim
+#define BENCH_FILE "kinematics_bench.txt"
+
+FEHMotor leftMotor(FEHMotor::Motor3,9);
+FEHMotor rightMotor(FEHMotor::Motor2,9);
+DigitalEncoder leftEncoder(FEHIO::P0_0);
+DigitalEncoder rightEncoder(FEHIO::P0_1);
+
+struct Step
+{
+    bool turn;
+    float amount;
+};
+
+struct Sequence
+{
+    const char *name;
+    int count;
+    Step steps[8];
+};
+
+const Sequence sequences[] =
+{
+    {"24 in", 1, {{false, 24}}},
+    {"pivot 90", 1, {{true, 90}}},
+    {"pivot 20", 1, {{true, 20}}},
+    {"ticket block", 3, {{false, -6.5}, {true, 90}, {false, 13}}},
+    {"square", 7, {{false, 12}, {true, 90}, {false, 12}, {true, 90}, {false, 12}, {true, 90}, {false, 12}}},
+};
+
+//Where an exact execution of the sequence ends up, heading positive counter-clockwise like DiffDrive
+void ideal(const Sequence &seq, double *x, double *y, double *h)
+{
+    int i;
+    *x = *y = *h = 0;
+    for (i = 0; i < seq.count; i++)
+    {
+        if (seq.steps[i].turn)
+        {
+            *h -= seq.steps[i].amount*M_PI/180.0;
+        } else
+        {
+            *x += seq.steps[i].amount*cos(*h);
+            *y += seq.steps[i].amount*sin(*h);
+        }
+    }
+}
+
+//Runs the sequence the way linearMove() and pivot() do with geometry k, from the origin
+void run(const Sequence &seq, Kinematics &k, double *posErr, double *headErr)
+{
+    Field plant;
+    DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, k.CountsPerInch(), k.track);
+    double x, y, h;
+    int i;
+    FEHHost::Reset();
+    FEHHost::SetPlant(&plant);
+    for (i = 0; i < seq.count; i++)
+    {
+        if (seq.steps[i].turn)
+        {
+            drive.Turn(k.TurnCommand(seq.steps[i].amount), TURN);
+        } else
+        {
+            drive.Drive(seq.steps[i].amount, MOVE);
+        }
+        Sleep(REST);
+    }
+    Sleep(1.0);
+    FEHHost::SetPlant(0);
+    ideal(seq, &x, &y, &h);
+    *posErr = hypot(plant.x - x, plant.y - y);
+    *headErr = fabs(remainder(plant.heading - h, 2*M_PI))*180.0/M_PI;
+}
+
+int main()
+{
+    const float drives[] = {12, -12, 24, -24};
+    const float turns[] = {90, -90, 180, -180, 45, -45, 20, -20};
+    Kinematics nominal(WHEEL, W2W, COUNTS_PER_REV), fitted(WHEEL, W2W, COUNTS_PER_REV), loaded(WHEEL, W2W, COUNTS_PER_REV);
+    Field plant;
+    DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, nominal.CountsPerInch(), nominal.track);
+    KinematicCalibration cal(drive);
+    double t, p0, h0, p1, h1;
+    bool fit, saved, read;
+    int i, n = sizeof(sequences)/sizeof(sequences[0]);
+
+    //Calibrating in the open, clear of the field's dropout band
+    srand(3);
+    FEHHost::Reset();
+    FEHHost::SetPlant(&plant);
+    plant.x = 55;
+    plant.y = 30;
+    for (i = 0; i < (int)(sizeof(drives)/sizeof(drives[0])); i++)
+    {
+        cal.Straight(drives[i], MOVE);
+    }
+    for (i = 0; i < (int)(sizeof(turns)/sizeof(turns[0])); i++)
+    {
+        cal.Pivot(turns[i], TURN);
+    }
+    t = TimeNow();
+    FEHHost::SetPlant(0);
+    fit = cal.Fit(fitted);
+    saved = fitted.Save(BENCH_FILE);
+    read = loaded.Load(BENCH_FILE);
+
+    printf("calibration: %d of %lu drives and %d of %lu pivots measured in %.1f s, fit %s, SD save %s, load %s\n",
+           cal.straights, sizeof(drives)/sizeof(drives[0]), cal.turns, sizeof(turns)/sizeof(turns[0]), t,
+           fit ? "ok" : "failed", saved ? "ok" : "failed", read ? "ok" : "failed");
+    printf("%-12s %10s %10s %10s\n", "", "wheel(in)", "track(in)", "offset(deg)");
+    printf("%-12s %10.3f %10.3f %10s\n", "plant", plant.wheel, plant.track, "-");
+    printf("%-12s %10.3f %10.3f %10.2f\n", "#defined", nominal.wheel, nominal.track, nominal.turnOffset);
+    printf("%-12s %10.3f %10.3f %10.2f\n", "fitted", loaded.wheel, loaded.track, loaded.turnOffset);
+
+    printf("\n%-14s %22s %22s\n", "sequence", "#defined err in/deg", "calibrated err in/deg");
+    for (i = 0; i < n; i++)
+    {
+        run(sequences[i], nominal, &p0, &h0);
+        run(sequences[i], loaded, &p1, &h1);
+        printf("%-14s %12.2f/%-9.1f %12.2f/%-9.1f\n", sequences[i].name, p0, h0, p1, h1);
+    }
+    return 0;
+}
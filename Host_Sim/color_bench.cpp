@@ -0,0 +1,97 @@
+//How often the jukebox button gets picked wrong from a noisy CdS cell. The original jukebox() stopped when
+//one cdsColor() call saw a color and then called it again to choose the button, each call deciding from
+//separate single readings. The ColorSensor decides once from the median of a burst against the
+//calibration table. The light reads the course levels with 120 Hz ripple and random noise on top
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "FEHHost.h"
+#include "Baseline.h"
+#include "ColorSensor.h"
+
+#define TRIALS 2000
+#define RIPPLE 0.15
+//Random noise on each reading in volts, standard deviation
+#define NOISE 0.25
+
+AnalogInputPin CdS(FEHIO::P0_2);
+ColorSensor cdsSensor(CdS);
+
+//Jukebox light of one color with flicker and noise
+class NoisyLight : public FEHHost::Sensor
+{
+public:
+    float Value(double t)
+    {
+        //Sum of uniform numbers is close enough to a normal distribution
+        float noise = 0;
+        int i;
+        for (i = 0; i < 12; i++)
+        {
+            noise += rand()/(float)RAND_MAX;
+        }
+        return level + RIPPLE*sin(2*M_PI*120*t) + NOISE*(noise - 6);
+    }
+
+    float level;
+};
+
+//Button the original jukebox() would press, it went to the blue button for anything but red
+int original()
+{
+    while (Baseline::cdsColor(CdS) == Baseline::NO_COLOR)
+    {
+    }
+    return (Baseline::cdsColor(CdS) == Baseline::CDSRED) ? COLOR_RED : COLOR_BLUE;
+}
+
+//Button jukebox() presses now, with its retries of a doubtful reading
+int filtered(float *confidence)
+{
+    ColorReading light;
+    int i;
+    do
+    {
+        light = cdsSensor.Read();
+    } while (light.color == COLOR_NONE);
+    for (i = 0; i < 3 && light.confidence < 0.5; i++)
+    {
+        light = cdsSensor.Read();
+    }
+    *confidence = light.confidence;
+    return (light.color == COLOR_RED) ? COLOR_RED : COLOR_BLUE;
+}
+
+int main()
+{
+    NoisyLight light;
+    int i, color, wrong[2] = {0, 0};
+    double start, time[2] = {0, 0};
+    float confidence, sure[2] = {0, 0};
+
+    srand(1);
+    FEHHost::AttachSensor(FEHIO::P0_2, &light);
+    for (i = 0; i < TRIALS; i++)
+    {
+        color = i % 2 ? COLOR_BLUE : COLOR_RED;
+        light.level = (color == COLOR_RED) ? 0.5 : 1.3;
+        //Lands the decision at a different point of the flicker each time
+        Sleep(0.00137);
+        start = TimeNow();
+        wrong[0] += original() != color;
+        time[0] += TimeNow() - start;
+        start = TimeNow();
+        wrong[1] += filtered(&confidence) != color;
+        time[1] += TimeNow() - start;
+        sure[color] += confidence;
+    }
+    FEHHost::AttachSensor(FEHIO::P0_2, 0);
+
+    printf("%-20s %10s %12s\n", "jukebox decision", "wrong(%)", "time(ms)");
+    printf("%-20s %10.2f %12.2f\n", "cdsColor() twice", 100.0*wrong[0]/TRIALS, 1000*time[0]/TRIALS);
+    printf("%-20s %10.2f %12.2f\n", "median of burst", 100.0*wrong[1]/TRIALS, 1000*time[1]/TRIALS);
+    printf("mean confidence %.2f under red, %.2f under blue\n", sure[COLOR_RED]/(TRIALS/2), sure[COLOR_BLUE]/(TRIALS/2));
+    return 0;
+}
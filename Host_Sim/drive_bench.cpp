@@ -0,0 +1,69 @@
+//Benchmark of the closed-loop DriveController against the original open-loop linearMove() busy-wait
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include <math.h>
+#include "FEHHost.h"
+#include "DiffDrive.h"
+#include "DriveControl.h"
+#include "Baseline.h"
+#include "RobotConfig.h"
+
+FEHMotor leftMotor(FEHMotor::Motor3,9);
+FEHMotor rightMotor(FEHMotor::Motor2,9);
+DigitalEncoder leftEncoder(FEHIO::P0_0);
+DigitalEncoder rightEncoder(FEHIO::P0_1);
+
+//Sleeps in small steps until both wheels have stopped, returns when they did
+double settle(DiffDrive &robot)
+{
+    while (fabs(robot.leftSpeed) > 0.01 || fabs(robot.rightSpeed) > 0.01)
+    {
+        Sleep(0.001);
+    }
+    return TimeNow();
+}
+
+void run(const char *name, bool closed, float distance, float speed)
+{
+    DiffDrive robot;
+    DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W);
+    double t;
+    float travelled, overshoot, drift;
+
+    FEHHost::Reset();
+    FEHHost::SetPlant(&robot);
+    if (closed)
+    {
+        drive.Drive(distance, speed);
+    } else
+    {
+        Baseline::linearMove(leftMotor, rightMotor, leftEncoder, rightEncoder, distance, speed);
+    }
+    t = settle(robot);
+    FEHHost::SetPlant(0);
+
+    travelled = (robot.leftTravel + robot.rightTravel)/2.0;
+    overshoot = fabs(travelled) - fabs(distance);
+    drift = robot.heading*180.0/M_PI;
+    printf("%-11s %7.1f %6.0f %9.3f %11.3f %10.2f\n", name, distance, speed, t, overshoot, drift);
+}
+
+int main()
+{
+    float distances[] = {1, 6, 12, 22, -6};
+    float speeds[] = {MOVE, 1.5*MOVE};
+    int i, j;
+
+    printf("%-11s %7s %6s %9s %11s %10s\n", "controller", "dist", "speed", "settle(s)", "overshoot", "drift(deg)");
+    for (j = 0; j < 2; j++)
+    {
+        for (i = 0; i < 5; i++)
+        {
+            run("open-loop", false, distances[i], speeds[j]);
+            run("closed-loop", true, distances[i], speeds[j]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+//How fast and how closely lineFollow() tracks a line with a bend in it, the original bang-bang state machine
+//against the PID LineFollower, on the course model. The robot starts on a straight run of tape that turns
+//through 30 degrees halfway along, and each version follows it until the optosensors reach the far end
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include "FEHHost.h"
+#include "Course.h"
+#include "Baseline.h"
+#include "LineFollower.h"
+
+#define LEFT_BREAK 1.0
+#define CENTER_BREAK 1.27
+#define RIGHT_BREAK 2.68
+#define LEFT_SPAN 1.3
+#define CENTER_SPAN 1.5
+#define RIGHT_SPAN 0.8
+//Gives up on a version that hasn't reached the end by then
+#define FOLLOW_LIMIT 60.0
+
+FEHMotor leftMotor(FEHMotor::Motor3,9);
+FEHMotor rightMotor(FEHMotor::Motor2,9);
+AnalogInputPin leftLine(FEHIO::P1_0);
+AnalogInputPin centerLine(FEHIO::P1_1);
+AnalogInputPin rightLine(FEHIO::P1_2);
+LineSensors lineSensors(leftLine, centerLine, rightLine, LEFT_BREAK, CENTER_BREAK, RIGHT_BREAK, LEFT_SPAN, CENTER_SPAN, RIGHT_SPAN);
+LineFollower follower(leftMotor, rightMotor, lineSensors);
+
+//Tape the robot follows, driving backwards so the optosensors lead
+const double PATH[3][2] = {{8, 10}, {38, 10}, {64, 25}};
+
+const char *MAP =
+    "start 12 10 180\n"
+    "wall 0 0 75 0\nwall 75 0 75 48\nwall 75 48 0 48\nwall 0 48 0 0\n"
+    "line 8 10 38 10\nline 38 10 64 25\n";
+
+Course course;
+
+//Distance from the optosensors to the tape
+double trackError()
+{
+    double sx = course.x + course.lineX*cos(course.heading), sy = course.y + course.lineX*sin(course.heading);
+    double best = 1e9, dx, dy, t, d;
+    int i;
+    for (i = 0; i < 2; i++)
+    {
+        dx = PATH[i + 1][0] - PATH[i][0];
+        dy = PATH[i + 1][1] - PATH[i][1];
+        t = ((sx - PATH[i][0])*dx + (sy - PATH[i][1])*dy)/(dx*dx + dy*dy);
+        t = (t < 0) ? 0 : (t > 1) ? 1 : t;
+        d = hypot(sx - PATH[i][0] - t*dx, sy - PATH[i][1] - t*dy);
+        if (d < best)
+        {
+            best = d;
+        }
+    }
+    return best;
+}
+
+//True once the optosensors are past the end of the tape
+bool done()
+{
+    return course.x + course.lineX*cos(course.heading) > PATH[2][0] - 2.0;
+}
+
+//Follows the line with one version, returns the time taken or -1 if the line was lost or time ran out
+double run(const char *map, bool pid, double *rms, double *worst)
+{
+    double start, sum = 0, e;
+    long samples = 0;
+    int state = Baseline::OFF_LINE, time = 0;
+    bool going = true;
+    LineSnapshot line;
+
+    course.Load(map);
+    FEHHost::Reset();
+    FEHHost::SetPlant(&course);
+    start = TimeNow();
+    *worst = 0;
+    if (pid)
+    {
+        line = follower.Start();
+    }
+    while (going && !done() && TimeNow() - start < FOLLOW_LIMIT)
+    {
+        if (pid)
+        {
+            follower.Steer(line);
+            line = follower.Next();
+            going = line.mask != 0;
+        } else
+        {
+            going = Baseline::lineFollowStep(leftLine, centerLine, rightLine, leftMotor, rightMotor, &state, &time);
+        }
+        e = trackError();
+        sum += e*e;
+        samples++;
+        if (e > *worst)
+        {
+            *worst = e;
+        }
+    }
+    leftMotor.Stop();
+    rightMotor.Stop();
+    *rms = samples ? sqrt(sum/samples) : 0;
+    return done() ? TimeNow() - start : -1;
+}
+
+int main()
+{
+    char map[] = "/tmp/follow_benchXXXXXX";
+    int fd = mkstemp(map);
+    double oldTime, newTime, oldRms, newRms, oldWorst, newWorst;
+
+    if (fd < 0 || write(fd, MAP, strlen(MAP)) < 0)
+    {
+        perror("follow_bench");
+        return 1;
+    }
+    close(fd);
+    oldTime = run(map, false, &oldRms, &oldWorst);
+    newTime = run(map, true, &newRms, &newWorst);
+    unlink(map);
+
+    printf("%-12s %9s %10s %10s\n", "follower", "time(s)", "rms(in)", "worst(in)");
+    printf("%-12s %9.2f %10.3f %10.3f\n", "bang-bang", oldTime, oldRms, oldWorst);
+    printf("%-12s %9.2f %10.3f %10.3f\n", "pid", newTime, newRms, newWorst);
+    if (oldTime > 0 && newTime > 0)
+    {
+        printf("%.1fx faster over %.0f in of line\n", oldTime/newTime, hypot(30, 0) + hypot(26, 15));
+    } else
+    {
+        printf("a follower lost the line, -1 is a run that did not reach the end\n");
+    }
+    return 0;
+}
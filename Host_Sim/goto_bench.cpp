@@ -0,0 +1,137 @@
+//Time to target and terminal error of Navigator::GoTo() against the chain of linearMove()/pivot() primitives it
+//replaces. The robot runs on the Field plant, whose wheels and track are off from the numbers the code uses,
+//with the PoseEstimator fed by its laggy, noisy RPS. Each path is a chain of drives (inches) and right turns
+//(degrees) from a known pose. The chain is run blind like Robot_Design_Code does, then GoTo() is sent straight
+//to the pose the chain would reach on a perfect robot. Errors are against the true pose of the plant. The ticket
+//path runs inside the field's RPS dropout, so its GoTo() has nothing but odometry to check itself with
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "FEHHost.h"
+#include "Field.h"
+#include "AsyncMotion.h"
+#include "PoseEstimator.h"
+#include "Navigator.h"
+#include "RobotConfig.h"
+
+#define REST 0.02
+//Most steps in a path
+#define PATH_STEPS 8
+
+FEHMotor leftMotor(FEHMotor::Motor3,9);
+FEHMotor rightMotor(FEHMotor::Motor2,9);
+DigitalEncoder leftEncoder(FEHIO::P0_0);
+DigitalEncoder rightEncoder(FEHIO::P0_1);
+DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W);
+Scheduler scheduler;
+AsyncMotion async(scheduler, drive);
+
+void drivePowers(float *left, float *right)
+{
+    *left = drive.LeftPower();
+    *right = drive.RightPower();
+}
+
+PoseEstimator estimator(leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W, drivePowers);
+Navigator navigator(scheduler, drive, estimator);
+
+//A block of primitives: 'd' drives inches, 't' turns degrees right like pivot()
+struct Path
+{
+    const char *name;
+    float x, y, heading;
+    int steps;
+    char kind[PATH_STEPS];
+    float amount[PATH_STEPS];
+};
+
+Path paths[] = {
+    {"ticket, no RPS", 40, 20, 192, 3, {'d', 't', 'd'}, {-6.5, 90, 13}},
+    {"jukebox jog", 20, 30, 90, 3, {'t', 'd', 't'}, {45, 1, -45}},
+    {"dogleg", 15, 15, 0, 5, {'d', 't', 'd', 't', 'd'}, {10, -45, 22, 90, 8}},
+    {"box out", 20, 10, 90, 6, {'d', 't', 'd', 't', 'd', 't'}, {15, 90, 12, 90, 15, 90}},
+    {"jukebox to final", 60, 15, 270, 4, {'d', 't', 'd', 't'}, {-6, -90, -8, 45}},
+};
+
+//Where the path ends on a robot that does exactly what it is told
+Pose ideal(Path &p)
+{
+    Pose pose;
+    int i;
+    pose.x = p.x;
+    pose.y = p.y;
+    pose.heading = p.heading;
+    for (i = 0; i < p.steps; i++)
+    {
+        pose = (p.kind[i] == 'd') ? Navigator::Offset(pose, p.amount[i], 0, 0) : Navigator::Offset(pose, 0, 0, -p.amount[i]);
+    }
+    return pose;
+}
+
+//Puts a fresh field under the robot at the start of a path with the estimator running
+void place(Field &plant, Path &p)
+{
+    srand(3);
+    FEHHost::Reset();
+    FEHHost::SetPlant(&plant);
+    plant.x = p.x;
+    plant.y = p.y;
+    plant.heading = p.heading*M_PI/180.0;
+    estimator.Set(p.x, p.y, p.heading);
+    scheduler.Add(estimator, POSE_PERIOD);
+}
+
+//True distance and heading error of the plant from a pose
+void error(Field &plant, Pose target, float *distance, float *heading)
+{
+    *distance = hypot(plant.x - target.x, plant.y - target.y);
+    *heading = fabs(PoseEstimator::Wrap(plant.heading*180.0/M_PI - target.heading));
+}
+
+int main()
+{
+    GoToResult result;
+    Pose target;
+    double start, chainTime;
+    float chainError, chainHeading, goError, goHeading;
+    int k, i, n = sizeof(paths)/sizeof(paths[0]);
+
+    printf("%-16s %8s %8s %8s | %8s %8s %8s %5s\n", "path", "chain(s)", "err(in)", "err(deg)", "goTo(s)", "err(in)", "err(deg)", "legs");
+    for (k = 0; k < n; k++)
+    {
+        Field chainPlant, goPlant;
+        target = ideal(paths[k]);
+
+        //The block of primitives, each followed by the same rest linearMove() and pivot() take
+        place(chainPlant, paths[k]);
+        start = TimeNow();
+        for (i = 0; i < paths[k].steps; i++)
+        {
+            if (paths[k].kind[i] == 'd')
+            {
+                async.Await(async.Drive(paths[k].amount[i], MOVE));
+            } else
+            {
+                async.Await(async.Turn(paths[k].amount[i], TURN));
+            }
+            Sleep(REST);
+        }
+        chainTime = TimeNow() - start;
+        scheduler.Remove(estimator);
+        error(chainPlant, target, &chainError, &chainHeading);
+
+        //One GoTo() to where the block should have ended
+        place(goPlant, paths[k]);
+        result = navigator.GoTo(target.x, target.y, target.heading, MOVE, TURN);
+        scheduler.Remove(estimator);
+        error(goPlant, target, &goError, &goHeading);
+        FEHHost::SetPlant(0);
+
+        printf("%-16s %8.2f %8.2f %8.1f | %8.2f %8.2f %8.1f %5d\n", paths[k].name, chainTime, chainError, chainHeading,
+            result.elapsed, goError, goHeading, result.legs);
+    }
+    return 0;
+}
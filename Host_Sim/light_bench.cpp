@@ -0,0 +1,102 @@
+//Reaction time to the start light: how long after the CdS cell sees red the start-light wait in main()
+//returns, with the original cdsColor() that clears the screen on every poll against the current one that
+//only posts the color to the StatusDisplay. The light turns on at 50 different moments so the result
+//doesn't depend on where in a poll it happens to land
+#include <FEHIO.h>
+#include <FEHLCD.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include "FEHHost.h"
+#include "Baseline.h"
+#include "StatusDisplay.h"
+
+#define CDSRED 0
+#define CDSBLUE 1
+#define NO_COLOR 2
+#define NO_READING 3
+#define TRIALS 50
+
+AnalogInputPin CdS(FEHIO::P0_2);
+StatusDisplay status;
+
+//Start light that turns on at a set time
+class StartLight : public FEHHost::Sensor
+{
+public:
+    float Value(double t)
+    {
+        return (t >= on) ? 0.5 : 2.6;
+    }
+
+    double on;
+};
+
+//cdsColor() as Robot_Design_Code has it now
+int cdsColor()
+{
+    if (CdS.Value() > 0 && CdS.Value() <= 0.90)
+    {
+        status.Clear(FEHLCD::Red);
+        return CDSRED;
+    } else if (CdS.Value() > 0.90 && CdS.Value() <= 1.8)
+    {
+        status.Clear(FEHLCD::Blue);
+        return CDSBLUE;
+    } else if (CdS.Value() > 1.80 && CdS.Value() <= 3.3)
+    {
+        status.Clear(FEHLCD::Black);
+        status.Line("No colored light detected");
+        return NO_COLOR;
+    } else
+    {
+        return NO_READING;
+    }
+}
+
+//Seconds from the light turning on until the wait loop notices
+double react(bool original, double on)
+{
+    StartLight light;
+    light.on = on;
+    FEHHost::Reset();
+    FEHHost::AttachSensor(FEHIO::P0_2, &light);
+    status.Line("Waiting for light to continue");
+    status.Flush();
+    while (true)
+    {
+        if ((original ? Baseline::cdsColor(CdS) : cdsColor()) == CDSRED)
+        {
+            break;
+        }
+    }
+    FEHHost::AttachSensor(FEHIO::P0_2, 0);
+    return TimeNow() - on;
+}
+
+int main()
+{
+    double oldSum = 0, newSum = 0, oldWorst = 0, newWorst = 0, t;
+    int i, oldClears, newClears;
+
+    oldClears = LCD.Clears();
+    for (i = 0; i < TRIALS; i++)
+    {
+        t = react(true, 1.0 + i*0.00137);
+        oldSum += t;
+        oldWorst = (t > oldWorst) ? t : oldWorst;
+    }
+    oldClears = LCD.Clears() - oldClears;
+    newClears = LCD.Clears();
+    for (i = 0; i < TRIALS; i++)
+    {
+        t = react(false, 1.0 + i*0.00137);
+        newSum += t;
+        newWorst = (t > newWorst) ? t : newWorst;
+    }
+    newClears = LCD.Clears() - newClears;
+
+    printf("%-22s %10s %10s %14s\n", "start light wait", "mean(ms)", "worst(ms)", "clears/run");
+    printf("%-22s %10.2f %10.2f %14.1f\n", "clear every poll", 1000*oldSum/TRIALS, 1000*oldWorst, oldClears/(TRIALS*1.0));
+    printf("%-22s %10.2f %10.2f %14.1f\n", "status display", 1000*newSum/TRIALS, 1000*newWorst, newClears/(TRIALS*1.0));
+    return 0;
+}
@@ -0,0 +1,203 @@
+//Loop frequency of lineFollow() with the original read-as-you-go if/else chain against one LineSensors
+//snapshot per iteration classified through the mask lookup table, for each line state and for a robot
+//weaving across the line where the readings change while an iteration is running
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include <math.h>
+#include "FEHHost.h"
+#include "Baseline.h"
+#include "LineSensors.h"
+
+#define LEFT_BREAK 1.0
+#define CENTER_BREAK 1.27
+#define RIGHT_BREAK 2.68
+
+FEHMotor leftMotor(FEHMotor::Motor3,9);
+FEHMotor rightMotor(FEHMotor::Motor2,9);
+AnalogInputPin leftLine(FEHIO::P1_0);
+AnalogInputPin centerLine(FEHIO::P1_1);
+AnalogInputPin rightLine(FEHIO::P1_2);
+LineSensors lineSensors(leftLine, centerLine, rightLine, LEFT_BREAK, CENTER_BREAK, RIGHT_BREAK);
+
+//Same table as Robot_Design_Code, -1 keeps the previous state
+const int LINE_STATES[8] = {Baseline::OFF_LINE, Baseline::LINE_FAR_LEFT, Baseline::ON_LINE, Baseline::LINE_ON_LEFT,
+                            Baseline::LINE_FAR_RIGHT, -1, Baseline::LINE_ON_RIGHT, -1};
+
+//Optosensor that is either held on one side of its break value or swings across it, and notices when the
+//readings taken during one loop iteration disagree about which side they are on
+class Opto : public FEHHost::Sensor
+{
+public:
+    Opto(float brk) : _break(brk)
+    {
+        level = 0;
+        swing = 0;
+        phase = 0;
+        reads = 0;
+    }
+
+    float Value(double t)
+    {
+        float v = _break + level + swing*sin(2*M_PI*20*t + phase);
+        reads++;
+        if (v > _break)
+        {
+            _above = true;
+        } else
+        {
+            _below = true;
+        }
+        return v;
+    }
+
+    //Starts an iteration, returns true if the last one saw both sides
+    bool Torn()
+    {
+        bool torn = _above && _below;
+        _above = _below = false;
+        return torn;
+    }
+
+    float level, swing, phase;
+    long reads;
+
+private:
+    float _break;
+    bool _above, _below;
+};
+
+Opto left(LEFT_BREAK), center(CENTER_BREAK), right(RIGHT_BREAK);
+
+//One pass of the new lineFollow() loop, mirrors Robot_Design_Code
+bool snapshotStep(int *state, int *time)
+{
+    LineSnapshot line = lineSensors.Read();
+    int next;
+    if (line.mask == 0)
+    {
+        return false;
+    }
+    next = LINE_STATES[line.mask];
+    if (next != -1)
+    {
+        *state = next;
+        if (*state != Baseline::ON_LINE)
+        {
+            *time = 0;
+        } else if (*time == 0)
+        {
+            *time = line.time;
+        }
+    }
+    switch(*state)
+    {
+    case Baseline::ON_LINE:
+        rightMotor.SetPercent(line.time - *time < 2.0 ? -10 : -20);
+        leftMotor.SetPercent(line.time - *time < 2.0 ? -10 : -20);
+        break;
+    case Baseline::LINE_ON_RIGHT:
+        rightMotor.SetPercent(-20);
+        leftMotor.SetPercent(-10);
+        break;
+    case Baseline::LINE_ON_LEFT:
+        rightMotor.SetPercent(-10);
+        leftMotor.SetPercent(-20);
+        break;
+    case Baseline::LINE_FAR_RIGHT:
+        rightMotor.SetPercent(-30);
+        leftMotor.SetPercent(-10);
+        break;
+    case Baseline::LINE_FAR_LEFT:
+        rightMotor.SetPercent(-10);
+        leftMotor.SetPercent(-30);
+        break;
+    default:
+        rightMotor.Stop();
+        leftMotor.Stop();
+        break;
+    }
+    return true;
+}
+
+//Runs one version of the loop for a virtual second, returns iterations per second
+double run(bool snapshot, double *readsPerLoop, double *tornPercent)
+{
+    int state = Baseline::OFF_LINE, time = 0;
+    long loops = 0, torn = 0;
+    double end;
+
+    FEHHost::Reset();
+    FEHHost::AttachSensor(FEHIO::P1_0, &left);
+    FEHHost::AttachSensor(FEHIO::P1_1, &center);
+    FEHHost::AttachSensor(FEHIO::P1_2, &right);
+    left.reads = center.reads = right.reads = 0;
+    left.Torn();
+    center.Torn();
+    right.Torn();
+    end = FEHHost::Now() + 1.0;
+    while (FEHHost::Now() < end)
+    {
+        if (snapshot)
+        {
+            snapshotStep(&state, &time);
+        } else
+        {
+            Baseline::lineFollowStep(leftLine, centerLine, rightLine, leftMotor, rightMotor, &state, &time);
+        }
+        //Only a decision made from disagreeing readings of the same sensor counts
+        torn += (left.Torn() | center.Torn() | right.Torn()) ? 1 : 0;
+        loops++;
+    }
+    *readsPerLoop = (double)(left.reads + center.reads + right.reads)/loops;
+    *tornPercent = 100.0*torn/loops;
+    return loops/(FEHHost::Now() - end + 1.0);
+}
+
+int main()
+{
+    //Offset from each sensor's break value for left, center, right, positive is over the line
+    const struct
+    {
+        const char *name;
+        float l, c, r;
+    } patterns[] =
+    {
+        {"on line", -0.4, 0.6, -0.4},
+        {"line on right", -0.4, 0.6, 0.4},
+        {"line on left", 0.4, 0.6, -0.4},
+        {"line far right", -0.4, -0.6, 0.4},
+        {"line far left", 0.4, -0.6, -0.4},
+    };
+    int i;
+    double oldHz, newHz, oldReads, newReads, oldTorn, newTorn;
+    double oldSum = 0, newSum = 0;
+
+    printf("%-16s %10s %10s %10s %10s %8s %8s\n", "sensors", "old Hz", "new Hz", "old reads", "new reads", "old torn", "new torn");
+    for (i = 0; i < 6; i++)
+    {
+        if (i < 5)
+        {
+            left.level = patterns[i].l;
+            center.level = patterns[i].c;
+            right.level = patterns[i].r;
+            left.swing = center.swing = right.swing = 0;
+        } else
+        {
+            //Weaving across the line at 20 Hz, each sensor crossing at a different moment
+            left.level = center.level = right.level = 0.05;
+            left.swing = center.swing = right.swing = 0.5;
+            left.phase = 0;
+            center.phase = 2.1;
+            right.phase = 4.2;
+        }
+        oldHz = run(false, &oldReads, &oldTorn);
+        newHz = run(true, &newReads, &newTorn);
+        oldSum += oldHz;
+        newSum += newHz;
+        printf("%-16s %10.0f %10.0f %10.1f %10.1f %7.1f%% %7.1f%%\n", i < 5 ? patterns[i].name : "weaving", oldHz, newHz, oldReads, newReads, oldTorn, newTorn);
+    }
+    printf("average loop rate %.0f Hz before, %.0f Hz after (%.1fx)\n", oldSum/6, newSum/6, newSum/oldSum);
+    return 0;
+}
@@ -0,0 +1,67 @@
+//Compiles Robot_Design_Code's course.mis, writes it where Mission reads it and runs it with an action that does
+//nothing, so all the time the run takes is the interpreter's: opening the file, reading each step off the SD card
+//and dispatching it. Every lever and jukebox color is run so every branch is read, from the SD card and from the
+//steps as a table compiled into the program. The robot's own moves take seconds each, the per-step overhead is what
+//the mission adds to them
+#include <FEHUtility.h>
+#include <stdio.h>
+#include "FEHHost.h"
+#include "MissionCompiler.h"
+
+#define SOURCE "../Robot_Design_Code/course.mis"
+//Written where Robot_Design_Code won't pick it up in course_sim
+#define BENCH_FILE "mission_bench.txt"
+
+static MissionCompiler compiler;
+static int lever, color;
+static int calls[OP_COUNT];
+
+int stub(const MissionStep &step)
+{
+    calls[step.op]++;
+    if (step.op == OP_LEVER)
+    {
+        return lever;
+    }
+    return (step.op == OP_COLOR) ? color : 0;
+}
+
+int main()
+{
+    const char *colors[] = {"red", "blue"};
+    Mission mission(stub);
+    double start, open;
+    bool ok;
+    int l, c, sd;
+    if (!compiler.Compile(SOURCE, stderr) || !compiler.Write("sd/" BENCH_FILE))
+    {
+        return 1;
+    }
+    printf("%s: %d steps\n\n", SOURCE, compiler.count);
+    printf("%-6s %-6s %-6s %6s %6s %10s %10s %12s\n", "from", "lever", "light", "run", "steps", "open(ms)", "run(ms)", "per step(ms)");
+    for (sd = 1; sd >= 0; sd--)
+    {
+        for (l = 0; l < 3; l++)
+        {
+            for (c = 0; c < 2; c++)
+            {
+                FEHHost::Reset();
+                lever = l;
+                color = c;
+                start = TimeNow();
+                if (sd)
+                {
+                    mission.Open(BENCH_FILE);
+                } else
+                {
+                    mission.Use(compiler.steps, compiler.count);
+                }
+                open = TimeNow() - start;
+                ok = mission.Run();
+                printf("%-6s %-6d %-6s %6s %6ld %10.1f %10.1f %12.3f\n", sd ? "SD" : "table", l, colors[c], ok ? "ok" : "failed",
+                       mission.executed, 1000*open, 1000*mission.overhead, 1000*mission.overhead/mission.executed);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+//Compiles a mission source into the file Robot_Design_Code reads from the SD card, see MissionCompiler.h for the format.
+//Usage: mission_compile source.mis mission.txt
+//       mission_compile -c name source.mis header.h
+//With -c the mission is written as a C++ header with the table nameMission, for a program that runs it without the SD card
+//Every problem in the source is printed with its line number and nothing is written unless the whole mission is good
+#include <stdio.h>
+#include <string.h>
+#include "MissionCompiler.h"
+
+//Too big to go on the stack
+static MissionCompiler compiler;
+
+int main(int argc, char **argv)
+{
+    int ops[OP_COUNT] = {0};
+    int i, used = 0;
+    bool table = argc == 5 && strcmp(argv[1], "-c") == 0;
+    const char *source = argv[table ? 3 : 1], *output = argv[table ? 4 : 2];
+    if (argc != 3 && !table)
+    {
+        fprintf(stderr, "usage: %s source.mis mission.txt\n       %s -c name source.mis header.h\n", argv[0], argv[0]);
+        return 2;
+    }
+    if (!compiler.Compile(source, stderr))
+    {
+        return 1;
+    }
+    if (!(table ? compiler.WriteTable(output, argv[2], source) : compiler.Write(output)))
+    {
+        fprintf(stderr, "%s: can't write\n", output);
+        return 1;
+    }
+    for (i = 0; i < compiler.count; i++)
+    {
+        used += (ops[compiler.steps[i].op]++ == 0);
+    }
+    printf("%s: %d steps of %d, %d kinds of step\n", output, compiler.count, MISSION_MAX, used);
+    return 0;
+}
@@ -0,0 +1,129 @@
+//Plans and runs every linearMove()/pivot() of the main() course sequence (lever 0, blue jukebox light)
+//and reports the total time against the original jump-to-speed moves followed by a 0.1 s rest
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include <math.h>
+#include "FEHHost.h"
+#include "DiffDrive.h"
+#include "DriveControl.h"
+#include "Baseline.h"
+#include "RobotConfig.h"
+
+#define REST 0.02
+
+FEHMotor leftMotor(FEHMotor::Motor3,9);
+FEHMotor rightMotor(FEHMotor::Motor2,9);
+DigitalEncoder leftEncoder(FEHIO::P0_0);
+DigitalEncoder rightEncoder(FEHIO::P0_1);
+
+struct Primitive
+{
+    bool turn;
+    float amount;
+    float speed;
+};
+
+//Moves of the course functions in the order main() calls them, line following and wall runs are left out
+const Primitive course[] =
+{
+    //tray()
+    {false, 8, MOVE}, {true, 45, TURN}, {false, 9, MOVE}, {true, -90, 0.75*TURN}, {false, -3, 0.75*MOVE}, {true, -90, TURN},
+    //icecream_1(0)
+    {true, 90, TURN}, {false, 12, MOVE}, {true, -90, TURN},
+    //burger()
+    {false, -2.2, MOVE}, {true, 90, TURN}, {false, 0.5, MOVE}, {true, -90, TURN},
+    //icecream_2(0)
+    {true, -90, TURN}, {false, 12, MOVE}, {false, -6, MOVE}, {true, 135, TURN},
+    //ticket()
+    {false, -6.5, MOVE}, {true, 90, TURN}, {false, 13, MOVE}, {true, 45, TURN}, {true, 30, TURN}, {false, -2, MOVE}, {true, 10, TURN},
+    {false, 5, MOVE}, {true, -45, TURN}, {true, 45, TURN}, {false, 8, MOVE}, {true, 90, TURN}, {false, 22, MOVE},
+    //jukebox()
+    {false, -4, MOVE}, {true, -90, TURN}, {true, -45, TURN}, {false, 1, MOVE}, {true, 45, TURN}, {false, 3, MOVE}, {false, -6, MOVE},
+    {true, -90, TURN}, {false, -8, MOVE},
+    //jBox2Final()
+    {true, 45, TURN}, {false, 13, MOVE}
+};
+
+//Runs one primitive on a fresh robot and returns how long the call took including the rest, error is the
+//distance (inches) or angle (degrees) it ended up off by once the robot stopped rolling
+double execute(const Primitive &p, bool profiled, bool sCurve, float *error)
+{
+    DiffDrive robot;
+    DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W);
+    double t;
+
+    drive.gains.sCurve = sCurve;
+    FEHHost::Reset();
+    FEHHost::SetPlant(&robot);
+    if (profiled)
+    {
+        if (p.turn)
+        {
+            drive.Turn(p.amount, p.speed);
+        } else
+        {
+            drive.Drive(p.amount, p.speed);
+        }
+        Sleep(REST);
+    } else
+    {
+        if (p.turn)
+        {
+            Baseline::pivot(leftMotor, rightMotor, leftEncoder, rightEncoder, p.amount, p.speed);
+        } else
+        {
+            Baseline::linearMove(leftMotor, rightMotor, leftEncoder, rightEncoder, p.amount, p.speed);
+        }
+        Sleep(Baseline::OLD_REST);
+    }
+    t = TimeNow();
+    //Let whatever momentum is left play out to see where the robot really ends up
+    Sleep(1.0);
+    FEHHost::SetPlant(0);
+    if (p.turn)
+    {
+        *error = fabs(-robot.heading*180.0/M_PI - p.amount);
+    } else
+    {
+        *error = fabs((robot.leftTravel + robot.rightTravel)/2.0 - p.amount);
+    }
+    return t;
+}
+
+int main()
+{
+    int n = sizeof(course)/sizeof(course[0]);
+    int i;
+    float err;
+    double planned[2] = {0, 0}, total[3] = {0, 0, 0}, errors[3] = {0, 0, 0};
+    MotionProfile profile;
+    DriveGains gains;
+    DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W);
+
+    gains = drive.gains;
+    for (i = 0; i < n; i++)
+    {
+        float distance = course[i].turn ? M_PI*W2W*course[i].amount/360.0 : course[i].amount;
+        profile.Plan(distance, course[i].speed/gains.kv, gains.accel, false);
+        planned[0] += profile.Duration() + REST;
+        profile.Plan(distance, course[i].speed/gains.kv, gains.accel, true);
+        planned[1] += profile.Duration() + REST;
+
+        total[0] += execute(course[i], false, false, &err);
+        errors[0] += err;
+        total[1] += execute(course[i], true, false, &err);
+        errors[1] += err;
+        total[2] += execute(course[i], true, true, &err);
+        errors[2] += err;
+    }
+
+    printf("%d primitives in the main() course sequence\n", n);
+    printf("planned profile time:  trapezoid %.2f s, s-curve %.2f s\n", planned[0], planned[1]);
+    printf("%-22s %10s %14s\n", "executed", "time(s)", "sum |error|");
+    printf("%-22s %10.2f %14.2f\n", "open-loop + 0.1s rest", total[0], errors[0]);
+    printf("%-22s %10.2f %14.2f\n", "trapezoid", total[1], errors[1]);
+    printf("%-22s %10.2f %14.2f\n", "s-curve", total[2], errors[2]);
+    return 0;
+}
@@ -0,0 +1,124 @@
+//Compares running move sequences one primitive at a time (stop and rest after each) against the blended MotionQueue
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include <math.h>
+#include "FEHHost.h"
+#include "DiffDrive.h"
+#include "MotionQueue.h"
+#include "RobotConfig.h"
+
+#define REST 0.02
+
+FEHMotor leftMotor(FEHMotor::Motor3,9);
+FEHMotor rightMotor(FEHMotor::Motor2,9);
+DigitalEncoder leftEncoder(FEHIO::P0_0);
+DigitalEncoder rightEncoder(FEHIO::P0_1);
+
+struct Step
+{
+    bool turn;
+    float amount;
+    float speed;
+};
+
+struct Sequence
+{
+    const char *name;
+    int count;
+    Step steps[8];
+};
+
+const Sequence sequences[] =
+{
+    {"jukebox red exit", 3, {{false, -6, MOVE}, {true, -90, TURN}, {false, -6, MOVE}}},
+    {"jukebox blue exit", 3, {{false, -6, MOVE}, {true, -90, TURN}, {false, -8, MOVE}}},
+    {"tray ramp", 6, {{false, 2, 0.65*MOVE}, {false, 8, MOVE}, {true, 45, TURN}, {false, 22, 1.5*MOVE}, {false, 9, MOVE}, {true, -90, 0.75*TURN}}},
+    {"ticket approach", 4, {{false, 13, MOVE}, {true, 45, TURN}, {false, 8, MOVE}, {true, 90, TURN}}},
+    {"square", 7, {{false, 12, MOVE}, {true, 90, TURN}, {false, 12, MOVE}, {true, 90, TURN}, {false, 12, MOVE}, {true, 90, TURN}, {false, 12, MOVE}}}
+};
+
+//Where an exact execution of the sequence ends up, heading positive counter-clockwise like DiffDrive
+void ideal(const Sequence &seq, double *x, double *y, double *h)
+{
+    int i;
+    *x = *y = *h = 0;
+    for (i = 0; i < seq.count; i++)
+    {
+        if (seq.steps[i].turn)
+        {
+            *h -= seq.steps[i].amount*M_PI/180.0;
+        } else
+        {
+            *x += seq.steps[i].amount*cos(*h);
+            *y += seq.steps[i].amount*sin(*h);
+        }
+    }
+}
+
+double run(const Sequence &seq, bool queued, double *posErr, double *headErr)
+{
+    DiffDrive robot;
+    DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W);
+    MotionQueue motion(drive);
+    double t, x, y, h;
+    int i;
+
+    FEHHost::Reset();
+    FEHHost::SetPlant(&robot);
+    for (i = 0; i < seq.count; i++)
+    {
+        const Step &s = seq.steps[i];
+        if (queued)
+        {
+            if (s.turn)
+            {
+                motion.Pivot(s.amount, s.speed);
+            } else
+            {
+                motion.Line(s.amount, s.speed);
+            }
+        } else
+        {
+            if (s.turn)
+            {
+                drive.Turn(s.amount, s.speed);
+            } else
+            {
+                drive.Drive(s.amount, s.speed);
+            }
+            Sleep(REST);
+        }
+    }
+    if (queued)
+    {
+        motion.Run();
+        Sleep(REST);
+    }
+    t = TimeNow();
+    Sleep(1.0);
+    FEHHost::SetPlant(0);
+
+    ideal(seq, &x, &y, &h);
+    *posErr = sqrt((robot.x - x)*(robot.x - x) + (robot.y - y)*(robot.y - y));
+    *headErr = fabs(remainder(robot.heading - h, 2*M_PI))*180.0/M_PI;
+    return t;
+}
+
+int main()
+{
+    int n = sizeof(sequences)/sizeof(sequences[0]);
+    int i;
+    double tStep, tQueue, pStep, pQueue, hStep, hQueue;
+
+    printf("%-18s %10s %10s %8s %14s %14s\n", "sequence", "stepped(s)", "queued(s)", "saved", "end err (in)", "heading (deg)");
+    for (i = 0; i < n; i++)
+    {
+        tStep = run(sequences[i], false, &pStep, &hStep);
+        tQueue = run(sequences[i], true, &pQueue, &hQueue);
+        printf("%-18s %10.2f %10.2f %7.0f%% %6.2f/%-7.2f %6.1f/%-7.1f\n", sequences[i].name, tStep, tQueue,
+               100.0*(tStep - tQueue)/tStep, pStep, pQueue, hStep, hQueue);
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+//Finding the jukebox light: stepping forward 0.1 inch at a time with a rest and a color check after each
+//step, the way jukebox() did, against one slow DriveUntil drive that checks the CdS cell every UNTIL_PERIOD.
+//Both use the closed-loop drive and the burst ColorSensor, only the search changes. The light is a 1 inch
+//spot at several distances ahead of the CdS cell
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include "FEHHost.h"
+#include "DiffDrive.h"
+#include "DriveUntil.h"
+#include "ColorSensor.h"
+#include "RobotConfig.h"
+
+#define REST 0.02
+#define SCAN 20
+#define SCAN_LIMIT 6
+#define SPOT 1.0
+
+FEHMotor leftMotor(FEHMotor::Motor3,9);
+FEHMotor rightMotor(FEHMotor::Motor2,9);
+DigitalEncoder leftEncoder(FEHIO::P0_0);
+DigitalEncoder rightEncoder(FEHIO::P0_1);
+AnalogInputPin CdS(FEHIO::P0_2);
+DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W);
+Scheduler scheduler;
+DriveUntil until(scheduler, drive);
+ColorSensor cdsSensor(CdS);
+DiffDrive *robot;
+
+//Red spot starting ahead of where the robot starts
+class Spot : public FEHHost::Sensor
+{
+public:
+    float Value(double t)
+    {
+        return (robot->x >= start && robot->x <= start + SPOT) ? 0.5 : 2.6;
+    }
+
+    double start;
+};
+
+bool cdsLit(int unused)
+{
+    return cdsSensor.Colored(CdS.Value());
+}
+
+//Searches for the spot, returns the seconds taken and where the robot stopped past the spot's near edge
+double search(bool scan, double start, double *past)
+{
+    DiffDrive plant;
+    Spot spot;
+    double t;
+    robot = &plant;
+    spot.start = start;
+    FEHHost::Reset();
+    FEHHost::SetPlant(&plant);
+    FEHHost::AttachSensor(FEHIO::P0_2, &spot);
+    t = TimeNow();
+    if (scan)
+    {
+        until.Drive(SCAN_LIMIT, SCAN, cdsLit, 0);
+        Sleep(REST);
+    }
+    while (cdsSensor.Read().color == COLOR_NONE)
+    {
+        drive.Drive(0.1, MOVE);
+        Sleep(REST);
+    }
+    t = TimeNow() - t;
+    *past = plant.x - start;
+    FEHHost::SetPlant(0);
+    return t;
+}
+
+int main()
+{
+    double starts[] = {0.5, 1.0, 2.0, 3.0, 4.0}, t[2], past[2], sum[2] = {0, 0};
+    int i, n = sizeof(starts)/sizeof(starts[0]);
+    printf("%-10s %12s %12s %12s %12s\n", "light(in)", "steps(s)", "past(in)", "scan(s)", "past(in)");
+    for (i = 0; i < n; i++)
+    {
+        t[0] = search(false, starts[i], &past[0]);
+        t[1] = search(true, starts[i], &past[1]);
+        sum[0] += t[0];
+        sum[1] += t[1];
+        printf("%-10.1f %12.2f %12.2f %12.2f %12.2f\n", starts[i], t[0], past[0], t[1], past[1]);
+    }
+    printf("mean %.2f s stepping, %.2f s scanning\n", sum[0]/n, sum[1]/n);
+    return 0;
+}
@@ -0,0 +1,120 @@
+//Jitter, deadline misses and CPU use of the Scheduler running Robot_Design_Code's periodic tasks on a
+//simulated 100 kHz timer tick: the drive controller through a run of moves, line sensor sampling, telemetry and the
+//LCD status line. The display is run twice, once writing one line of text and once clearing the whole screen
+//every period the way the moves do, which is slow enough to push the control tasks past their deadlines
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHLCD.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include <math.h>
+#include "FEHHost.h"
+#include "DiffDrive.h"
+#include "DriveControl.h"
+#include "LineSensors.h"
+#include "Scheduler.h"
+#include "RobotConfig.h"
+
+//Resolution of the simulated tick in seconds
+#define TICK 0.00001
+#define SAMPLE_PERIOD 0.005
+#define TELEMETRY_PERIOD 0.02
+#define DISPLAY_PERIOD 0.5
+
+FEHMotor leftMotor(FEHMotor::Motor3,9);
+FEHMotor rightMotor(FEHMotor::Motor2,9);
+DigitalEncoder leftEncoder(FEHIO::P0_0);
+DigitalEncoder rightEncoder(FEHIO::P0_1);
+AnalogInputPin leftLine(FEHIO::P1_0);
+AnalogInputPin centerLine(FEHIO::P1_1);
+AnalogInputPin rightLine(FEHIO::P1_2);
+LineSensors lineSensors(leftLine, centerLine, rightLine, 1.0, 1.27, 2.68);
+DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W);
+
+LineSnapshot lastLine;
+char telemetry[64];
+bool clearScreen = false;
+
+//Hardware timer stand-in counting at 100 kHz
+double tick()
+{
+    return floor(TimeNow()/TICK)*TICK;
+}
+
+void sample()
+{
+    lastLine = lineSensors.Read();
+}
+
+//Formats a record and pays for an SD write, the card itself is left alone
+void log()
+{
+    snprintf(telemetry, sizeof(telemetry), "%.3f %d %d %d", lastLine.time, leftEncoder.Counts(), rightEncoder.Counts(), lastLine.mask);
+    FEHHost::Advance(FEHHost::COST_SD_WRITE);
+}
+
+void display()
+{
+    if (clearScreen)
+    {
+        LCD.Clear(FEHLCD::Black);
+    }
+    LCD.WriteAt(telemetry, 0, 222);
+}
+
+FunctionTask sampler(sample);
+FunctionTask logger(log);
+FunctionTask screen(display);
+
+void row(const char *name, double period, Task &task, double elapsed)
+{
+    TaskStats &s = task.stats;
+    printf("%-10s %7.0f %7ld %7ld %9.3f %9.3f %7.2f%%\n", name, 1/period, s.runs, s.misses, s.runs ? 1000*s.totalLate/s.runs : 0,
+           1000*s.worstLate, 100*s.busy/elapsed);
+}
+
+void run(bool clear)
+{
+    DiffDrive robot;
+    Scheduler scheduler(tick);
+    const float moves[] = {12, -6, 22, -12, 6};
+    int i;
+    double start, elapsed;
+
+    FEHHost::Reset();
+    FEHHost::SetPlant(&robot);
+    clearScreen = clear;
+    drive.ResetStats();
+    sampler.ResetStats();
+    logger.ResetStats();
+    screen.ResetStats();
+    scheduler.ResetStats();
+    start = FEHHost::Now();
+    scheduler.Add(sampler, SAMPLE_PERIOD);
+    scheduler.Add(logger, TELEMETRY_PERIOD);
+    scheduler.Add(screen, DISPLAY_PERIOD);
+    for (i = 0; i < 5; i++)
+    {
+        drive.StartDrive(moves[i], MOVE);
+        scheduler.Run(drive, DRIVE_PERIOD);
+        drive.StartTurn(90, MOVE);
+        scheduler.Run(drive, DRIVE_PERIOD);
+    }
+    FEHHost::SetPlant(0);
+    elapsed = FEHHost::Now() - start;
+
+    printf("\ndisplay %s, %.2f s of moves\n", clear ? "clearing the screen" : "writing one line", elapsed);
+    printf("%-10s %7s %7s %7s %9s %9s %8s\n", "task", "Hz", "runs", "misses", "late(ms)", "worst(ms)", "cpu");
+    row("drive", DRIVE_PERIOD, drive, elapsed);
+    row("sample", SAMPLE_PERIOD, sampler, elapsed);
+    row("telemetry", TELEMETRY_PERIOD, logger, elapsed);
+    row("display", DISPLAY_PERIOD, screen, elapsed);
+    printf("scheduler utilisation %.1f%%\n", 100*scheduler.Utilisation());
+}
+
+int main()
+{
+    run(false);
+    run(true);
+    return 0;
+}
@@ -0,0 +1,93 @@
+//Every servo action in Robot_Design_Code timed three ways on the course model's servos: the fixed wait the
+//code used before, the wait ServoController predicts, and when the servo really got there. A prediction that
+//comes in before the servo arrives would cut a move short, so the margin is printed too, and held is how long
+//the servo sat on its target, hold included, before the code moved on. The model's servos turn at their own
+//speed rather than the SERVO_SPEED the prediction uses, and the fork flip at LOADED_SPEED
+#include <FEHServo.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include <math.h>
+#include "FEHHost.h"
+#include "Course.h"
+#include "ServoControl.h"
+#include "RobotConfig.h"
+
+//Closer than this to the command counts as there
+#define ARRIVED 0.5
+//Degrees per second the fork turns at with the burger wheel on it, half the no-load speed, which FLIP_HOLD is sized for
+#define LOADED_SPEED 130
+
+FEHServo servo_arm(FEHServo::Servo0);
+FEHServo servo_fork(FEHServo::Servo1);
+ServoController armMove(servo_arm, SERVO_ARM_MIN, SERVO_ARM_MAX, SERVO_SPEED);
+ServoController forkMove(servo_fork, SERVO_FORK_MIN, SERVO_FORK_MAX, SERVO_SPEED);
+Course course;
+
+struct Action
+{
+    const char *name;
+    ServoController *servo;
+    int port;
+    float from, to;
+    //Sweep rate in degrees per second, 0 for a straight move
+    float rate;
+    float hold;
+    //Seconds the old code waited, 0 where it didn't wait at all
+    float before;
+    //Turning something, so the model's servo runs at LOADED_SPEED
+    bool loaded;
+};
+
+int main()
+{
+    const Action actions[] =
+    {
+        {"fork flip", &forkMove, 1, 0, 95, 0, FLIP_HOLD, 2.0, true},
+        {"fork reset", &forkMove, 1, 95, 0, 0, 0, 0, false},
+        {"arm deploy", &armMove, 0, 0, 100, 0, 0, 0, false},
+        {"arm reset", &armMove, 0, 100, 0, 0, 0, 0, false},
+        {"arm sweep", &armMove, 0, 0, 100, 90, 0, 0, false},
+    };
+    int i;
+    double start, predicted, arrived, beforeSum = 0, afterSum = 0, unloaded = course.servoSpeed;
+
+    FEHHost::SetPlant(&course);
+    printf("%-12s %9s %12s %10s %9s %7s\n", "action", "before(s)", "predicted(s)", "arrived(s)", "margin(s)", "held(s)");
+    for (i = 0; i < 5; i++)
+    {
+        const Action &a = actions[i];
+        course.servoSpeed = unloaded;
+        a.servo->Move(a.from);
+        a.servo->Wait();
+        while (fabs(course.ServoAngle(a.port) - a.from) > ARRIVED)
+        {
+            Sleep(0.001);
+        }
+        course.servoSpeed = a.loaded ? LOADED_SPEED : unloaded;
+        start = TimeNow();
+        if (a.rate > 0)
+        {
+            a.servo->Sweep(a.to, a.rate, a.hold);
+        } else
+        {
+            a.servo->Move(a.to, a.hold);
+        }
+        arrived = -1;
+        while (a.servo->Run() || arrived < 0)
+        {
+            if (arrived < 0 && fabs(course.ServoAngle(a.port) - a.to) <= ARRIVED)
+            {
+                arrived = TimeNow() - start;
+            }
+            Sleep(0.001);
+        }
+        predicted = TimeNow() - start;
+        //Only the actions the old code waited on count towards the saving
+        beforeSum += a.before;
+        afterSum += (a.before > 0) ? predicted : 0;
+        printf("%-12s %9.2f %12.2f %10.2f %9.2f %7.2f\n", a.name, a.before, predicted - a.hold, arrived, predicted - a.hold - arrived,
+               predicted - arrived);
+    }
+    printf("fixed waits %.2f s, predicted waits %.2f s\n", beforeSum, afterSum);
+    return 0;
+}
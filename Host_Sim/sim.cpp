@@ -0,0 +1,230 @@
+//Runs Robot_Design_Code's main() on the course model faster than real time and reports how long each task took.
+//Usage: course_sim [-m map] [-l lever] [-j jukebox light] [-t seconds] [-v]
+//  -m  course map to load (default course.map, see Course.h for the format)
+//  -l  ice cream lever RPS reports, 0-2 (default 0)
+//  -j  name of the jukebox light that is lit (default red)
+//  -t  virtual seconds before the run is cut off (default 240)
+//  -v  print the robot's pose at the start of every task and every call a task makes, plus the LCD
+//main() is compiled as robot_main() with -finstrument-functions, which is how the functions it calls are timed
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <dlfcn.h>
+#include <cxxabi.h>
+#include "FEHHost.h"
+#include "Course.h"
+
+//Most different functions the report can keep apart
+#define TASK_MAX 64
+
+int robot_main();
+
+struct Task
+{
+    void *fn;
+    char name[48];
+    int calls;
+    double first, total;
+};
+
+static Course course;
+static Task tasks[TASK_MAX];
+static int taskCount = 0;
+//Call depth below robot_main(), -1 until it starts
+static int depth = -1;
+static Task *current = 0;
+static double started = 0;
+static bool verbose = false;
+//Last function the pose trace printed, so polling loops only show up once
+static void *shown = 0;
+
+extern "C"
+{
+    void __cyg_profile_func_enter(void *fn, void *site) __attribute__((no_instrument_function));
+    void __cyg_profile_func_exit(void *fn, void *site) __attribute__((no_instrument_function));
+}
+
+//Function name without the argument list, looked up the first time a function is seen
+static void __attribute__((no_instrument_function)) Name(void *fn, char *name, int size)
+{
+    Dl_info info;
+    char *plain = 0;
+    int status;
+    if (dladdr(fn, &info) && info.dli_sname)
+    {
+        plain = abi::__cxa_demangle(info.dli_sname, 0, 0, &status);
+        snprintf(name, size, "%s", plain ? plain : info.dli_sname);
+        free(plain);
+    } else
+    {
+        snprintf(name, size, "%p", fn);
+    }
+}
+
+static Task * __attribute__((no_instrument_function)) Find(void *fn)
+{
+    int i;
+    for (i = 0; i < taskCount; i++)
+    {
+        if (tasks[i].fn == fn)
+        {
+            return &tasks[i];
+        }
+    }
+    if (taskCount == TASK_MAX)
+    {
+        return 0;
+    }
+    Task *t = &tasks[taskCount++];
+    t->fn = fn;
+    Name(fn, t->name, sizeof(t->name));
+    t->calls = 0;
+    t->first = FEHHost::Now();
+    t->total = 0;
+    return t;
+}
+
+static void __attribute__((no_instrument_function)) Pose(void *fn)
+{
+    char name[48];
+    Name(fn, name, sizeof(name));
+    printf("[%9.4f] %*s%-24s x %6.2f y %6.2f heading %6.1f\n", FEHHost::Now(), 2*depth, "", name, course.x, course.y,
+           fmod(course.heading*180.0/M_PI + 720.0, 360.0));
+}
+
+void __cyg_profile_func_enter(void *fn, void *site)
+{
+    if (fn == (void *)robot_main)
+    {
+        depth = 0;
+        return;
+    }
+    if (depth < 0)
+    {
+        return;
+    }
+    depth++;
+    //Only the calls main() makes itself are tasks, everything below them is part of the task
+    if (depth == 1)
+    {
+        current = Find(fn);
+        started = FEHHost::Now();
+    }
+    if (verbose && depth <= 2 && fn != shown)
+    {
+        Pose(fn);
+        shown = fn;
+    }
+}
+
+void __cyg_profile_func_exit(void *fn, void *site)
+{
+    if (depth < 0 || fn == (void *)robot_main)
+    {
+        return;
+    }
+    if (depth == 1 && current)
+    {
+        current->calls++;
+        current->total += FEHHost::Now() - started;
+        current = 0;
+    }
+    depth--;
+}
+
+//Unwinds robot_main() when the run is cut off
+struct TimeUp
+{
+};
+
+static void __attribute__((no_instrument_function)) Stop()
+{
+    throw TimeUp();
+}
+
+int main(int argc, char **argv)
+{
+    const char *map = "course.map";
+    double limit = 240, end, light;
+    bool finished = true;
+    clock_t wall;
+    int i;
+
+    strcpy(course.jukebox, "red");
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            map = argv[++i];
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+        {
+            course.lever = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            snprintf(course.jukebox, sizeof(course.jukebox), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            limit = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-v") == 0)
+        {
+            verbose = true;
+            setenv("FEHHOST_LCD", "1", 1);
+        } else
+        {
+            fprintf(stderr, "usage: %s [-m map] [-l lever] [-j jukebox light] [-t seconds] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!course.Load(map))
+    {
+        return 1;
+    }
+
+    FEHHost::Reset();
+    FEHHost::SetPlant(&course);
+    FEHHost::SetTimeLimit(limit);
+    FEHHost::SetTimeLimitHandler(Stop);
+    //Touching the middle of the screen to start the run before the start light comes on
+    FEHHost::QueueTouch(0.3, 0.1, 160, 120);
+    wall = clock();
+    try
+    {
+        robot_main();
+    } catch (TimeUp &)
+    {
+        finished = false;
+        //The task that was running never returned, charge it up to the cut off
+        if (current)
+        {
+            current->calls++;
+            current->total += FEHHost::Now() - started;
+        }
+    }
+    //Static destructors run after this, keep them out of the trace
+    depth = -1;
+    end = FEHHost::Now();
+    light = course.StartTime();
+
+    printf("\n%-28s %6s %9s %9s\n", "task", "calls", "start(s)", "time(s)");
+    for (i = 0; i < taskCount; i++)
+    {
+        printf("%-28s %6d %9.2f %9.2f\n", tasks[i].name, tasks[i].calls, tasks[i].first - light, tasks[i].total);
+    }
+    printf("\n%-28s %9s\n", "objective", "time(s)");
+    for (i = 0; i < course.GoalCount(); i++)
+    {
+        if (course.GoalTime(i) >= 0)
+        {
+            printf("%-28s %9.2f\n", course.GoalName(i), course.GoalTime(i) - light);
+        } else
+        {
+            printf("%-28s %9s\n", course.GoalName(i), "missed");
+        }
+    }
+    printf("\nrobot ended at x %.2f y %.2f heading %.1f\n", course.x, course.y, fmod(course.heading*180.0/M_PI + 720.0, 360.0));
+    printf("course time %.2f s from the start light%s\n", end - light, finished ? "" : ", cut off before main() returned");
+    printf("%.1f virtual seconds in %.2f s of CPU time\n", end, (double)(clock() - wall)/CLOCKS_PER_SEC);
+    return finished ? 0 : 1;
+}
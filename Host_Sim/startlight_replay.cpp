@@ -0,0 +1,119 @@
+//Replays recorded CdS traces through the start light detector and through the original cdsColor() polling loop,
+//and reports when each one started the run against when the light really came on.
+//Usage: startlight_replay [trace onset]...
+//  trace  file of "time value" lines, seconds and volts, as logged from CdS.Value()
+//  onset  second the start light came on in that trace, -1 if it never does
+//With no arguments the traces in traces/ are replayed. They are synthetic, shaped after what the CdS cell
+//reads on the course: a clean start, 120 Hz room light flicker with noise, single-sample glitches well
+//before the start, a shadow passing over the robot while the room slowly darkens, and a dim start light
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "FEHHost.h"
+#include "Baseline.h"
+#include "StartLight.h"
+
+#define START_DELTA 0.8
+#define START_CEILING 1.1
+//Virtual seconds each trace is replayed for, the last sample is held past the end of the file
+#define REPLAY_LENGTH 6.0
+
+AnalogInputPin CdS(FEHIO::P0_2);
+StartLight startLight(CdS, START_DELTA, START_CEILING);
+
+//Stops a wait that never ends at the end of the trace
+struct TraceOver
+{
+};
+
+void stop()
+{
+    throw TraceOver();
+}
+
+//Runs one detector over the trace, returns when it started the run or -1 if it never did
+double replay(FEHHost::TraceSensor &trace, bool original)
+{
+    FEHHost::Reset();
+    FEHHost::AttachSensor(FEHIO::P0_2, &trace);
+    FEHHost::SetTimeLimit(REPLAY_LENGTH);
+    FEHHost::SetTimeLimitHandler(stop);
+    try
+    {
+        if (original)
+        {
+            while (Baseline::cdsColor(CdS) != Baseline::CDSRED)
+            {
+            }
+        } else
+        {
+            startLight.Wait();
+        }
+    } catch (TraceOver &)
+    {
+        return -1;
+    }
+    return TimeNow();
+}
+
+//Describes a start time against the real onset
+void verdict(double t, double onset, char *text, int size)
+{
+    if (t < 0)
+    {
+        snprintf(text, size, onset < 0 ? "ok, no start" : "MISSED");
+    } else if (onset < 0 || t < onset)
+    {
+        snprintf(text, size, "FALSE START %.3f", t);
+    } else
+    {
+        snprintf(text, size, "%.1f ms", 1000*(t - onset));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *defaults[] = {"traces/clean.txt", "2.0", "traces/flicker.txt", "2.0", "traces/glitch.txt", "2.0",
+                              "traces/shadow.txt", "3.0", "traces/dim.txt", "2.0"};
+    const char **args = (const char **)argv + 1;
+    int count = argc - 1, i, failures = 0;
+    double onset, oldStart, newStart;
+    char oldText[32], newText[32];
+    FEHHost::TraceSensor trace;
+
+    if (count == 0)
+    {
+        args = defaults;
+        count = sizeof(defaults)/sizeof(defaults[0]);
+    }
+    if (count % 2 != 0)
+    {
+        fprintf(stderr, "usage: %s [trace onset]...\n", argv[0]);
+        return 2;
+    }
+
+    printf("%-20s %7s %-20s %-20s %10s\n", "trace", "onset", "cdsColor() loop", "StartLight", "reaction");
+    for (i = 0; i < count; i += 2)
+    {
+        if (!trace.Load(args[i]))
+        {
+            fprintf(stderr, "can't read %s\n", args[i]);
+            return 1;
+        }
+        onset = atof(args[i + 1]);
+        oldStart = replay(trace, true);
+        newStart = replay(trace, false);
+        verdict(oldStart, onset, oldText, sizeof(oldText));
+        verdict(newStart, onset, newText, sizeof(newText));
+        printf("%-20s %7.3f %-20s %-20s %7.1f ms\n", args[i], onset, oldText, newText, 1000*startLight.Reaction());
+        //Anything but a start within the detector's bound after the onset, or no start without a light, fails
+        if ((onset < 0) ? newStart >= 0 : (newStart < onset || newStart - onset > (startLight.confirm + 1)*START_PERIOD + 0.001))
+        {
+            failures++;
+        }
+    }
+    FEHHost::SetTimeLimit(0);
+    printf("%d of %d traces outside the %.0f ms bound\n", failures, count/2, 1000*(startLight.confirm + 1)*START_PERIOD);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,145 @@
+//What logging the robot at the drive loop's rate costs the drive loop. The drive controller runs a series of moves
+//on the bench plant three ways: logging nothing, formatting each sample as text and writing it to the SD card as it
+//is taken the way RPMenu() logs RPS, and with Robot_Design_Code's Telemetry packing samples into its RAM ring and
+//writing them out in the gaps between the drive loop's periods. The moves are run once with a short stop after each and once back
+//to back, where each move's drive loop lines up with the recorder's periods and leaves it no gap, so the ring has to
+//hold everything until the TELEMETRY_HIGH_WATER mark forces lines out. early is the records written during the run rather than
+//by Close() after it, forced the lines written past the mark, write is the time spent writing them all
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHSD.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include "FEHHost.h"
+#include "DiffDrive.h"
+#include "DriveControl.h"
+#include "Scheduler.h"
+#include "Telemetry.h"
+#include "TelemetryLog.h"
+#include "RobotConfig.h"
+
+//Seconds stopped after each move, the REST of the course code
+#define STOP 0.02
+//Written where Robot_Design_Code won't pick them up in course_sim
+#define TEXT_FILE "telemetry_bench.txt"
+#define RING_FILE "telemetry_bench_ring.txt"
+
+FEHMotor leftMotor(FEHMotor::Motor3,9);
+FEHMotor rightMotor(FEHMotor::Motor2,9);
+DigitalEncoder leftEncoder(FEHIO::P0_0);
+DigitalEncoder rightEncoder(FEHIO::P0_1);
+AnalogInputPin cds(FEHIO::P0_2);
+AnalogInputPin leftLine(FEHIO::P1_0);
+AnalogInputPin centerLine(FEHIO::P1_1);
+AnalogInputPin rightLine(FEHIO::P1_2);
+DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W);
+Scheduler scheduler;
+FEHFile *textFile;
+
+void sample(TelemetrySample *s)
+{
+    s->leftCounts = leftEncoder.Counts();
+    s->rightCounts = rightEncoder.Counts();
+    s->leftPower = drive.LeftPower();
+    s->rightPower = drive.RightPower();
+    s->cds = cds.Value();
+    s->left = leftLine.Value();
+    s->center = centerLine.Value();
+    s->right = rightLine.Value();
+    s->x = s->y = s->heading = -1;
+    s->battery = 11.5;
+    s->flags = 0;
+}
+
+Telemetry telemetry(scheduler, sample);
+static TelemetryLog telemetryLog;
+
+//Every field of a record as text, written as soon as it's taken
+void logText()
+{
+    TelemetrySample s;
+    sample(&s);
+    SD.FPrintf(textFile, "%.3f %d %d %.0f %.0f %.3f %.3f %.3f %.3f %.2f %.2f %.1f %.3f\n", TimeNow(), s.leftCounts, s.rightCounts,
+               s.leftPower, s.rightPower, s.cds, s.left, s.center, s.right, s.x, s.y, s.heading, s.battery);
+}
+
+FunctionTask textLog(logText);
+
+//How each run went: 0 logs nothing, 1 logs text, 2 logs to the ring
+void run(int mode, bool stops)
+{
+    const char *names[] = {"none", "text", "ring"};
+    DiffDrive robot;
+    const float moves[] = {12, -6, 22, -12, 6};
+    char path[512];
+    double start, elapsed, close = 0;
+    long early = 0;
+    int i;
+
+    FEHHost::Reset();
+    FEHHost::SetPlant(&robot);
+    if (mode == 1)
+    {
+        textFile = SD.FOpen(TEXT_FILE, "w");
+        scheduler.Add(textLog, TELEMETRY_PERIOD);
+    } else if (mode == 2)
+    {
+        telemetry.Open(RING_FILE);
+        scheduler.Add(telemetry, TELEMETRY_PERIOD);
+        scheduler.Add(telemetry.writer, TELEMETRY_WRITE_PERIOD);
+    }
+    drive.ResetStats();
+    scheduler.ResetStats();
+    start = FEHHost::Now();
+    for (i = 0; i < 5; i++)
+    {
+        drive.StartDrive(moves[i], MOVE);
+        scheduler.Run(drive, DRIVE_PERIOD);
+        scheduler.Pause(stops ? STOP : 0);
+        drive.StartTurn(90, MOVE);
+        scheduler.Run(drive, DRIVE_PERIOD);
+        scheduler.Pause(stops ? STOP : 0);
+    }
+    elapsed = FEHHost::Now() - start;
+    scheduler.Remove(textLog);
+    scheduler.Remove(telemetry);
+    scheduler.Remove(telemetry.writer);
+    if (mode == 1)
+    {
+        SD.FClose(textFile);
+    } else if (mode == 2)
+    {
+        early = telemetry.written;
+        close = FEHHost::Now();
+        telemetry.Close();
+        close = FEHHost::Now() - close;
+    }
+    FEHHost::SetPlant(0);
+
+    printf("%-5s %-6s %7.2f %7ld %9.3f %9.3f", names[mode], stops ? "yes" : "no", elapsed, drive.stats.misses,
+           1000*drive.stats.totalLate/drive.stats.runs, 1000*drive.stats.worstLate);
+    if (mode == 2)
+    {
+        snprintf(path, sizeof(path), "%s/%s", FEHHost::SDFolder(), RING_FILE);
+        telemetryLog.Load(path, stderr);
+        printf(" %7ld %7ld %7ld %7ld %9.1f %9.1f %7d", telemetry.recorded, telemetry.dropped, early, telemetry.forced,
+               1000*telemetry.writeTime, 1000*close, telemetryLog.count);
+    }
+    printf("\n");
+}
+
+int main()
+{
+    int mode;
+    printf("%-5s %-6s %7s %7s %9s %9s %7s %7s %7s %7s %9s %9s %7s\n", "log", "stops", "run(s)", "misses", "late(ms)", "worst(ms)",
+           "records", "dropped", "early", "forced", "write(ms)", "close(ms)", "decoded");
+    for (mode = 0; mode < 3; mode++)
+    {
+        run(mode, true);
+    }
+    for (mode = 0; mode < 3; mode++)
+    {
+        run(mode, false);
+    }
+    return 0;
+}
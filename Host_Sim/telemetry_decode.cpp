@@ -0,0 +1,38 @@
+//Turns a telemetry log from Robot_Design_Code's SD card into CSV, one row per record with the header naming each column.
+//Usage: telemetry_decode telemetry.txt [telemetry.csv]
+//The CSV goes to standard output without a second file. How many records the robot took, dropped and wrote is printed
+//to standard error, with any line of the log that couldn't be read
+#include <stdio.h>
+#include "TelemetryLog.h"
+
+//Too big to go on the stack
+static TelemetryLog telemetryLog;
+
+int main(int argc, char **argv)
+{
+    FILE *out = stdout;
+    bool ok;
+    if (argc != 2 && argc != 3)
+    {
+        fprintf(stderr, "usage: %s telemetry.txt [telemetry.csv]\n", argv[0]);
+        return 2;
+    }
+    if (!telemetryLog.Load(argv[1], stderr))
+    {
+        return 1;
+    }
+    if (argc == 3 && !(out = fopen(argv[2], "w")))
+    {
+        fprintf(stderr, "%s: can't write\n", argv[2]);
+        return 1;
+    }
+    ok = telemetryLog.WriteCSV(out);
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    fprintf(stderr, "%s: %d records over %.2f s, %ld taken, %ld dropped%s\n", argv[1], telemetryLog.count,
+            telemetryLog.count ? telemetryLog.samples[telemetryLog.count - 1].time : 0.0, telemetryLog.recorded, telemetryLog.dropped,
+            telemetryLog.ended ? "" : ", cut off before the end");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,591 @@
+//Looks over a run from its telemetry log, fast enough to use between table runs.
+//Usage: telemetry_replay [-m course.map] telemetry.txt [run.svg]
+//The log's encoder counts, motor powers and RPS fixes are played back through Robot_Design_Code's PoseEstimator
+//to get the path the robot thought it took, using kinematics.txt from the SD card folder if there is one. Printed:
+//the time spent on each course task, then everything worth a look in time order. Those are stalls (the drive
+//giving up on a move, and the wheels pinned under power anywhere else), slow moves, long stops and sensor
+//misreads (RPS dropouts and fixes the estimator threw out, single-sample spikes on the CdS cell and
+//optosensors, and microswitch bounces). With an SVG file the path is drawn on the course map, colored by task,
+//with RPS fixes as gray dots and a marker on every flagged event
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "FEHHost.h"
+#include "Course.h"
+#include "TelemetryLog.h"
+#include "PoseEstimator.h"
+#include "Kinematics.h"
+#include "Stall.h"
+#include "Mission.h"
+#include "RobotConfig.h"
+
+#define KINEMATICS_FILE "kinematics.txt"
+#define MAP_FILE "course.map"
+//Percent power per inch per second, DriveController's gains.kv
+#define KV 7.1
+//A move is slow when the wheels cover less than SLOW_FRACTION of what its power should give, over SLOW_MIN seconds or more
+#define SLOW_FRACTION 0.5
+#define SLOW_MIN 0.3
+//Stops at least this many seconds long are listed
+#define STOP_LONG 0.75
+//RPS going this many seconds without a fix is a dropout
+#define RPS_GAP 0.5
+//Seconds within which thrown out RPS fixes count as the same event
+#define RPS_REJECT_MERGE 0.5
+//Seconds within which the drive giving up on moves counts as the same stall, the recovery retrying
+#define STALL_MERGE 1.0
+//An analog reading this many volts from both neighbours, when they agree within SPIKE_AGREE, is a misread
+#define SPIKE 1.0
+#define SPIKE_AGREE 0.2
+//Most events listed and drawn
+#define EVENT_MAX 256
+//SVG pixels per inch and margin around the course in pixels
+#define SVG_SCALE 10
+#define SVG_MARGIN 20
+
+//Kinds of event
+#define EVENT_STALL 0
+#define EVENT_PINNED 1
+#define EVENT_SLOW 2
+#define EVENT_STOP 3
+#define EVENT_MISREAD 4
+
+struct Event
+{
+    double start, end;
+    int kind, count;
+    //Where the robot was when it started
+    float x, y;
+    char text[64];
+};
+
+//Plays the current record back as the robot's encoders and RPS
+class ReplayPlant : public FEHHost::Plant
+{
+public:
+    int EncoderCounts(int pin)
+    {
+        return (pin == FEHIO::P0_0) ? sample->leftCounts : sample->rightCounts;
+    }
+
+    bool RPSPose(float *x, float *y, float *heading)
+    {
+        *x = sample->x;
+        *y = sample->y;
+        *heading = sample->heading;
+        return (sample->flags & TELEMETRY_RPS) != 0;
+    }
+
+    const TelemetrySample *sample;
+};
+
+//Too big to go on the stack
+static TelemetryLog telemetryLog;
+static Pose path[TELEMETRY_LOG_MAX];
+static Event events[EVENT_MAX];
+static int eventCount;
+static long eventsLost;
+
+static ReplayPlant plant;
+static Course course;
+DigitalEncoder leftEncoder(FEHIO::P0_0);
+DigitalEncoder rightEncoder(FEHIO::P0_1);
+
+void powers(float *left, float *right)
+{
+    *left = plant.sample->leftPower;
+    *right = plant.sample->rightPower;
+}
+
+static const char *const taskNames[] = MISSION_TASK_NAMES;
+static const char *const taskColors[] = {"#1f77b4", "#ff7f0e", "#2ca02c", "#9467bd", "#d62728", "#8c564b"};
+static const char *const eventNames[] = {"stall", "pinned", "slow", "stop", "misread"};
+
+const char *taskName(int state)
+{
+    return (state >= 0 && state < TASK_COUNT) ? taskNames[state] : "unknown";
+}
+
+Event *addEvent(int kind, double start, double end, int record)
+{
+    Event *e;
+    if (eventCount == EVENT_MAX)
+    {
+        eventsLost++;
+        return 0;
+    }
+    e = &events[eventCount++];
+    e->kind = kind;
+    e->start = start;
+    e->end = end;
+    e->count = 1;
+    e->x = path[record].x;
+    e->y = path[record].y;
+    e->text[0] = 0;
+    return e;
+}
+
+int byTime(const void *a, const void *b)
+{
+    double d = ((const Event *)a)->start - ((const Event *)b)->start;
+    return (d < 0) ? -1 : (d > 0) ? 1 : 0;
+}
+
+//Index of the record at or just before time
+int recordAt(double t)
+{
+    int low = 0, high = telemetryLog.count - 1, mid;
+    while (low < high)
+    {
+        mid = (low + high + 1)/2;
+        if (telemetryLog.samples[mid].time <= t)
+        {
+            low = mid;
+        } else
+        {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
+
+//Plays the log through the pose estimator, filling in path. Returns the RPS fixes it used
+long reconstruct(Kinematics &kinematics)
+{
+    PoseEstimator estimate(leftEncoder, rightEncoder, kinematics.CountsPerInch(), kinematics.track, powers);
+    long rejected = 0;
+    double rejectAt = -1;
+    int i;
+    FEHHost::Reset();
+    FEHHost::SetTimeLimit(0);
+    FEHHost::SetPlant(&plant);
+    plant.sample = &telemetryLog.samples[0];
+    if (!estimate.SetFromRPS())
+    {
+        //Where the map puts the robot at the start
+        estimate.Set(course.x, course.y, course.heading*180.0/M_PI);
+    }
+    for (i = 0; i < telemetryLog.count; i++)
+    {
+        plant.sample = &telemetryLog.samples[i];
+        estimate.Run();
+        path[i] = estimate.pose;
+        //A fix far enough from the estimate to be thrown out
+        if (estimate.rejected > rejected)
+        {
+            rejected = estimate.rejected;
+            if (rejectAt < 0 || plant.sample->time - rejectAt > RPS_REJECT_MERGE)
+            {
+                Event *e = addEvent(EVENT_MISREAD, plant.sample->time, plant.sample->time, i);
+                if (e)
+                {
+                    snprintf(e->text, sizeof(e->text), "RPS fix %.1f in from the estimate thrown out",
+                             hypot(plant.sample->x - estimate.pose.x, plant.sample->y - estimate.pose.y));
+                }
+            }
+            rejectAt = plant.sample->time;
+        }
+    }
+    FEHHost::SetPlant(0);
+    return estimate.fixes;
+}
+
+//Time on each task, and how much of it went unlogged because the ring was full
+void taskTimes(double *time, double *unlogged, int *visits)
+{
+    int i, state, last = -1;
+    double dt;
+    for (i = 0; i < telemetryLog.count; i++)
+    {
+        state = telemetryLog.samples[i].state;
+        if (state < 0 || state >= TASK_COUNT)
+        {
+            continue;
+        }
+        dt = (i + 1 < telemetryLog.count) ? telemetryLog.samples[i + 1].time - telemetryLog.samples[i].time : telemetryLog.period;
+        time[state] += dt;
+        if (dt > 1.5*telemetryLog.period)
+        {
+            unlogged[state] += dt - telemetryLog.period;
+        }
+        visits[state] += (state != last);
+        last = state;
+    }
+}
+
+//True if the drive gave up on a move while the wheels were pinned, looking at the events from first on
+bool duringStall(const Event &pinned, int first, double window)
+{
+    int i;
+    for (i = first; i < eventCount; i++)
+    {
+        if (events[i].kind == EVENT_STALL && events[i].end >= pinned.start && events[i].start <= pinned.end + window)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//Stalls the drive gave up on, and anywhere else the wheels were pinned under power
+void findStalls()
+{
+    StallDetector detector;
+    Event *pinned = 0, *stall = 0;
+    long left = 0, right = 0;
+    int i, j, first = eventCount, lastLeft = 0, lastRight = 0;
+    bool stalled = false;
+    FEHHost::Reset();
+    FEHHost::SetTimeLimit(0);
+    for (i = 0; i < telemetryLog.count; i++)
+    {
+        const TelemetrySample &s = telemetryLog.samples[i];
+        FEHHost::Advance(s.time - FEHHost::Now());
+        //Moves reset the counts when they start, the detector needs them to keep counting up
+        left += (s.leftCounts >= lastLeft) ? s.leftCounts - lastLeft : s.leftCounts;
+        right += (s.rightCounts >= lastRight) ? s.rightCounts - lastRight : s.rightCounts;
+        lastLeft = s.leftCounts;
+        lastRight = s.rightCounts;
+        if ((s.flags & TELEMETRY_STALLED) && !stalled)
+        {
+            if (stall && s.time - stall->end <= STALL_MERGE)
+            {
+                stall->end = s.time;
+                stall->count++;
+            } else
+            {
+                stall = addEvent(EVENT_STALL, s.time, s.time, i);
+            }
+            if (stall)
+            {
+                snprintf(stall->text, sizeof(stall->text), "drive gave up on %d move%s during %s", stall->count,
+                         (stall->count > 1) ? "s" : "", taskName(s.state));
+            }
+        }
+        stalled = (s.flags & TELEMETRY_STALLED) != 0;
+        if (detector.Check(s.leftPower, s.rightPower, left, right))
+        {
+            if (pinned && s.time - pinned->end <= 1.5*detector.window)
+            {
+                pinned->end = s.time;
+            } else
+            {
+                pinned = addEvent(EVENT_PINNED, s.time - detector.window, s.time, recordAt(s.time - detector.window));
+            }
+            if (pinned)
+            {
+                snprintf(pinned->text, sizeof(pinned->text), "wheels pinned at %.0f%%/%.0f%% power for %.2f s", s.leftPower, s.rightPower,
+                         pinned->end - pinned->start);
+            }
+        }
+    }
+    //Pinned while the drive was giving up on moves is the same stall
+    for (i = j = first; i < eventCount; i++)
+    {
+        if (events[i].kind != EVENT_PINNED || !duringStall(events[i], first, detector.window))
+        {
+            events[j++] = events[i];
+        }
+    }
+    eventCount = j;
+}
+
+//Moves that covered much less ground than their power should have, and long stops
+void findSlow(float countsPerInch)
+{
+    double start = 0, expected = 0, covered = 0, dt;
+    int i, first = 0, lastLeft = 0, lastRight = 0, left, right;
+    bool moving = false, powered;
+    for (i = 0; i <= telemetryLog.count; i++)
+    {
+        const TelemetrySample &s = telemetryLog.samples[(i < telemetryLog.count) ? i : i - 1];
+        powered = i < telemetryLog.count && (fabs(s.leftPower) >= 10 || fabs(s.rightPower) >= 10);
+        if (i == telemetryLog.count || powered != moving)
+        {
+            dt = s.time - start;
+            if (moving && dt >= SLOW_MIN && covered < SLOW_FRACTION*expected)
+            {
+                Event *e = addEvent(EVENT_SLOW, start, s.time, first);
+                if (e)
+                {
+                    snprintf(e->text, sizeof(e->text), "%.1f in of the %.1f in its power should give in %.2f s", covered, expected, dt);
+                }
+            } else if (!moving && i > 0 && dt >= STOP_LONG)
+            {
+                Event *e = addEvent(EVENT_STOP, start, s.time, first);
+                if (e)
+                {
+                    snprintf(e->text, sizeof(e->text), "stopped %.2f s during %s", dt, taskName(telemetryLog.samples[first].state));
+                }
+            }
+            moving = powered;
+            start = s.time;
+            first = i;
+            expected = covered = 0;
+        }
+        if (i == telemetryLog.count)
+        {
+            break;
+        }
+        left = (s.leftCounts >= lastLeft) ? s.leftCounts - lastLeft : s.leftCounts;
+        right = (s.rightCounts >= lastRight) ? s.rightCounts - lastRight : s.rightCounts;
+        lastLeft = s.leftCounts;
+        lastRight = s.rightCounts;
+        if (i + 1 < telemetryLog.count)
+        {
+            expected += (fabs(s.leftPower) + fabs(s.rightPower))/2/KV*(telemetryLog.samples[i + 1].time - s.time);
+        }
+        covered += (left + right)/2.0/countsPerInch;
+    }
+}
+
+//True if a reading stands out from both neighbours while they agree with each other
+bool spike(float before, float value, float after)
+{
+    return fabs(before - after) < SPIKE_AGREE && fabs(value - before) > SPIKE && fabs(value - after) > SPIKE;
+}
+
+//RPS dropouts, analog spikes and microswitch bounces
+void findMisreads()
+{
+    const char *pins[] = {"CdS", "left line", "center line", "right line"};
+    const char *switches[] = {"front left", "front right", "back left", "back right", "fork"};
+    float a[3][4];
+    double lost = -1;
+    int i, j;
+    for (i = 0; i < telemetryLog.count; i++)
+    {
+        const TelemetrySample &s = telemetryLog.samples[i];
+        if (!(s.flags & TELEMETRY_RPS) && lost < 0)
+        {
+            lost = s.time;
+        } else if (((s.flags & TELEMETRY_RPS) || i == telemetryLog.count - 1) && lost >= 0)
+        {
+            if (s.time - lost >= RPS_GAP)
+            {
+                Event *e = addEvent(EVENT_MISREAD, lost, s.time, recordAt(lost));
+                if (e)
+                {
+                    snprintf(e->text, sizeof(e->text), "no RPS for %.2f s", s.time - lost);
+                }
+            }
+            lost = -1;
+        }
+        if (i == 0 || i == telemetryLog.count - 1)
+        {
+            continue;
+        }
+        for (j = -1; j <= 1; j++)
+        {
+            const TelemetrySample &n = telemetryLog.samples[i + j];
+            a[j + 1][0] = n.cds;
+            a[j + 1][1] = n.left;
+            a[j + 1][2] = n.center;
+            a[j + 1][3] = n.right;
+        }
+        for (j = 0; j < 4; j++)
+        {
+            if (spike(a[0][j], a[1][j], a[2][j]))
+            {
+                Event *e = addEvent(EVENT_MISREAD, s.time, s.time, i);
+                if (e)
+                {
+                    snprintf(e->text, sizeof(e->text), "%s read %.2f V between %.2f and %.2f", pins[j], a[1][j], a[0][j], a[2][j]);
+                }
+            }
+        }
+        //Pressed for a single record
+        for (j = 0; j < 5; j++)
+        {
+            int bit = 1 << j;
+            if ((s.flags & bit) && !(telemetryLog.samples[i - 1].flags & bit) && !(telemetryLog.samples[i + 1].flags & bit))
+            {
+                Event *e = addEvent(EVENT_MISREAD, s.time, s.time, i);
+                if (e)
+                {
+                    snprintf(e->text, sizeof(e->text), "%s switch bounced", switches[j]);
+                }
+            }
+        }
+    }
+}
+
+//Course inches to SVG pixels, y up the course is up the picture
+double px(double x)
+{
+    return SVG_MARGIN + SVG_SCALE*x;
+}
+
+double py(double y, double height)
+{
+    return SVG_MARGIN + SVG_SCALE*(height - y);
+}
+
+bool writeSVG(const char *filename, long fixes)
+{
+    const Course::Segment *walls, *lines;
+    const Course::Spot *lights, *goals;
+    const char *markers[] = {"#d62728", "#d62728", "#ff7f0e", "#1f77b4", "#e377c2"};
+    int wallCount, lineCount, lightCount, goalCount, i, state = -1;
+    double width = 0, height = 0, lx, ly;
+    FILE *f = fopen(filename, "w");
+    if (!f)
+    {
+        return false;
+    }
+    walls = course.Walls(&wallCount);
+    lines = course.Lines(&lineCount);
+    lights = course.Lights(&lightCount);
+    goals = course.Goals(&goalCount);
+    for (i = 0; i < wallCount; i++)
+    {
+        width = fmax(width, fmax(walls[i].x1, walls[i].x2));
+        height = fmax(height, fmax(walls[i].y1, walls[i].y2));
+    }
+    fprintf(f, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%.0f\" height=\"%.0f\" font-family=\"sans-serif\" font-size=\"10\">\n",
+            2*SVG_MARGIN + SVG_SCALE*width, 3*SVG_MARGIN + SVG_SCALE*height);
+    fprintf(f, "<rect width=\"100%%\" height=\"100%%\" fill=\"white\"/>\n");
+    for (i = 0; i < lineCount; i++)
+    {
+        fprintf(f, "<line x1=\"%.1f\" y1=\"%.1f\" x2=\"%.1f\" y2=\"%.1f\" stroke=\"#bbb\" stroke-width=\"7\"/>\n", px(lines[i].x1),
+                py(lines[i].y1, height), px(lines[i].x2), py(lines[i].y2, height));
+    }
+    for (i = 0; i < wallCount; i++)
+    {
+        fprintf(f, "<line x1=\"%.1f\" y1=\"%.1f\" x2=\"%.1f\" y2=\"%.1f\" stroke=\"black\" stroke-width=\"3\"/>\n", px(walls[i].x1),
+                py(walls[i].y1, height), px(walls[i].x2), py(walls[i].y2, height));
+    }
+    for (i = 0; i < lightCount; i++)
+    {
+        fprintf(f, "<circle cx=\"%.1f\" cy=\"%.1f\" r=\"%.1f\" fill=\"%s\" fill-opacity=\"0.4\"/>\n", px(lights[i].x), py(lights[i].y, height),
+                SVG_SCALE*lights[i].r, lights[i].kind ? "blue" : "red");
+    }
+    for (i = 0; i < goalCount; i++)
+    {
+        fprintf(f, "<circle cx=\"%.1f\" cy=\"%.1f\" r=\"%.1f\" fill=\"none\" stroke=\"green\"/>\n", px(goals[i].x), py(goals[i].y, height),
+                SVG_SCALE*goals[i].r);
+        fprintf(f, "<text x=\"%.1f\" y=\"%.1f\" fill=\"green\">%s</text>\n", px(goals[i].x + goals[i].r) + 2, py(goals[i].y, height),
+                goals[i].name);
+    }
+    //RPS fixes, each one once
+    for (i = 0; i < telemetryLog.count; i++)
+    {
+        const TelemetrySample &s = telemetryLog.samples[i];
+        if ((s.flags & TELEMETRY_RPS) && (i == 0 || s.x != telemetryLog.samples[i - 1].x || s.y != telemetryLog.samples[i - 1].y))
+        {
+            fprintf(f, "<circle cx=\"%.1f\" cy=\"%.1f\" r=\"1.5\" fill=\"#999\"/>\n", px(s.x), py(s.y, height));
+        }
+    }
+    //The path, a polyline for each stretch on one task
+    for (i = 0; i < telemetryLog.count; i++)
+    {
+        if (telemetryLog.samples[i].state != state)
+        {
+            if (state >= 0)
+            {
+                fprintf(f, "%.1f,%.1f\"/>\n", px(path[i].x), py(path[i].y, height));
+            }
+            state = telemetryLog.samples[i].state;
+            fprintf(f, "<polyline fill=\"none\" stroke=\"%s\" stroke-width=\"2\" points=\"", taskColors[state % TASK_COUNT]);
+        }
+        fprintf(f, "%.1f,%.1f ", px(path[i].x), py(path[i].y, height));
+    }
+    if (state >= 0)
+    {
+        fprintf(f, "\"/>\n");
+    }
+    for (i = 0; i < eventCount; i++)
+    {
+        const Event &e = events[i];
+        fprintf(f, "<circle cx=\"%.1f\" cy=\"%.1f\" r=\"5\" fill=\"none\" stroke=\"%s\" stroke-width=\"2\"><title>%.2f s %s: %s</title></circle>\n",
+                px(e.x), py(e.y, height), markers[e.kind], e.start, eventNames[e.kind], e.text);
+    }
+    //Legend under the course
+    lx = SVG_MARGIN;
+    ly = 2*SVG_MARGIN + SVG_SCALE*height + 4;
+    for (i = 0; i < TASK_COUNT; i++)
+    {
+        fprintf(f, "<line x1=\"%.0f\" y1=\"%.0f\" x2=\"%.0f\" y2=\"%.0f\" stroke=\"%s\" stroke-width=\"3\"/>", lx, ly - 3, lx + 15, ly - 3, taskColors[i]);
+        fprintf(f, "<text x=\"%.0f\" y=\"%.0f\">%s</text>\n", lx + 18, ly, taskNames[i]);
+        lx += 75;
+    }
+    fprintf(f, "<text x=\"%.0f\" y=\"%.0f\">circles: red stall, orange slow, blue stop, pink misread; gray dots: %ld RPS fixes used</text>\n",
+            lx, ly, fixes);
+    fprintf(f, "</svg>\n");
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    Kinematics kinematics(WHEEL, W2W, COUNTS_PER_REV);
+    double time[TASK_COUNT] = {0}, unlogged[TASK_COUNT] = {0}, total = 0;
+    int visits[TASK_COUNT] = {0};
+    const char *mapFile = MAP_FILE, *svg;
+    clock_t start = clock();
+    long fixes;
+    int i, arg = 1;
+    if (argc > 2 && strcmp(argv[1], "-m") == 0)
+    {
+        mapFile = argv[2];
+        arg = 3;
+    }
+    if (argc - arg != 1 && argc - arg != 2)
+    {
+        fprintf(stderr, "usage: %s [-m course.map] telemetry.txt [run.svg]\n", argv[0]);
+        return 2;
+    }
+    svg = (argc - arg == 2) ? argv[arg + 1] : 0;
+    if (!course.Load(mapFile) || !telemetryLog.Load(argv[arg], stderr))
+    {
+        return 1;
+    }
+    if (telemetryLog.count == 0)
+    {
+        fprintf(stderr, "%s: no records\n", argv[arg]);
+        return 1;
+    }
+    kinematics.Load(KINEMATICS_FILE);
+
+    fixes = reconstruct(kinematics);
+    taskTimes(time, unlogged, visits);
+    findStalls();
+    findSlow(kinematics.CountsPerInch());
+    findMisreads();
+    qsort(events, eventCount, sizeof(Event), byTime);
+
+    printf("%s: %d records over %.2f s, %ld dropped%s, %ld RPS fixes used\n", argv[arg], telemetryLog.count,
+           telemetryLog.samples[telemetryLog.count - 1].time, telemetryLog.dropped, telemetryLog.ended ? "" : ", cut off before the end", fixes);
+    printf("ended at x %.2f y %.2f heading %.1f\n\n", path[telemetryLog.count - 1].x, path[telemetryLog.count - 1].y,
+           path[telemetryLog.count - 1].heading);
+    for (i = 0; i < TASK_COUNT; i++)
+    {
+        total += time[i];
+    }
+    printf("%-10s %6s %9s %7s %12s\n", "task", "visits", "time(s)", "share", "unlogged(s)");
+    for (i = 0; i < TASK_COUNT; i++)
+    {
+        printf("%-10s %6d %9.2f %6.1f%% %12.2f\n", taskNames[i], visits[i], time[i], total > 0 ? 100*time[i]/total : 0, unlogged[i]);
+    }
+    printf("\n%-8s %-8s %-8s %7s %7s  %s\n", "time(s)", "event", "task", "x", "y", "");
+    for (i = 0; i < eventCount; i++)
+    {
+        printf("%8.2f %-8s %-8s %7.1f %7.1f  %s\n", events[i].start, eventNames[events[i].kind],
+               taskName(telemetryLog.samples[recordAt(events[i].start)].state), events[i].x, events[i].y, events[i].text);
+    }
+    if (eventsLost)
+    {
+        printf("and %ld more\n", eventsLost);
+    }
+    if (svg && !writeSVG(svg, fixes))
+    {
+        fprintf(stderr, "%s: can't write\n", svg);
+        return 1;
+    }
+    printf("\n%d records looked over in %.1f ms\n", telemetryLog.count, 1000.0*(clock() - start)/CLOCKS_PER_SEC);
+    return 0;
+}
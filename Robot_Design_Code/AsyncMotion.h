@@ -0,0 +1,126 @@
+#ifndef ASYNCMOTION_H
+#define ASYNCMOTION_H
+
+#include "DriveControl.h"
+#include "ServoControl.h"
+#include "Scheduler.h"
+
+//A move that has been started, kept so it can be waited on
+struct Motion
+{
+    Task *task;
+    long start;
+};
+
+/*Starts drive and servo moves without waiting for them so they can overlap, each call returns a Motion to
+ wait on with Await() or AllOf(). Waiting runs the scheduler, so every move in flight keeps going until the
+ one being waited on finishes. The drive only does one move at a time, a new drive move waits for the one
+ before it first. A move the scheduler has no room for runs to the end before the call returns*/
+class AsyncMotion
+{
+public:
+    AsyncMotion(Scheduler &scheduler, DriveController &drive) : _scheduler(scheduler), _drive(drive)
+    {
+    }
+
+    //Starts a DriveController::Drive()
+    Motion Drive(float distance, float speed)
+    {
+        _scheduler.Wait(_drive);
+        _drive.StartDrive(distance, speed);
+        return Add(_drive, DRIVE_PERIOD);
+    }
+
+    //Starts a DriveController::Turn()
+    Motion Turn(float degrees, float speed)
+    {
+        _scheduler.Wait(_drive);
+        _drive.StartTurn(degrees, speed);
+        return Add(_drive, DRIVE_PERIOD);
+    }
+
+    //Starts a DriveController::Arc()
+    Motion Arc(float radius, float degrees, float speed)
+    {
+        _scheduler.Wait(_drive);
+        _drive.StartArc(radius, degrees, speed);
+        return Add(_drive, DRIVE_PERIOD);
+    }
+
+    //Starts a DriveController::Curve()
+    Motion Curve(float distance, float curvature, float speed)
+    {
+        _scheduler.Wait(_drive);
+        _drive.StartCurve(distance, curvature, speed);
+        return Add(_drive, DRIVE_PERIOD);
+    }
+
+    //Turns a servo straight to degree, the motion finishes hold seconds after the servo gets there
+    Motion Servo(ServoController &servo, float degree, float hold = 0)
+    {
+        _scheduler.Wait(servo);
+        servo.Move(degree, hold);
+        return Add(servo, SERVO_PERIOD);
+    }
+
+    //Sweeps a servo to degree at rate degrees per second, see ServoController::Sweep()
+    Motion Sweep(ServoController &servo, float degree, float rate, float hold = 0)
+    {
+        _scheduler.Wait(servo);
+        servo.Sweep(degree, rate, hold);
+        return Add(servo, SERVO_PERIOD);
+    }
+
+    //True once the move has finished, or the drive or servo has moved on to another move since
+    bool Done(Motion m)
+    {
+        return !m.task || m.task->starts != m.start || !_scheduler.Active(*m.task);
+    }
+
+    void Await(Motion m)
+    {
+        while (!Done(m))
+        {
+            _scheduler.Poll();
+        }
+    }
+
+    //Waits for every one of the moves
+    void AllOf(Motion a, Motion b)
+    {
+        Await(a);
+        Await(b);
+    }
+
+    void AllOf(Motion a, Motion b, Motion c)
+    {
+        Await(a);
+        Await(b);
+        Await(c);
+    }
+
+private:
+    /*Puts a started move on the scheduler. The move has already begun, so if the scheduler is full it is
+     stepped to the end with Scheduler::Step() rather than left running with nothing stepping it. The Motion
+     that comes back is then already done*/
+    Motion Add(Task &task, double period)
+    {
+        Motion m;
+        m.task = 0;
+        m.start = 0;
+        if (_scheduler.Add(task, period))
+        {
+            m.task = &task;
+            m.start = task.starts;
+        } else
+        {
+            _scheduler.Step(task, period);
+        }
+        return m;
+    }
+
+    Scheduler &_scheduler;
+    DriveController &_drive;
+};
+
+#endif
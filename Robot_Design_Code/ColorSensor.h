@@ -0,0 +1,217 @@
+#ifndef COLORSENSOR_H
+#define COLORSENSOR_H
+
+#include <FEHIO.h>
+#include <FEHSD.h>
+#include <FEHUtility.h>
+#include <math.h>
+
+//Colors the CdS cell can tell apart, also the rows of the calibration table
+#define COLOR_RED 0
+#define COLOR_BLUE 1
+#define COLOR_NONE 2
+#define COLOR_COUNT 3
+//Returned when the readings are outside what the cell can give, an unplugged or shorted cell
+#define COLOR_NO_READING 3
+
+//Readings taken for one classification, an odd number so the median is one of them
+#define COLOR_SAMPLES 9
+//Seconds between the readings of a burst, the burst spans a full flicker of 120 Hz room light
+#define COLOR_SAMPLE_GAP 0.001
+
+//Result of one classification
+struct ColorReading
+{
+    //COLOR_RED, COLOR_BLUE, COLOR_NONE or COLOR_NO_READING
+    int color;
+    //Median of the burst in volts
+    float volts;
+    //0 to 1, how far the median is from the edge of its color's range times the share of readings that agree with it
+    float confidence;
+};
+
+/*Classifies what color light the CdS cell sees. Each classification takes a burst of COLOR_SAMPLES readings
+ and decides once from their median, so one noisy reading can't change the answer and every caller acting
+ on the result sees the same color.
+
+ The colors are told apart by a calibration table holding the reading under each color. A reading
+ belongs to the color whose level is closest, so the edges sit halfway between neighbouring levels. The
+ table starts out as the old fixed ranges (edges at 0.9 and 1.8 V), can be captured on the robot with
+ Capture() and is kept on the SD card between runs with Save() and Load()*/
+class ColorSensor
+{
+public:
+    ColorSensor(AnalogInputPin &cds, int samples = COLOR_SAMPLES) : _cds(cds)
+    {
+        _samples = (samples < 1) ? 1 : (samples > COLOR_SAMPLES) ? COLOR_SAMPLES : samples;
+        level[COLOR_RED] = 0.5;
+        level[COLOR_BLUE] = 1.3;
+        level[COLOR_NONE] = 2.3;
+    }
+
+    //Takes a burst of readings and classifies their median
+    ColorReading Read()
+    {
+        float burst[COLOR_SAMPLES];
+        Burst(burst);
+        return Classify(burst, _samples);
+    }
+
+    //Classifies count readings, sorting them in place
+    ColorReading Classify(float *burst, int count)
+    {
+        ColorReading result;
+        int i, agree = 0;
+        float edge, margin;
+        Sort(burst, count);
+        result.volts = burst[count/2];
+        result.color = COLOR_NO_READING;
+        result.confidence = 0;
+        if (result.volts <= 0 || result.volts > 3.3)
+        {
+            return result;
+        }
+        result.color = Nearest(result.volts);
+        for (i = 0; i < count; i++)
+        {
+            if (Nearest(burst[i]) == result.color)
+            {
+                agree++;
+            }
+        }
+        //Full margin at the color's level, none at the edge towards the next color
+        margin = 1;
+        edge = Edge(result.color, result.volts < level[result.color]);
+        if (edge >= 0)
+        {
+            margin = fabs(result.volts - edge)/fabs(level[result.color] - edge);
+            margin = (margin > 1) ? 1 : margin;
+        }
+        result.confidence = margin*agree/count;
+        return result;
+    }
+
+    //True if a single reading is closer to the red or blue level than to no light, for quick checks while moving
+    bool Colored(float volts)
+    {
+        return volts > 0 && volts <= 3.3 && Nearest(volts) != COLOR_NONE;
+    }
+
+    //Records the median of a burst as the level of color, returns the level
+    float Capture(int color)
+    {
+        float burst[COLOR_SAMPLES];
+        if (color < 0 || color >= COLOR_COUNT)
+        {
+            return 0;
+        }
+        Burst(burst);
+        Sort(burst, _samples);
+        level[color] = burst[_samples/2];
+        return level[color];
+    }
+
+    //True if the levels are in the order red, blue, none, which every CdS cell gives
+    bool Valid()
+    {
+        return level[COLOR_RED] > 0 && level[COLOR_RED] < level[COLOR_BLUE] && level[COLOR_BLUE] < level[COLOR_NONE] &&
+               level[COLOR_NONE] <= 3.3;
+    }
+
+    //Reads the table from a file on the SD card, keeps the current one if the file is missing or bad
+    bool Load(const char *filename)
+    {
+        float red, blue, none;
+        int n;
+        FEHFile *file = SD.FOpen(filename, "r");
+        if (!file)
+        {
+            return false;
+        }
+        n = SD.FScanf(file, "%f %f %f", &red, &blue, &none);
+        SD.FClose(file);
+        if (n != COLOR_COUNT || !(red > 0 && red < blue && blue < none && none <= 3.3))
+        {
+            return false;
+        }
+        level[COLOR_RED] = red;
+        level[COLOR_BLUE] = blue;
+        level[COLOR_NONE] = none;
+        return true;
+    }
+
+    //Writes the table to a file on the SD card as red, blue and no light volts
+    bool Save(const char *filename)
+    {
+        FEHFile *file = SD.FOpen(filename, "w");
+        if (!file)
+        {
+            return false;
+        }
+        SD.FPrintf(file, "%f %f %f\n", level[COLOR_RED], level[COLOR_BLUE], level[COLOR_NONE]);
+        SD.FClose(file);
+        return true;
+    }
+
+    //CdS reading under each color in volts
+    float level[COLOR_COUNT];
+
+private:
+    void Burst(float *burst)
+    {
+        int i;
+        double next = TimeNow();
+        for (i = 0; i < _samples; i++)
+        {
+            burst[i] = _cds.Value();
+            next += COLOR_SAMPLE_GAP;
+            while (i + 1 < _samples && TimeNow() < next)
+            {
+            }
+        }
+    }
+
+    //Color whose level is closest to volts
+    int Nearest(float volts)
+    {
+        int i, best = 0;
+        for (i = 1; i < COLOR_COUNT; i++)
+        {
+            if (fabs(volts - level[i]) < fabs(volts - level[best]))
+            {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    //Edge of color's range on the low or high side, -1 if there is no color on that side
+    float Edge(int color, bool low)
+    {
+        if (low)
+        {
+            return (color > 0) ? (level[color - 1] + level[color])/2 : -1;
+        }
+        return (color < COLOR_COUNT - 1) ? (level[color] + level[color + 1])/2 : -1;
+    }
+
+    static void Sort(float *values, int count)
+    {
+        int i, j;
+        float v;
+        for (i = 1; i < count; i++)
+        {
+            v = values[i];
+            for (j = i; j > 0 && values[j - 1] > v; j--)
+            {
+                values[j] = values[j - 1];
+            }
+            values[j] = v;
+        }
+    }
+
+    AnalogInputPin &_cds;
+    int _samples;
+};
+
+#endif
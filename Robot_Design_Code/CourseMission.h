@@ -0,0 +1,116 @@
+//Generated by Host_Sim's mission_compile from course.mis, change that and run mission_compile -c course again
+#ifndef COURSE_MISSION_H
+#define COURSE_MISSION_H
+
+#include "Mission.h"
+
+#define COURSE_MISSION_STEPS 100
+
+//Each step with the line of course.mis it came from
+constexpr MissionStep courseMission[COURSE_MISSION_STEPS] =
+{
+    {OP_TASK, 0, 0, 0, 0, 0}, //31
+    {OP_QLINE, 0, 0, 2, 32.5, 0}, //33
+    {OP_QLINE, 1, 0, 8, 50, 0}, //34
+    {OP_QPIVOT, 0, 0, 45, 25, 0}, //35
+    {OP_QLINE, 0, 0, 22, 75, 0}, //36
+    {OP_QLINE, 0, 0, 9, 50, 0}, //37
+    {OP_QPIVOT, 0, 0, -90, 18.75, 0}, //38
+    {OP_QRUN, 0, 0, 0, 0, 0}, //39
+    {OP_WALL, 0, 0, 37.5, 24, 0}, //41
+    {OP_MOVE, 0, 0, -3, 37.5, 0}, //42
+    {OP_PIVOT, 0, 0, -90, 25, 0}, //43
+    {OP_WALL, 0, 0, 75, 18, 0}, //44
+    {OP_SLEEP, 0, 0, 0.02, 0, 0}, //45
+    {OP_FOLLOW, 2, 0, 0, 0, 0}, //46
+    {OP_TASK, 1, 0, 0, 0, 0}, //49
+    {OP_LEVER, 0, 0, 0, 0, 0}, //50
+    {OP_IF, 1, 24, 0, 0, 0}, //51
+    {OP_IF, 2, 32, 0, 0, 0}, //52
+    {OP_PIVOT, 0, 0, 90, 25, 0}, //53
+    {OP_MOVE, 1, 0, 12, 50, 0}, //54
+    {OP_SLEEP, 0, 0, 1, 0, 0}, //55
+    {OP_FOLLOW, 2, 0, 0, 0, 0}, //56
+    {OP_PIVOT, 0, 0, -90, 25, 0}, //57
+    {OP_JUMP, 0, 39, 0, 0, 0}, //58
+    {OP_LANES, 1, 0, 0, 0, 0}, //60
+    {OP_PIVOT, 0, 0, 90, 25, 0}, //61
+    {OP_MOVE, 1, 0, 12, 50, 0}, //62
+    {OP_SLEEP, 0, 0, 1, 0, 0}, //63
+    {OP_FOLLOW, 2, 0, 0, 0, 0}, //64
+    {OP_PIVOT, 0, 0, -90, 25, 0}, //65
+    {OP_LANES, -1, 0, 0, 0, 0}, //66
+    {OP_JUMP, 0, 39, 0, 0, 0}, //67
+    {OP_LANES, 2, 0, 0, 0, 0}, //69
+    {OP_PIVOT, 0, 0, 90, 25, 0}, //70
+    {OP_MOVE, 1, 0, 12, 50, 0}, //71
+    {OP_SLEEP, 0, 0, 1, 0, 0}, //72
+    {OP_FOLLOW, 2, 0, 0, 0, 0}, //73
+    {OP_PIVOT, 0, 0, -90, 25, 0}, //74
+    {OP_LANES, -2, 0, 0, 0, 0}, //75
+    {OP_UNTIL, 5, 0, -5, 50, 0}, //78
+    {OP_FOLLOW, 1, 0, 12, 3, 0}, //79
+    {OP_TASK, 2, 0, 0, 0, 0}, //81
+    {OP_MOVE, 0, 0, -2.2, 50, 0}, //82
+    {OP_PIVOT, 0, 0, 90, 25, 0}, //83
+    {OP_PUSH, 4, 0, -10, 5, 0}, //85
+    {OP_SLEEP, 0, 0, 0.02, 0, 0}, //86
+    {OP_SERVO, 1, 0, 95, 1, 0}, //87
+    {OP_SERVO_START, 1, 0, 0, 0, 0}, //89
+    {OP_MOVE, 0, 0, 0.5, 50, 0}, //90
+    {OP_SYNC, 0, 0, 0, 0, 0}, //91
+    {OP_PIVOT, 0, 0, -90, 25, 0}, //92
+    {OP_LANES, -1, 0, 0, 0, 0}, //94
+    {OP_TASK, 1, 0, 0, 0, 0}, //97
+    {OP_LEVER, 0, 0, 0, 0, 0}, //98
+    {OP_IF, 1, 57, 0, 0, 0}, //99
+    {OP_IF, 2, 59, 0, 0, 0}, //100
+    {OP_JUMP, 0, 60, 0, 0, 0}, //101
+    {OP_LANES, 1, 0, 0, 0, 0}, //103
+    {OP_JUMP, 0, 60, 0, 0, 0}, //104
+    {OP_LANES, 2, 0, 0, 0, 0}, //106
+    {OP_PIVOT, 0, 0, 90, 25, 0}, //108
+    {OP_MOVE, 1, 0, 6, 50, 0}, //109
+    {OP_SLEEP, 0, 0, 1, 0, 0}, //110
+    {OP_FOLLOW, 2, 0, 0, 0, 0}, //111
+    {OP_MOVE, 0, 0, -5, 50, 0}, //113
+    {OP_PIVOT, 0, 0, -90, 25, 0}, //114
+    {OP_TASK, 3, 0, 0, 0, 0}, //116
+    {OP_WALL, 0, 0, 50, 32, 0}, //117
+    {OP_MOVE, 0, 0, -6.5, 50, 0}, //118
+    {OP_PIVOT, 0, 0, 90, 25, 0}, //119
+    {OP_MOVE, 0, 0, 13, 50, 0}, //120
+    {OP_SERVO_START, 0, 0, 100, 0, 0}, //122
+    {OP_PIVOT, 0, 0, 45, 25, 0}, //123
+    {OP_SYNC, 0, 0, 0, 0, 0}, //124
+    {OP_PIVOT, 0, 0, 30, 25, 0}, //125
+    {OP_MOVE, 0, 0, -2, 50, 0}, //126
+    {OP_PIVOT, 0, 0, 10, 25, 0}, //127
+    {OP_MOVE, 0, 0, 5, 50, 0}, //128
+    {OP_PIVOT, 0, 0, -45, 25, 0}, //129
+    {OP_SERVO_START, 0, 0, 0, 0, 0}, //131
+    {OP_PIVOT, 0, 0, 45, 25, 0}, //132
+    {OP_MOVE, 0, 0, 8, 50, 0}, //133
+    {OP_SYNC, 0, 0, 0, 0, 0}, //134
+    {OP_PIVOT, 0, 0, 90, 25, 0}, //136
+    {OP_MOVE, 0, 0, 22, 50, 0}, //137
+    {OP_TASK, 4, 0, 0, 0, 0}, //139
+    {OP_WALL, 0, 0, 50, 24, 0}, //140
+    {OP_MOVE, 0, 0, -4, 50, 0}, //141
+    {OP_PIVOT, 0, 0, -90, 25, 0}, //142
+    {OP_COLOR, 0, 0, 0, 0, 0}, //143
+    {OP_IF, 0, 94, 0, 0, 0}, //144
+    {OP_SIDESTEP, 1, 0, -0.71, 3.71, 50}, //146
+    {OP_GOTO, 0, 0, -6, -8, 45}, //147
+    {OP_JUMP, 0, 96, 0, 0, 0}, //148
+    {OP_SIDESTEP, 1, 0, 0.71, 3.71, 50}, //150
+    {OP_GOTO, 0, 0, -6, -6, 45}, //151
+    {OP_TASK, 5, 0, 0, 0, 0}, //154
+    {OP_MOVE, 1, 0, 13, 50, 0}, //155
+    {OP_SLEEP, 0, 0, 0.02, 0, 0}, //156
+    {OP_END, 0, 0, 0, 0, 0}, //157
+};
+
+static_assert(MissionValid(courseMission, COURSE_MISSION_STEPS), "course.mis compiled into a mission that can't run");
+
+#endif
@@ -0,0 +1,420 @@
+#ifndef DRIVECONTROL_H
+#define DRIVECONTROL_H
+
+#include <FEHMotor.h>
+#include <FEHIO.h>
+#include <FEHUtility.h>
+#include <math.h>
+#include "MotionProfile.h"
+#include "Scheduler.h"
+#include "Stall.h"
+
+//Period of the drive control loop in seconds (100 Hz)
+#define DRIVE_PERIOD 0.01
+//The period and its inverse as floats, worked out by the compiler so the loop never drops into double precision,
+//which the Proteus's FPU doesn't have
+#define DRIVE_DT ((float)DRIVE_PERIOD)
+#define DRIVE_RATE ((float)(1/DRIVE_PERIOD))
+
+//What DriveController::Run() is doing
+#define DRIVE_IDLE 0
+#define DRIVE_MOVING 1
+#define DRIVE_SETTLING 2
+
+//Tuning for the closed-loop drive controller
+struct DriveGains
+{
+    //PID gains on the heading error, which is the left minus right encoder counts
+    float kp, ki, kd;
+    //Feedforward in percent of power per inch per second the profile asks for
+    float kv;
+    //Percent of power per inch the robot is behind the profile
+    float kpos;
+    //Acceleration used to plan profiles, inches per second squared
+    float accel;
+    //Plan profiles with half cosine ramps instead of straight ones
+    bool sCurve;
+    //Lowest percent that still reliably moves the robot
+    float minSpeed;
+    //Distance in inches from the target that counts as arrived
+    float tolerance;
+    //Seconds the robot keeps rolling after Stop(), the loop stops early by speed times this
+    float coast;
+    //After stopping, wait until the encoders have been still this long (up to five times as long)
+    float settle;
+    //Give up after this many seconds (pinned against something)
+    float timeout;
+    //Seconds a move with stall detection off keeps pushing past the end of its profile, leaning on whatever it ran into
+    float lean;
+};
+
+/*Closed-loop driving using both shaft encoders, moves follow a MotionProfile. Each move can be run to the
+ end with Drive(), Turn(), Arc() or Curve(), or started with StartDrive(), StartTurn(), StartArc() or
+ StartCurve() and then stepped as a scheduler Task every DRIVE_PERIOD*/
+class DriveController : public Task
+{
+public:
+    DriveController(FEHMotor &left, FEHMotor &right, DigitalEncoder &leftEnc, DigitalEncoder &rightEnc, float countsPerInch, float track)
+        : _left(left), _right(right), _leftEnc(leftEnc), _rightEnc(rightEnc), _countsPerInch(countsPerInch), _track(track)
+    {
+        gains.kp = 0.8;
+        gains.ki = 4.0;
+        gains.kd = 0.02;
+        gains.kv = 7.1;
+        gains.kpos = 12.0;
+        gains.accel = 40.0;
+        gains.sCurve = false;
+        gains.minSpeed = 15.0;
+        gains.tolerance = 0.05;
+        gains.coast = 0.08;
+        gains.settle = 0.02;
+        gains.timeout = 10.0;
+        gains.lean = 0.5;
+        elapsed = 0;
+        stalled = false;
+        stallStart = 0;
+        _leftPower = _rightPower = 0;
+        _phase = DRIVE_IDLE;
+        _leftRatio = _rightRatio = 0;
+        _sign = 1;
+        _leftStart = _rightStart = 0;
+        _pushing = false;
+    }
+
+    /*Drives a distance in inches (negative is backwards) at up to speed percent and stops,
+     returns the distance the left and right wheels averaged*/
+    float Drive(float distance, float speed)
+    {
+        StartDrive(distance, speed);
+        return Finish();
+    }
+
+    /*Pivots in place, positive degrees turn right, at up to speed percent on each wheel.
+     Returns the angle turned in degrees*/
+    float Turn(float degrees, float speed)
+    {
+        StartTurn(degrees, speed);
+        return Finish()*360.0/(M_PI*_track);
+    }
+
+    //Starts a Drive() without waiting for it, Run() it until it returns false
+    void StartDrive(float distance, float speed)
+    {
+        float dir = (distance < 0) ? -1 : 1;
+        profile.Plan(distance, fabs(speed)/gains.kv, gains.accel, gains.sCurve);
+        Begin(dir, dir, true);
+        _sign = dir;
+    }
+
+    //Starts a Turn() without waiting for it
+    void StartTurn(float degrees, float speed)
+    {
+        float dir = (degrees < 0) ? -1 : 1;
+        profile.Plan(M_PI*_track*degrees/360.0, fabs(speed)/gains.kv, gains.accel, gains.sCurve);
+        Begin(dir, -dir, true);
+        _sign = dir;
+    }
+
+    /*Drives along a circle of radius inches (negative backs up) until the heading has changed by degrees,
+     positive degrees turn right. The outer wheel runs at up to speed percent. Returns the distance the
+     center of the robot travelled*/
+    float Arc(float radius, float degrees, float speed)
+    {
+        StartArc(radius, degrees, speed);
+        return Finish();
+    }
+
+    /*Drives distance inches (negative backs up) turning curvature radians per inch, positive curvature turns
+     right and 0 is straight. The same move as an Arc() of radius 1/curvature, but curvature can pass through
+     zero so a caller can steer smoothly from straight into a turn. Returns the distance covered*/
+    float Curve(float distance, float curvature, float speed)
+    {
+        StartCurve(distance, curvature, speed);
+        return Finish();
+    }
+
+    //Starts an Arc() without waiting for it
+    void StartArc(float radius, float degrees, float speed)
+    {
+        float left, right;
+        ArcRatios(radius, degrees, &left, &right);
+        StartRatios(fabs(radius*degrees)*M_PI/180.0, left, right, speed);
+        _sign = 1;
+    }
+
+    //Starts a Curve() without waiting for it
+    void StartCurve(float distance, float curvature, float speed)
+    {
+        float dir = (distance < 0) ? -1 : 1, left, right;
+        CurveRatios(dir, curvature, &left, &right);
+        StartRatios(fabs(distance), left, right, speed);
+        _sign = dir;
+    }
+
+    //Distance between the wheels in inches
+    float TrackWidth()
+    {
+        return _track;
+    }
+
+    //Changes the drive's geometry, for a calibration loaded at startup. Only call it between moves
+    void SetGeometry(float countsPerInch, float track)
+    {
+        _countsPerInch = countsPerInch;
+        _track = track;
+    }
+
+    //Wheel distances per inch of travel along an arc, see Arc() for the signs of radius and degrees
+    void ArcRatios(float radius, float degrees, float *left, float *right)
+    {
+        CurveRatios((radius < 0) ? -1 : 1, (degrees < 0 ? -1 : 1)/fabs(radius), left, right);
+    }
+
+    /*Wheel distances per inch of travel at curvature radians per inch, dir is 1 forwards and -1 backwards.
+     Past 2/TrackWidth() the inner wheel runs backwards, the turn getting closer to a pivot*/
+    void CurveRatios(float dir, float curvature, float *left, float *right)
+    {
+        float k = curvature*_track/2;
+        *left = dir + k;
+        *right = dir - k;
+    }
+
+    /*Runs the wheels along profile at a fixed rate. leftRatio and rightRatio are the signed distances each
+     wheel rolls per inch of the profile, so a straight move is (1, 1), a right pivot (1, -1) and an arc
+     something in between. Position feedback keeps the robot on the profile and a PID on the count
+     difference keeps the wheels at the right ratio, so straight moves hold their heading and pivots stay
+     centered. If stop is false the motors are left running at the profile's end speed so the next move
+     can carry on from it. Returns the distance covered along the profile*/
+    float Follow(float leftRatio, float rightRatio, bool stop)
+    {
+        Begin(leftRatio, rightRatio, stop);
+        _sign = 1;
+        return Finish();
+    }
+
+    //Sets up a Follow() for Run() to step through
+    void Begin(float leftRatio, float rightRatio, bool stop)
+    {
+        _leftRatio = leftRatio;
+        _rightRatio = rightRatio;
+        _stop = stop;
+        _pushing = false;
+        _integral = _lastError = _lastTravelled = 0;
+        //Inches along the profile per encoder count, once per move rather than a divide every period
+        _inchesPerCount = 1/(fmax(fabs(leftRatio) + fabs(rightRatio), 0.001f)*_countsPerInch);
+        //Counts are only cleared from rest, a move chained onto a moving robot measures from where it is
+        if (profile.startVel == 0)
+        {
+            _leftEnc.ResetCounts();
+            _rightEnc.ResetCounts();
+        }
+        _leftStart = _leftEnc.Counts();
+        _rightStart = _rightEnc.Counts();
+        _start = TimeNow();
+        stalled = false;
+        stall.Reset(_leftStart, _rightStart);
+        _phase = (profile.distance <= 0 || fabs(leftRatio) + fabs(rightRatio) <= 0) ? DRIVE_IDLE : DRIVE_MOVING;
+    }
+
+    //One DRIVE_PERIOD of the current move, returns false once the move is over and the robot has settled
+    bool Run()
+    {
+        float ratioL = fabs(_leftRatio), ratioR = fabs(_rightRatio), ratioSum = ratioL + ratioR;
+        float sideL = (_leftRatio < 0) ? -1 : 1, sideR = (_rightRatio < 0) ? -1 : 1;
+        float power, error, remaining, corr, velocity, travelled, t;
+        int leftCounts = _leftEnc.Counts(), rightCounts = _rightEnc.Counts();
+
+        if (_phase == DRIVE_SETTLING)
+        {
+            //Waits for the robot to stop rolling so the next move starts from rest
+            if (leftCounts != _settleLeft || rightCounts != _settleRight)
+            {
+                _settleLeft = leftCounts;
+                _settleRight = rightCounts;
+                _still = TimeNow();
+            }
+            if (TimeNow() - _still < gains.settle && TimeNow() - _settleStart < 5*gains.settle)
+            {
+                return true;
+            }
+            elapsed = TimeNow() - _start;
+            _phase = DRIVE_IDLE;
+            return false;
+        }
+        if (_phase == DRIVE_IDLE)
+        {
+            return false;
+        }
+
+        leftCounts -= _leftStart;
+        rightCounts -= _rightStart;
+        t = TimeNow() - _start;
+        travelled = (leftCounts + rightCounts)*_inchesPerCount;
+        velocity = (travelled - _lastTravelled)*DRIVE_RATE;
+        _lastTravelled = travelled;
+        remaining = profile.distance - travelled;
+        if (remaining <= gains.tolerance + (_stop ? velocity*gains.coast : 0) || t > gains.timeout ||
+            (!stall.enabled && t > profile.Duration() + gains.lean))
+        {
+            if (!_stop)
+            {
+                elapsed = t;
+                _phase = DRIVE_IDLE;
+                return false;
+            }
+            Halt();
+            return true;
+        }
+        //Pinned against something, the move is over rather than pushing on until the timeout
+        if (stall.Check(_leftPower, _rightPower, _leftStart + leftCounts, _rightStart + rightCounts))
+        {
+            stalled = true;
+            stallStart = TimeNow() - stall.window;
+            Halt();
+            return _phase != DRIVE_IDLE;
+        }
+
+        //Feedforward from the profile plus a correction for lagging behind it
+        power = gains.kv*profile.Velocity(t) + gains.kpos*(profile.Position(t) - travelled);
+        //The profile ends at zero speed, keep creeping if the robot came up short
+        if (t > profile.Duration() && power < gains.minSpeed)
+        {
+            power = gains.minSpeed;
+        }
+
+        //Heading PID, a positive error means the left wheel is ahead of its share so it gets less power
+        error = (leftCounts*ratioR - rightCounts*ratioL)*2/ratioSum;
+        _integral += error*DRIVE_DT;
+        corr = gains.kp*error + gains.ki*_integral + gains.kd*(error - _lastError)*DRIVE_RATE;
+        _lastError = error;
+
+        //Never against the way the wheel should turn, the encoders can't tell and would count it as progress
+        _leftPower = sideL*fmax(0.0f, ratioL*power - corr);
+        _rightPower = sideR*fmax(0.0f, ratioR*power + corr);
+        _left.SetPercent(_leftPower);
+        _right.SetPercent(_rightPower);
+        return true;
+    }
+
+    //Cuts the current move short, stopping the motors now and settling as if it had reached its target
+    void Halt()
+    {
+        if (_phase != DRIVE_MOVING)
+        {
+            return;
+        }
+        _left.Stop();
+        _right.Stop();
+        _leftPower = _rightPower = 0;
+        _phase = _stop ? DRIVE_SETTLING : DRIVE_IDLE;
+        _settleLeft = _leftEnc.Counts();
+        _settleRight = _rightEnc.Counts();
+        _settleStart = _still = TimeNow();
+        elapsed = TimeNow() - _start;
+    }
+
+    /*Runs both motors straight at percent with no control, for pushing against something, 0 stops them.
+     Travelled() measures from the start of the push*/
+    void Push(float percent)
+    {
+        if (percent != 0 && !_pushing)
+        {
+            _leftRatio = _rightRatio = 1;
+            _sign = (percent < 0) ? -1 : 1;
+            _leftStart = _leftEnc.Counts();
+            _rightStart = _rightEnc.Counts();
+            stalled = false;
+            stall.Reset(_leftStart, _rightStart);
+        }
+        _pushing = percent != 0;
+        _phase = DRIVE_IDLE;
+        _leftPower = _rightPower = percent;
+        _left.SetPercent(percent);
+        _right.SetPercent(percent);
+    }
+
+    //Power last sent to each motor, its sign is which way that wheel is turning since the encoders can't tell
+    float LeftPower()
+    {
+        return _leftPower;
+    }
+
+    float RightPower()
+    {
+        return _rightPower;
+    }
+
+    //Checks a Push() for a stall, call it regularly while pushing. Returns true once the robot has stalled
+    bool CheckStall()
+    {
+        if (!stalled && stall.Check(_leftPower, _rightPower, _leftEnc.Counts(), _rightEnc.Counts()))
+        {
+            stalled = true;
+            stallStart = TimeNow() - stall.window;
+        }
+        return stalled;
+    }
+
+    /*Distance covered along the profile by the current or last move, signed for StartDrive() and
+     StartTurn() moves the same way Drive() and Turn() return it*/
+    float Travelled()
+    {
+        float ratioSum = fabs(_leftRatio) + fabs(_rightRatio);
+        if (ratioSum <= 0)
+        {
+            return 0;
+        }
+        return _sign*(_leftEnc.Counts() - _leftStart + _rightEnc.Counts() - _rightStart)/(ratioSum*_countsPerInch);
+    }
+
+    DriveGains gains;
+    //Profile of the last move
+    MotionProfile profile;
+    //Seconds the last move took
+    double elapsed;
+    //Watches the encoders against the motor power, a stalled move ends early with stalled set
+    StallDetector stall;
+    //Whether the last move or push ended in a stall, and when the robot stopped moving
+    bool stalled;
+    double stallStart;
+
+private:
+    //Plans a move of length inches with the wheels at the given ratios, the faster wheel held to speed percent
+    void StartRatios(float length, float left, float right, float speed)
+    {
+        profile.Plan(length, fabs(speed)/gains.kv/fmax(fabs(left), fabs(right)), gains.accel, gains.sCurve);
+        Begin(left, right, true);
+    }
+
+    //Steps the move that was just started at a fixed rate on its own, without a scheduler
+    float Finish()
+    {
+        double next = TimeNow();
+        while (Run())
+        {
+            next += DRIVE_PERIOD;
+            while (TimeNow() < next)
+            {
+            }
+        }
+        return Travelled();
+    }
+
+    FEHMotor &_left;
+    FEHMotor &_right;
+    DigitalEncoder &_leftEnc;
+    DigitalEncoder &_rightEnc;
+    float _countsPerInch;
+    float _track;
+    //State of the move Run() is stepping through
+    int _phase;
+    float _leftRatio, _rightRatio, _sign;
+    bool _stop, _pushing;
+    float _integral, _lastError, _lastTravelled, _inchesPerCount;
+    //Power last sent to each motor
+    float _leftPower, _rightPower;
+    int _leftStart, _rightStart, _settleLeft, _settleRight;
+    double _start, _settleStart, _still;
+};
+
+#endif
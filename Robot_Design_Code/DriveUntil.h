@@ -0,0 +1,183 @@
+#ifndef DRIVEUNTIL_H
+#define DRIVEUNTIL_H
+
+#include <FEHUtility.h>
+#include "DriveControl.h"
+#include "Scheduler.h"
+
+//Period in seconds the condition is checked at while driving, five times the drive loop's rate
+#define UNTIL_PERIOD 0.002
+
+//Why a DriveUntil move ended
+#define UNTIL_LIMIT 0
+#define UNTIL_FOUND 1
+#define UNTIL_TIMEOUT 2
+#define UNTIL_STALL 3
+
+//How a DriveUntil move ended
+struct UntilResult
+{
+    //UNTIL_FOUND if the condition came true, UNTIL_LIMIT if the distance ran out first, UNTIL_TIMEOUT if the time did,
+    //UNTIL_STALL if the robot got pinned before any of them
+    int reason;
+    //Inches driven, up to the moment the condition came true if it did
+    float distance;
+    //Seconds from the start of the move to the end, or to the condition coming true
+    double elapsed;
+};
+
+/*Drives until a condition comes true instead of stepping and checking. The drive runs as a normal profiled
+ move up to a distance limit at a steady speed, and this task checks the condition every UNTIL_PERIOD
+ alongside it on the scheduler. Once the condition has held for confirm checks in a row the drive is
+ halted at once, so the robot stops within confirm checks plus the coast after the condition came true.
+ A timeout halts it too, so a missed sensor can't leave the robot pushing on a wall for the rest of the run,
+ and so does the drive controller's stall detector if the robot gets pinned before the condition comes true.
+
+ Square() carries on from a drive that found a wall, pushing straight on at low power until a second
+ condition (both switches pressed) comes true so the robot ends up square against it.
+ Conditions are plain functions with an int argument, like the line follower's end conditions*/
+class DriveUntil : public Task
+{
+public:
+    DriveUntil(Scheduler &scheduler, DriveController &drive) : _scheduler(scheduler), _drive(drive)
+    {
+        confirm = 3;
+        _check = 0;
+        _arg = 0;
+        _count = 0;
+        _pushing = false;
+        _dir = 1;
+        _timeout = _start = 0;
+        _result.reason = UNTIL_LIMIT;
+        _result.distance = 0;
+        _result.elapsed = 0;
+    }
+
+    /*Drives up to limit inches (negative backs up) at speed percent until check(arg) comes true, for at most
+     timeout seconds (0 for no limit besides the drive controller's own)*/
+    UntilResult Drive(float limit, float speed, bool (*check)(int), int arg, float timeout = 0)
+    {
+        _scheduler.Wait(_drive);
+        Start(check, arg, timeout, false);
+        _dir = (limit < 0) ? -1 : 1;
+        _drive.StartDrive(limit, speed);
+        if (_scheduler.Add(_drive, DRIVE_PERIOD) && _scheduler.Add(*this, UNTIL_PERIOD))
+        {
+            _scheduler.Wait(_drive);
+            _scheduler.Remove(*this);
+        } else
+        {
+            Step();
+        }
+        if (_result.reason != UNTIL_FOUND)
+        {
+            _result.reason = _drive.stalled ? UNTIL_STALL : _result.reason;
+            _result.distance = _drive.Travelled();
+            _result.elapsed = TimeNow() - _start;
+        }
+        return _result;
+    }
+
+    //Pushes on in the direction of the last Drive() at power percent until check(arg) comes true, see Push()
+    UntilResult Square(float power, bool (*check)(int), int arg, float timeout)
+    {
+        UntilResult square;
+        bool watching = _drive.stall.enabled;
+        //Pressed against the wall on purpose, one wheel pinned while the other catches up isn't a stall
+        _drive.stall.enabled = false;
+        square = Push(_dir*power, check, arg, timeout);
+        _drive.stall.enabled = watching;
+        return square;
+    }
+
+    /*Runs both motors at power percent with no control (negative backs up) until check(arg) comes true,
+     timeout seconds pass or the robot stalls, then stops. The distance is how far the wheels turned*/
+    UntilResult Push(float power, bool (*check)(int), int arg, float timeout)
+    {
+        _scheduler.Wait(_drive);
+        Start(check, arg, timeout, true);
+        _dir = (power < 0) ? -1 : 1;
+        _drive.Push(power);
+        _scheduler.Run(*this, UNTIL_PERIOD);
+        _drive.Push(0);
+        _result.distance = _drive.Travelled();
+        return _result;
+    }
+
+    //Checks the condition and the time once, ends the move once the condition is confirmed or time is up
+    bool Run()
+    {
+        double t = TimeNow() - _start;
+        _count = _check(_arg) ? _count + 1 : 0;
+        if (_pushing && _count < confirm && _drive.CheckStall())
+        {
+            _result.reason = UNTIL_STALL;
+            _result.distance = _drive.Travelled();
+            _result.elapsed = t;
+            return false;
+        }
+        if (_count < confirm && (_timeout <= 0 || t < _timeout))
+        {
+            return true;
+        }
+        _result.reason = (_count >= confirm) ? UNTIL_FOUND : UNTIL_TIMEOUT;
+        _result.distance = _drive.Travelled();
+        _result.elapsed = t;
+        if (!_pushing)
+        {
+            _drive.Halt();
+        }
+        return false;
+    }
+
+    //Checks in a row the condition has to hold for
+    int confirm;
+
+private:
+    /*Steps the drive and the check here when the scheduler has no room for both, the check every UNTIL_PERIOD
+     and the drive every DRIVE_PERIOD, until the drive is done. Nothing else runs meanwhile*/
+    void Step()
+    {
+        double now = TimeNow(), nextDrive = now, nextCheck = now;
+        bool driving = true, checking = true;
+        _scheduler.Remove(_drive);
+        while (driving)
+        {
+            now = TimeNow();
+            if (checking && now >= nextCheck)
+            {
+                checking = Run();
+                nextCheck += UNTIL_PERIOD;
+            }
+            if (now >= nextDrive)
+            {
+                driving = _drive.Run();
+                nextDrive += DRIVE_PERIOD;
+            }
+        }
+    }
+
+    void Start(bool (*check)(int), int arg, float timeout, bool pushing)
+    {
+        _check = check;
+        _arg = arg;
+        _timeout = timeout;
+        _pushing = pushing;
+        _count = 0;
+        _result.reason = UNTIL_LIMIT;
+        _result.distance = 0;
+        _result.elapsed = 0;
+        _start = TimeNow();
+    }
+
+    Scheduler &_scheduler;
+    DriveController &_drive;
+    bool (*_check)(int);
+    int _arg, _count;
+    bool _pushing;
+    float _dir, _timeout;
+    double _start;
+    UntilResult _result;
+};
+
+#endif
@@ -0,0 +1,252 @@
+#ifndef KINEMATICS_H
+#define KINEMATICS_H
+
+#include <FEHRPS.h>
+#include <FEHSD.h>
+#include <FEHUtility.h>
+#include <math.h>
+#include "DriveControl.h"
+#include "PoseEstimator.h"
+
+//Most trials of each kind one calibration keeps
+#define KINEMATIC_TRIALS 16
+
+/*Drive geometry the robot code works from. The wheel diameter and track width are effective values, what
+ makes the encoders agree with where RPS says the robot went, so they soak up tire squish and wheel slip.
+ turnOffset is the turn-error model, the degrees each pivot ends up past what it was asked for (negative if it
+ falls short) from wheel slip and coasting, which matters most on small turns*/
+struct Kinematics
+{
+    Kinematics(float wheelDiameter, float trackWidth, float counts)
+    {
+        wheel = wheelDiameter;
+        track = trackWidth;
+        countsPerRev = counts;
+        turnOffset = 0;
+    }
+
+    //Encoder counts per inch the wheels roll
+    float CountsPerInch()
+    {
+        return countsPerRev/(wheel*M_PI);
+    }
+
+    //Degrees to ask the drive for so the robot really turns degrees, never turning the other way
+    float TurnCommand(float degrees)
+    {
+        float dir = (degrees < 0) ? -1 : 1;
+        return dir*fmax(0, fabs(degrees) - turnOffset);
+    }
+
+    //True if the numbers could belong to this robot rather than a bad fit or a corrupt file
+    bool Valid()
+    {
+        return wheel > 1.5 && wheel < 4 && track > 4 && track < 12 && countsPerRev > 0 && fabs(turnOffset) < 15;
+    }
+
+    //Reads the geometry from a file on the SD card, keeps the current one if the file is missing or bad
+    bool Load(const char *filename)
+    {
+        Kinematics read(0, 0, 0);
+        int n;
+        FEHFile *file = SD.FOpen(filename, "r");
+        if (!file)
+        {
+            return false;
+        }
+        n = SD.FScanf(file, "%f %f %f %f", &read.wheel, &read.track, &read.countsPerRev, &read.turnOffset);
+        SD.FClose(file);
+        if (n != 4 || !read.Valid())
+        {
+            return false;
+        }
+        *this = read;
+        return true;
+    }
+
+    //Writes the geometry to a file on the SD card as wheel inches, track inches, counts per revolution and turn offset degrees
+    bool Save(const char *filename)
+    {
+        FEHFile *file = SD.FOpen(filename, "w");
+        if (!file)
+        {
+            return false;
+        }
+        SD.FPrintf(file, "%f %f %f %f\n", wheel, track, countsPerRev, turnOffset);
+        SD.FClose(file);
+        return true;
+    }
+
+    float wheel, track, countsPerRev, turnOffset;
+};
+
+/*Measures the drive against RPS and fits Kinematics to it. Each trial reads RPS with the robot still,
+ drives or pivots with the controller as it is set up now, lets RPS catch up and reads it again, keeping what
+ the encoders said next to what RPS saw. Straight trials fit the wheel diameter, pivots then fit the track
+ width and turn offset by least squares, so more and longer trials give a better fit. The robot needs room
+ to drive and RPS coverage for the whole calibration*/
+class KinematicCalibration
+{
+public:
+    KinematicCalibration(DriveController &drive) : _drive(drive)
+    {
+        samples = 5;
+        settle = 0.5;
+        Clear();
+    }
+
+    void Clear()
+    {
+        straights = turns = 0;
+    }
+
+    //Drives distance inches and records it, returns false if RPS couldn't see the robot
+    bool Straight(float distance, float speed)
+    {
+        float x0, y0, h0, x1, y1, h1, measured;
+        if (straights == KINEMATIC_TRIALS || !Read(&x0, &y0, &h0))
+        {
+            return false;
+        }
+        measured = _drive.Drive(distance, speed);
+        if (_drive.stalled || !Read(&x1, &y1, &h1))
+        {
+            return false;
+        }
+        //Only the part along the starting heading counts, sideways drift is the heading PID's problem
+        h0 = h0*M_PI/180.0;
+        _straightEnc[straights] = measured;
+        _straightTrue[straights] = (x1 - x0)*cos(h0) + (y1 - y0)*sin(h0);
+        straights++;
+        return true;
+    }
+
+    //Pivots degrees (positive right like DriveController::Turn()) and records it
+    bool Pivot(float degrees, float speed)
+    {
+        float x0, y0, h0, x1, y1, h1, measured;
+        if (turns == KINEMATIC_TRIALS || !Read(&x0, &y0, &h0))
+        {
+            return false;
+        }
+        measured = _drive.Turn(degrees, speed);
+        if (_drive.stalled || !Read(&x1, &y1, &h1))
+        {
+            return false;
+        }
+        //RPS headings go counter-clockwise, so a right turn makes them smaller
+        _turnCmd[turns] = degrees;
+        _turnEnc[turns] = measured;
+        _turnTrue[turns] = -PoseEstimator::Wrap(h1 - h0);
+        turns++;
+        return true;
+    }
+
+    /*Fits the trials into k, which must be what the drive was set up with while they ran.
+     Returns false and leaves k alone without at least one straight and two pivots*/
+    bool Fit(Kinematics &k)
+    {
+        Kinematics fit = k;
+        float se = 0, st = 0, scale, sxx = 0, sxs = 0, sss = 0, sxy = 0, ssy = 0, det, slope, offset, x, s, coast = 0;
+        int i;
+        if (straights < 1 || turns < 2)
+        {
+            return false;
+        }
+        //RPS distance = scale*encoder distance, a least squares line through zero
+        for (i = 0; i < straights; i++)
+        {
+            se += _straightEnc[i]*_straightEnc[i];
+            st += _straightEnc[i]*_straightTrue[i];
+        }
+        if (se <= 0)
+        {
+            return false;
+        }
+        scale = st/se;
+        fit.wheel = k.wheel*scale;
+        //RPS degrees = slope*encoder degrees + offset*direction, with the encoder degrees rescaled to the new wheel
+        for (i = 0; i < turns; i++)
+        {
+            x = _turnEnc[i]*scale;
+            s = (x < 0) ? -1 : 1;
+            sxx += x*x;
+            sxs += x*s;
+            sss += 1;
+            sxy += x*_turnTrue[i];
+            ssy += s*_turnTrue[i];
+            //How far past the command the encoders say the pivot went before it stopped
+            coast += s*(_turnEnc[i] - _turnCmd[i]);
+        }
+        det = sxx*sss - sxs*sxs;
+        //Every pivot the same size can't tell the slope from the offset, so it all goes into the track
+        if (fabs(det) < 1e-3*sxx*sss)
+        {
+            slope = sxy/sxx;
+            offset = 0;
+        } else
+        {
+            slope = (sxy*sss - ssy*sxs)/det;
+            offset = (sxx*ssy - sxs*sxy)/det;
+        }
+        if (slope <= 0)
+        {
+            return false;
+        }
+        fit.track = k.track/slope;
+        //Pivots are asked for less by what slips past the encoders and what coasts past the command, in degrees of the new track
+        fit.turnOffset = offset + coast/turns*scale*slope;
+        if (!fit.Valid())
+        {
+            return false;
+        }
+        k = fit;
+        return true;
+    }
+
+    //RPS readings averaged for each pose, and seconds waited after a move for RPS to catch up
+    int samples;
+    float settle;
+    //Trials recorded so far
+    int straights, turns;
+
+private:
+    //Averages RPS over a few packets with the robot still, skipping dropouts. Returns false if too many packets were dropouts
+    bool Read(float *x, float *y, float *heading)
+    {
+        float rx, ry, rh, sx = 0, sy = 0, sc = 0, ss = 0;
+        int i, n = 0;
+        Sleep(settle);
+        for (i = 0; i < 3*samples && n < samples; i++)
+        {
+            rx = RPS.X();
+            ry = RPS.Y();
+            rh = RPS.Heading();
+            Sleep(0.1);
+            if (rx < 0 || ry < 0 || rh < 0)
+            {
+                continue;
+            }
+            sx += rx;
+            sy += ry;
+            //Headings are averaged as directions, 359 and 1 average to 0 and not 180
+            sc += cos(rh*M_PI/180.0);
+            ss += sin(rh*M_PI/180.0);
+            n++;
+        }
+        if (n < samples)
+        {
+            return false;
+        }
+        *x = sx/n;
+        *y = sy/n;
+        *heading = atan2(ss, sc)*180.0/M_PI;
+        return true;
+    }
+
+    DriveController &_drive;
+    float _straightEnc[KINEMATIC_TRIALS], _straightTrue[KINEMATIC_TRIALS];
+    float _turnCmd[KINEMATIC_TRIALS], _turnEnc[KINEMATIC_TRIALS], _turnTrue[KINEMATIC_TRIALS];
+};
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef LINEFOLLOWER_H
+#define LINEFOLLOWER_H
+
+#include <FEHMotor.h>
+#include <FEHUtility.h>
+#include <math.h>
+#include "LineSensors.h"
+#include "Scheduler.h"
+
+//Period of the line following control loop in seconds (200 Hz)
+#define LINE_PERIOD 0.005
+
+//Tuning for the line follower
+struct LineGains
+{
+    //PID gains in percent of power per unit of LineSensors::Offset()
+    float kp, ki, kd;
+    //Base power in percent, negative drives backwards (the optosensors are named looking the way the robot drives)
+    float speed;
+    //Largest correction in percent, so the outer wheel never has to reverse
+    float maxTurn;
+    //Offset steered towards once the line is lost, in the direction it was last seen
+    float lost;
+};
+
+/*PID line follower. The error is the continuous offset of the line across the three optosensors rather than
+ a handful of discrete states, so the correction grows smoothly as the robot drifts and the base speed can be
+ much higher. The loop runs at a fixed rate of LINE_PERIOD, the caller decides when to stop:
+     line = follower.Start();
+     while (keepGoing(line))
+     {
+         follower.Steer(line);
+         line = follower.Next();
+     }
+     follower.Stop();
+ or as a scheduler Task every LINE_PERIOD, after Begin() with the test that decides when to stop*/
+class LineFollower : public Task
+{
+public:
+    LineFollower(FEHMotor &left, FEHMotor &right, LineSensors &sensors) : _left(left), _right(right), _sensors(sensors)
+    {
+        gains.kp = 45.0;
+        gains.ki = 5.0;
+        gains.kd = 0.6;
+        gains.speed = -50.0;
+        gains.maxTurn = 30.0;
+        gains.lost = 1.5;
+        _integral = _lastError = 0;
+        _next = 0;
+        _until = 0;
+        _arg = 0;
+    }
+
+    //Resets the controller and returns the first reading
+    LineSnapshot Start()
+    {
+        _integral = _lastError = 0;
+        _next = TimeNow();
+        return _sensors.Read();
+    }
+
+    //Sets the motors for one reading
+    void Steer(const LineSnapshot &line)
+    {
+        float error, corr;
+        if (!_sensors.Offset(line, &error))
+        {
+            error = (_lastError < 0) ? -gains.lost : gains.lost;
+        }
+        _integral += error*LINE_PERIOD;
+        //Keep the integral from winding up past what it could ever correct
+        if (gains.ki > 0 && fabs(_integral*gains.ki) > gains.maxTurn)
+        {
+            _integral = (_integral < 0 ? -gains.maxTurn : gains.maxTurn)/gains.ki;
+        }
+        corr = gains.kp*error + gains.ki*_integral + gains.kd*(error - _lastError)/LINE_PERIOD;
+        _lastError = error;
+        if (corr > gains.maxTurn)
+        {
+            corr = gains.maxTurn;
+        } else if (corr < -gains.maxTurn)
+        {
+            corr = -gains.maxTurn;
+        }
+        //Turning towards a line on the right adds to the left motor's percent whichever way the robot is driving,
+        //forwards it speeds the left wheel up and backwards it slows it down
+        _left.SetPercent(gains.speed + corr);
+        _right.SetPercent(gains.speed - corr);
+    }
+
+    //Waits for the next period and reads the sensors again
+    LineSnapshot Next()
+    {
+        _next += LINE_PERIOD;
+        while (TimeNow() < _next)
+        {
+        }
+        return _sensors.Read();
+    }
+
+    void Stop()
+    {
+        _left.Stop();
+        _right.Stop();
+    }
+
+    /*Sets up Run() to follow the line for as long as keepGoing(arg, reading) returns true, arg is passed
+     through untouched so one test function can cover several end conditions*/
+    void Begin(bool (*keepGoing)(int, LineSnapshot), int arg)
+    {
+        _until = keepGoing;
+        _arg = arg;
+        _integral = _lastError = 0;
+    }
+
+    //One LINE_PERIOD of following, stops the motors and returns false once the end condition is met
+    bool Run()
+    {
+        LineSnapshot line = _sensors.Read();
+        if (!_until || !_until(_arg, line))
+        {
+            Stop();
+            return false;
+        }
+        Steer(line);
+        return true;
+    }
+
+    LineGains gains;
+
+private:
+    FEHMotor &_left;
+    FEHMotor &_right;
+    LineSensors &_sensors;
+    float _integral, _lastError;
+    double _next;
+    bool (*_until)(int, LineSnapshot);
+    int _arg;
+};
+
+#endif
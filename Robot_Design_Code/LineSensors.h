@@ -0,0 +1,83 @@
+#ifndef LINESENSORS_H
+#define LINESENSORS_H
+
+#include <FEHIO.h>
+#include <FEHUtility.h>
+
+//Bits of LineSnapshot::mask, set when that optosensor is over the line (reading above its break value)
+#define LINE_LEFT_BIT 1
+#define LINE_CENTER_BIT 2
+#define LINE_RIGHT_BIT 4
+
+//All three optosensors read once at the same moment
+struct LineSnapshot
+{
+    float left, center, right;
+    //Which sensors see the line, 0 means the robot is off the line
+    int mask;
+    double time;
+};
+
+/*Samples the three line following optosensors together. Every Value() is a separate ADC conversion,
+ so reading each sensor once per loop and classifying from the snapshot keeps the loop fast and makes
+ every decision in an iteration agree on what the sensors saw*/
+class LineSensors
+{
+public:
+    /*Breaks are the readings that separate off the line from on it, spans are how far each sensor's reading
+     moves between fully off and fully on, and are only needed for Offset()*/
+    LineSensors(AnalogInputPin &left, AnalogInputPin &center, AnalogInputPin &right, float leftBreak, float centerBreak, float rightBreak,
+                float leftSpan = 1.0, float centerSpan = 1.0, float rightSpan = 1.0)
+        : _left(left), _center(center), _right(right), _leftBreak(leftBreak), _centerBreak(centerBreak), _rightBreak(rightBreak),
+          _leftSpan(leftSpan), _centerSpan(centerSpan), _rightSpan(rightSpan)
+    {
+    }
+
+    LineSnapshot Read()
+    {
+        LineSnapshot s;
+        s.left = _left.Value();
+        s.center = _center.Value();
+        s.right = _right.Value();
+        s.time = TimeNow();
+        //Each comparison is 0 or 1, so the mask is built without branching
+        s.mask = (s.left > _leftBreak)*LINE_LEFT_BIT | (s.center > _centerBreak)*LINE_CENTER_BIT | (s.right > _rightBreak)*LINE_RIGHT_BIT;
+        return s;
+    }
+
+    //True if any sensor sees the line, for loops that drive until they reach one
+    bool OnLine()
+    {
+        return Read().mask != 0;
+    }
+
+    /*Where the line is across the sensors as a continuous value, -1 under the left sensor, 0 under the center
+     and 1 under the right, found from how far each reading is past its break value. Returns false if none
+     of the sensors can see the line*/
+    bool Offset(const LineSnapshot &s, float *offset)
+    {
+        float l = Amount(s.left, _leftBreak, _leftSpan);
+        float c = Amount(s.center, _centerBreak, _centerSpan);
+        float r = Amount(s.right, _rightBreak, _rightSpan);
+        if (s.mask == 0 || l + c + r <= 0)
+        {
+            return false;
+        }
+        *offset = (r - l)/(l + c + r);
+        return true;
+    }
+
+private:
+    //How much of a sensor is over the line, 0 to 1, with the break value as the halfway point
+    float Amount(float value, float brk, float span)
+    {
+        float a = (value - brk)/span + 0.5;
+        return (a < 0) ? 0 : (a > 1) ? 1 : a;
+    }
+
+    AnalogInputPin &_left, &_center, &_right;
+    float _leftBreak, _centerBreak, _rightBreak;
+    float _leftSpan, _centerSpan, _rightSpan;
+};
+
+#endif
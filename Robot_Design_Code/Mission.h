@@ -0,0 +1,255 @@
+#ifndef MISSION_H
+#define MISSION_H
+
+#include <FEHSD.h>
+#include <FEHUtility.h>
+
+//Version of the compiled step format, the first line of a compiled mission is "mission MISSION_VERSION <steps>"
+#define MISSION_VERSION 1
+//Most steps in one mission read from the SD card, every step read is kept so jumps back don't go to the SD card again
+//A program that only runs missions compiled into it can define it smaller before including this
+#ifndef MISSION_MAX
+#define MISSION_MAX 192
+#endif
+
+/*Mission operations. Each takes an integer arg, a step index target and three numbers a, b and c, and most
+ leave some of them unused. Inches, degrees, percent speeds and seconds like the rest of the robot code*/
+#define OP_END 0
+//Drive a inches at b percent, like linearMove(), with stall detection off if arg is 1 for a move into a lever or button
+#define OP_MOVE 1
+//Pivot a degrees (positive right) at b percent, like pivot()
+#define OP_PIVOT 2
+//Arc of radius a for b degrees at c percent, like arc()
+#define OP_ARC 3
+//Shift a inches right over b inches forward at c percent, like sidestep(), with stall detection off if arg is 1
+#define OP_SIDESTEP 4
+//Queue a line or pivot of a at b percent on the motion queue, stopping after it if arg is 1. OP_QRUN runs what is queued
+#define OP_QLINE 5
+#define OP_QPIVOT 6
+#define OP_QRUN 7
+//Drive to the pose a inches forward and b left of where the robot is, turned c degrees counter-clockwise, with goTo()
+#define OP_GOTO 8
+//Turn servo arg to a degrees and hold b seconds, waiting for it. OP_SERVO_START doesn't wait, OP_SYNC waits for every servo started
+#define OP_SERVO 9
+#define OP_SERVO_START 10
+#define OP_SYNC 11
+//Run into a wall with side arg at a percent, looking up to b inches, like hitWall()
+#define OP_WALL 12
+//Drive a inches at b percent until event arg, giving up after c seconds (0 for no limit)
+#define OP_UNTIL 13
+//Push at a percent until event arg, giving up after b seconds, backing off and retrying on a stall
+#define OP_PUSH 14
+//Follow the line until end condition arg, giving up after a inches or b seconds (0 for no limit), like lineFollow()
+#define OP_FOLLOW 15
+//Wait a seconds with the background tasks running
+#define OP_SLEEP 16
+//Read the jukebox light into the register, or the ice cream lever RPS reports
+#define OP_COLOR 17
+#define OP_LEVER 18
+//Go to step target, always or only if the register is arg
+#define OP_JUMP 19
+#define OP_IF 20
+//Start of course task arg, for the status display and the run log
+#define OP_TASK 21
+//Back along the ice cream lanes across arg lines without stopping, stopping on the last, like crossLanes(). Negative arg drives forward
+#define OP_LANES 22
+#define OP_COUNT 23
+
+//Course tasks OP_TASK can mark, in the order of MISSION_TASK_NAMES, which is what mission_compile calls them
+#define TASK_TRAY 0
+#define TASK_ICECREAM 1
+#define TASK_BURGER 2
+#define TASK_TICKET 3
+#define TASK_JUKEBOX 4
+#define TASK_FINAL 5
+#define TASK_COUNT 6
+#define MISSION_TASK_NAMES {"tray", "icecream", "burger", "ticket", "jukebox", "final"}
+
+//Why a mission stopped
+#define MISSION_DONE 0
+#define MISSION_NO_FILE 1
+#define MISSION_BAD_HEADER 2
+#define MISSION_BAD_STEP 3
+
+//One step of a mission, see the OP_ defines
+struct MissionStep
+{
+    int op;
+    int arg;
+    int target;
+    float a, b, c;
+};
+
+//True if every step of a mission compiled into the program is one Mission can run and it ends with OP_END,
+//for checking a table with static_assert so a bad one doesn't build
+constexpr bool MissionValid(const MissionStep *steps, int count, int index = 0)
+{
+    return index >= count ? count > 0 && steps[count - 1].op == OP_END :
+        steps[index].op >= 0 && steps[index].op < OP_COUNT &&
+        ((steps[index].op != OP_JUMP && steps[index].op != OP_IF) || (steps[index].target >= 0 && steps[index].target < count)) &&
+        MissionValid(steps, count, index + 1);
+}
+
+//True if a mission compiled into the program has a step of kind op, so the code for the kinds it doesn't use can be left out
+constexpr bool MissionUses(const MissionStep *steps, int count, int op)
+{
+    return count > 0 && (steps->op == op || MissionUses(steps + 1, count - 1, op));
+}
+
+/*Runs a mission compiled by Host_Sim's mission_compile from a file on the SD card, or from a table of steps
+ compiled into the program (mission_compile -c), which reads nothing and keeps nothing in RAM. Steps are read off the
+ card one line at a time as the mission reaches them rather than all at the start, so the first move
+ starts right away, and kept in RAM for any jump back. Jumps and branches are handled here, every other step
+ is handed to the action function, which returns the value OP_COLOR and OP_LEVER put in the register.
+
+ A step that makes no sense (unknown op, jump outside the mission, a line that doesn't scan) ends the
+ mission there rather than guessing, with the robot stopped*/
+class Mission
+{
+public:
+    Mission(int (*action)(const MissionStep &step)) : _action(action)
+    {
+        _file = 0;
+        _table = 0;
+        _count = _loaded = 0;
+        error = MISSION_NO_FILE;
+        failed = -1;
+        executed = 0;
+        overhead = 0;
+        reg = 0;
+    }
+
+    //Opens a compiled mission and checks its header, returns false if there is no usable one
+    bool Open(const char *filename)
+    {
+        int version = 0, count = 0;
+        Close();
+        _table = 0;
+        _file = SD.FOpen(filename, "r");
+        if (!_file)
+        {
+            error = MISSION_NO_FILE;
+            return false;
+        }
+        if (SD.FScanf(_file, "mission %d %d", &version, &count) != 2 || version != MISSION_VERSION || count < 1 || count > MISSION_MAX)
+        {
+            Close();
+            error = MISSION_BAD_HEADER;
+            return false;
+        }
+        _count = count;
+        _loaded = 0;
+        error = MISSION_DONE;
+        return true;
+    }
+
+    //Runs the steps of a table compiled into the program rather than a file, checked with MissionValid()
+    bool Use(const MissionStep *steps, int count)
+    {
+        Close();
+        _table = steps;
+        _count = count;
+        error = MISSION_DONE;
+        return true;
+    }
+
+    void Close()
+    {
+        if (_file)
+        {
+            SD.FClose(_file);
+            _file = 0;
+        }
+    }
+
+    //Runs the mission from the first step to OP_END, returns false if it stopped on a bad step
+    bool Run()
+    {
+        MissionStep step;
+        double start;
+        int pc = 0;
+        executed = 0;
+        overhead = 0;
+        reg = 0;
+        while (true)
+        {
+            start = TimeNow();
+            if (!Fetch(pc, &step))
+            {
+                error = MISSION_BAD_STEP;
+                failed = pc;
+                Close();
+                return false;
+            }
+            pc++;
+            overhead += TimeNow() - start;
+            executed++;
+            switch (step.op)
+            {
+            case OP_END:
+                Close();
+                return true;
+            case OP_JUMP:
+                pc = step.target;
+                break;
+            case OP_IF:
+                pc = (reg == step.arg) ? step.target : pc;
+                break;
+            case OP_COLOR:
+            case OP_LEVER:
+                reg = _action(step);
+                break;
+            default:
+                _action(step);
+                break;
+            }
+        }
+    }
+
+    //Why the last Open() or Run() stopped, and the step it stopped on if it was a bad one
+    int error, failed;
+    //Steps run, and seconds spent reading and dispatching them rather than in the actions
+    long executed;
+    double overhead;
+    //Last value OP_COLOR or OP_LEVER read
+    int reg;
+
+private:
+    //Gets step index, reading the mission up to it if it hasn't been yet
+    bool Fetch(int index, MissionStep *step)
+    {
+        MissionStep *s;
+        if (index < 0 || index >= _count)
+        {
+            return false;
+        }
+        if (_table)
+        {
+            *step = _table[index];
+            return true;
+        }
+        while (_loaded <= index)
+        {
+            s = &_steps[_loaded];
+            if (!_file || SD.FScanf(_file, "%d %d %d %f %f %f", &s->op, &s->arg, &s->target, &s->a, &s->b, &s->c) != 6)
+            {
+                return false;
+            }
+            if (s->op < 0 || s->op >= OP_COUNT || ((s->op == OP_JUMP || s->op == OP_IF) && (s->target < 0 || s->target >= _count)))
+            {
+                return false;
+            }
+            _loaded++;
+        }
+        *step = _steps[index];
+        return true;
+    }
+
+    int (*_action)(const MissionStep &step);
+    FEHFile *_file;
+    const MissionStep *_table;
+    MissionStep _steps[MISSION_MAX];
+    int _count, _loaded;
+};
+
+#endif
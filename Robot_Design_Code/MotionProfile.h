@@ -0,0 +1,154 @@
+#ifndef MOTIONPROFILE_H
+#define MOTIONPROFILE_H
+
+#include <math.h>
+
+/*Velocity profile for a single move: accelerate, cruise, decelerate. Distances are in inches and
+ velocities in inches per second, a pivot uses the arc length each wheel rolls. Moves too short to reach
+ the cruise speed become triangular. With sCurve set the speed changes follow a half cosine, which
+ takes pi/2 times longer for the same peak acceleration but starts and ends without a jerk.
+ A profile can start and end at a non-zero speed so that queued moves can be chained without stopping*/
+struct MotionProfile
+{
+    float distance;
+    float peak;
+    float accel;
+    bool sCurve;
+    //Speed at the start and end of the move
+    float startVel, endVel;
+    //Length of each phase in seconds
+    float tUp, tCruise, tDown;
+
+    MotionProfile()
+    {
+        distance = peak = accel = 0;
+        sCurve = false;
+        startVel = endVel = 0;
+        tUp = tCruise = tDown = 0;
+    }
+
+    /*Plans a move of distance inches limited to maxVel and maxAccel, distance is taken as a magnitude.
+     v0 and v1 are the entry and exit speeds, they must be reachable within the distance (MotionQueue
+     makes sure of that)*/
+    void Plan(float dist, float maxVel, float maxAccel, bool smooth, float v0 = 0, float v1 = 0)
+    {
+        float k;
+        distance = fabs(dist);
+        accel = maxAccel;
+        sCurve = smooth;
+        startVel = v0;
+        endVel = v1;
+        //Time to change speed is dv/a for a straight ramp, pi/2 times that for a half cosine
+        k = sCurve ? M_PI/2.0 : 1.0;
+        peak = maxVel;
+        if (peak < v0)
+        {
+            peak = v0;
+        }
+        if (peak < v1)
+        {
+            peak = v1;
+        }
+        //If both ramps don't fit, the profile peaks early
+        if (RampLength(v0, peak, k) + RampLength(v1, peak, k) > distance)
+        {
+            peak = sqrt((2*accel*distance/k + v0*v0 + v1*v1)/2);
+            //Unreachable entry or exit speeds, ramp as hard as allowed and let the position clamp at the end
+            if (peak < v0)
+            {
+                peak = v0;
+            }
+            if (peak < v1)
+            {
+                peak = v1;
+            }
+        }
+        tUp = (peak > 0) ? k*(peak - v0)/accel : 0;
+        tDown = (peak > 0) ? k*(peak - v1)/accel : 0;
+        tCruise = (peak > 0) ? (distance - RampLength(v0, peak, k) - RampLength(v1, peak, k))/peak : 0;
+        if (tCruise < 0)
+        {
+            tCruise = 0;
+        }
+    }
+
+    float Duration()
+    {
+        return tUp + tCruise + tDown;
+    }
+
+    //Speed the profile calls for t seconds into the move
+    float Velocity(float t)
+    {
+        if (t <= 0)
+        {
+            return startVel;
+        }
+        if (t >= Duration())
+        {
+            return endVel;
+        }
+        if (t < tUp)
+        {
+            return startVel + (peak - startVel)*Shape(t, tUp);
+        }
+        if (t < tUp + tCruise)
+        {
+            return peak;
+        }
+        return endVel + (peak - endVel)*Shape(Duration() - t, tDown);
+    }
+
+    //Distance the profile calls for t seconds into the move
+    float Position(float t)
+    {
+        float d;
+        if (t <= 0)
+        {
+            return 0;
+        }
+        if (t >= Duration())
+        {
+            return distance;
+        }
+        if (t < tUp)
+        {
+            return startVel*t + (peak - startVel)*ShapeArea(t, tUp);
+        }
+        if (t < tUp + tCruise)
+        {
+            return (startVel + peak)*tUp/2 + peak*(t - tUp);
+        }
+        d = Duration() - t;
+        return distance - endVel*d - (peak - endVel)*ShapeArea(d, tDown);
+    }
+
+private:
+    //Distance covered changing speed between v and peak at the planned acceleration
+    float RampLength(float v, float top, float k)
+    {
+        return k*(top*top - v*v)/(2*accel);
+    }
+
+    //Fraction of the speed change done t seconds into a ramp lasting len seconds
+    float Shape(float t, float len)
+    {
+        if (sCurve)
+        {
+            return (1 - cos(M_PI*t/len))/2;
+        }
+        return t/len;
+    }
+
+    //Integral of Shape() from the start of the ramp to t
+    float ShapeArea(float t, float len)
+    {
+        if (sCurve)
+        {
+            return (t - len/M_PI*sin(M_PI*t/len))/2;
+        }
+        return t*t/(2*len);
+    }
+};
+
+#endif
@@ -0,0 +1,215 @@
+#ifndef MOTIONQUEUE_H
+#define MOTIONQUEUE_H
+
+#include <math.h>
+#include "DriveControl.h"
+#include "Scheduler.h"
+
+//Most segments a single queue can hold before Run() has to be called
+#define QUEUE_MAX 16
+
+//Segment types for the motion queue
+#define SEG_LINE 0
+#define SEG_PIVOT 1
+#define SEG_ARC 2
+
+//One queued move, amounts are inches for lines and degrees for pivots and arcs
+struct MotionSegment
+{
+    int type;
+    float amount;
+    float radius;
+    float speed;
+    //Come to a full stop at the end of this segment
+    bool stop;
+};
+
+/*Queue of moves that are run back to back without stopping in between. Speeds at each boundary
+ are planned ahead so the robot only slows down as much as the next segment needs, and a pivot
+ between two lines going the same way is rounded off into an arc of radius blend so the robot can
+ keep rolling through the corner. The robot only comes to a full stop where a segment asks for one,
+ where a wheel has to change direction, and at the end of the queue. Given a scheduler the segments are
+ stepped by it, so its other tasks keep running while the queue drives*/
+class MotionQueue
+{
+public:
+    MotionQueue(DriveController &drive, Scheduler *scheduler = 0) : _drive(drive), _scheduler(scheduler)
+    {
+        _count = 0;
+        blend = 6.0;
+    }
+
+    //Queues a straight move, negative distance backs up
+    void Line(float distance, float speed, bool stop = false)
+    {
+        Add(SEG_LINE, distance, 0, speed, stop);
+    }
+
+    //Queues a pivot in place, positive degrees turn right
+    void Pivot(float degrees, float speed, bool stop = false)
+    {
+        Add(SEG_PIVOT, degrees, 0, speed, stop);
+    }
+
+    //Queues an arc, see DriveController::Arc() for the signs
+    void Arc(float radius, float degrees, float speed, bool stop = false)
+    {
+        Add(SEG_ARC, degrees, radius, speed, stop);
+    }
+
+    //Runs everything queued and empties the queue, the robot is stopped when it returns
+    void Run()
+    {
+        float left[QUEUE_MAX], right[QUEUE_MAX], length[QUEUE_MAX], cap[QUEUE_MAX], v[QUEUE_MAX + 1];
+        float accel = _drive.gains.accel;
+        int i;
+
+        Round();
+        for (i = 0; i < _count; i++)
+        {
+            Geometry(_seg[i], &left[i], &right[i], &length[i]);
+            cap[i] = fabs(_seg[i].speed)/_drive.gains.kv/fmax(fabs(left[i]), fabs(right[i]));
+        }
+
+        //Speed allowed at each boundary: the slower of the two segments, zero to stop or reverse a wheel
+        v[0] = 0;
+        v[_count] = 0;
+        for (i = 1; i < _count; i++)
+        {
+            v[i] = fmin(cap[i - 1], cap[i]);
+            if (_seg[i - 1].stop || left[i - 1]*left[i] < 0 || right[i - 1]*right[i] < 0)
+            {
+                v[i] = 0;
+            }
+        }
+        //Make sure every boundary speed can be slowed down from and sped up to in the distance available
+        for (i = _count - 1; i >= 0; i--)
+        {
+            v[i] = fmin(v[i], sqrt(v[i + 1]*v[i + 1] + 2*accel*length[i]));
+        }
+        for (i = 0; i < _count; i++)
+        {
+            v[i + 1] = fmin(v[i + 1], sqrt(v[i]*v[i] + 2*accel*length[i]));
+        }
+
+        for (i = 0; i < _count; i++)
+        {
+            _drive.profile.Plan(length[i], cap[i], accel, _drive.gains.sCurve, v[i], v[i + 1]);
+            if (_scheduler)
+            {
+                _drive.Begin(left[i], right[i], v[i + 1] == 0);
+                _scheduler->Run(_drive, DRIVE_PERIOD);
+            } else
+            {
+                _drive.Follow(left[i], right[i], v[i + 1] == 0);
+            }
+        }
+        _count = 0;
+    }
+
+    //Radius in inches used to round off pivots between lines, zero keeps every pivot sharp
+    float blend;
+
+private:
+    void Add(int type, float amount, float radius, float speed, bool stop)
+    {
+        //A full queue runs what it has so far rather than dropping moves
+        if (_count == QUEUE_MAX)
+        {
+            Run();
+        }
+        _seg[_count].type = type;
+        _seg[_count].amount = amount;
+        _seg[_count].radius = radius;
+        _seg[_count].speed = speed;
+        _seg[_count].stop = stop;
+        _count++;
+    }
+
+    //Replaces line, pivot, line corners with line, arc, line where the lines leave enough room
+    void Round()
+    {
+        float r, cut, turn, dir;
+        int i, j;
+        if (blend <= 0)
+        {
+            return;
+        }
+        for (i = 1; i < _count - 1; i++)
+        {
+            MotionSegment &before = _seg[i - 1], &corner = _seg[i], &after = _seg[i + 1];
+            if (corner.type != SEG_PIVOT || before.type != SEG_LINE || after.type != SEG_LINE)
+            {
+                continue;
+            }
+            if (before.stop || corner.stop || before.amount*after.amount <= 0 || fabs(corner.amount) >= 150)
+            {
+                continue;
+            }
+            //The arc is tangent to both lines, so each line gives up cut inches to it
+            turn = fabs(corner.amount)*M_PI/180.0;
+            r = blend;
+            cut = r*tan(turn/2);
+            if (cut > fabs(before.amount) || cut > fabs(after.amount))
+            {
+                cut = fmin(fabs(before.amount), fabs(after.amount));
+                r = cut/tan(turn/2);
+            }
+            //Too tight to be worth it, the inner wheel would have to run backwards
+            if (r < _drive.TrackWidth()/2)
+            {
+                continue;
+            }
+            dir = (before.amount > 0) ? 1 : -1;
+            before.amount -= dir*cut;
+            after.amount -= dir*cut;
+            corner.type = SEG_ARC;
+            corner.radius = dir*r;
+            corner.speed = fmax(corner.speed, fmin(before.speed, after.speed));
+        }
+        //Drop lines the arcs used up completely, handing any stop back to the segment before
+        for (i = 0, j = 0; i < _count; i++)
+        {
+            if (_seg[i].type == SEG_LINE && fabs(_seg[i].amount) < 0.01)
+            {
+                if (_seg[i].stop && j > 0)
+                {
+                    _seg[j - 1].stop = true;
+                }
+                continue;
+            }
+            _seg[j++] = _seg[i];
+        }
+        _count = j;
+    }
+
+    //Wheel ratios and profile length of a segment, as DriveController::Follow() wants them
+    void Geometry(const MotionSegment &seg, float *left, float *right, float *length)
+    {
+        float dir = (seg.amount < 0) ? -1 : 1;
+        switch (seg.type)
+        {
+        case SEG_LINE:
+            *left = dir;
+            *right = dir;
+            *length = fabs(seg.amount);
+            break;
+        case SEG_PIVOT:
+            *left = dir;
+            *right = -dir;
+            *length = M_PI*_drive.TrackWidth()*fabs(seg.amount)/360.0;
+            break;
+        default:
+            _drive.ArcRatios(seg.radius, seg.amount, left, right);
+            *length = fabs(seg.radius*seg.amount)*M_PI/180.0;
+            break;
+        }
+    }
+
+    DriveController &_drive;
+    Scheduler *_scheduler;
+    MotionSegment _seg[QUEUE_MAX];
+    int _count;
+};
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef NAVIGATOR_H
+#define NAVIGATOR_H
+
+#include <FEHUtility.h>
+#include <math.h>
+#include "DriveControl.h"
+#include "Kinematics.h"
+#include "PoseEstimator.h"
+#include "Scheduler.h"
+
+//Heading to pass GoTo() when the robot can end up facing any way
+#define GOTO_ANY_HEADING -1000
+
+//How a GoTo() went, judged by the pose estimate
+struct GoToResult
+{
+    //Seconds from the call to the robot stopping at the target
+    double elapsed;
+    //Inches from the target and degrees off the heading at the end (0 if any heading would do)
+    float error, headingError;
+    //Turn and drive legs it took, more than one means the first one came up short
+    int legs;
+};
+
+/*Drives to a point on the course using the pose estimate. Each leg turns to face the target (or to face
+ away from it and back up, if that is less turning counting the final turn to the heading) and drives the
+ distance, then the pose estimate is checked and another leg corrects whatever error is left, up to legs
+ times, as long as it can without turning more than correctTurn degrees. An error off to the side would take
+ two big turns to drive out, which costs more than it is worth. A final turn sets the heading. A drive leg
+ that stalls is not retried, the robot turns to the heading from where it stopped.
+
+ After a stop that RPS fixes came in during, the robot waits settle seconds for the rest of them to catch up
+ with the odometry before the next check, since RPS reports where the robot was a little while ago. Without
+ fixes there is nothing to wait for. Given the drive calibration, turns ask for its TurnCommand() the way
+ pivot() does, so they don't overshoot by the calibrated turn offset*/
+class Navigator
+{
+public:
+    Navigator(Scheduler &scheduler, DriveController &drive, PoseEstimator &pose, Kinematics *kinematics = 0)
+        : _scheduler(scheduler), _drive(drive), _pose(pose), _kinematics(kinematics)
+    {
+        tolerance = 0.5;
+        headingTolerance = 2.0;
+        legs = 3;
+        correctTurn = 30;
+        reverse = true;
+        settle = 0.2;
+    }
+
+    //Drives to x, y and turns to heading (degrees counter-clockwise like RPS, or GOTO_ANY_HEADING)
+    GoToResult GoTo(float x, float y, float heading, float speed, float turnSpeed)
+    {
+        GoToResult result;
+        double start = TimeNow();
+        float distance, bearing, turn, dir;
+        int i;
+        result.legs = 0;
+        for (i = 0; i < legs; i++)
+        {
+            distance = _pose.Distance(x, y);
+            if (distance <= tolerance)
+            {
+                break;
+            }
+            bearing = _pose.Bearing(x, y);
+            turn = PoseEstimator::Wrap(bearing - _pose.pose.heading);
+            dir = 1;
+            if (reverse && Turning(turn + 180, bearing + 180, heading) < Turning(turn, bearing, heading))
+            {
+                turn = PoseEstimator::Wrap(turn + 180);
+                dir = -1;
+            }
+            if (i > 0 && fabs(turn) > correctTurn)
+            {
+                break;
+            }
+            if (fabs(turn) > headingTolerance)
+            {
+                Turn(turn, turnSpeed);
+            }
+            Drive(dir*distance, speed);
+            result.legs++;
+            //Something is in the way, another leg would only push on it
+            if (_drive.stalled)
+            {
+                break;
+            }
+        }
+        for (i = 0; heading != GOTO_ANY_HEADING && i < legs; i++)
+        {
+            turn = PoseEstimator::Wrap(heading - _pose.pose.heading);
+            if (fabs(turn) <= headingTolerance)
+            {
+                break;
+            }
+            Turn(turn, turnSpeed);
+        }
+        result.elapsed = TimeNow() - start;
+        result.error = _pose.Distance(x, y);
+        result.headingError = (heading == GOTO_ANY_HEADING) ? 0 : fabs(PoseEstimator::Wrap(heading - _pose.pose.heading));
+        return result;
+    }
+
+    //Pose forward and left inches from a pose in its own frame, turned by turn degrees counter-clockwise
+    static Pose Offset(Pose from, float forward, float left, float turn)
+    {
+        Pose to;
+        float h = from.heading*M_PI/180.0;
+        to.x = from.x + forward*cos(h) - left*sin(h);
+        to.y = from.y + forward*sin(h) + left*cos(h);
+        to.heading = PoseEstimator::Wrap(from.heading + turn);
+        return to;
+    }
+
+    //Inches from the target that counts as there, and degrees off the heading
+    float tolerance, headingTolerance;
+    //Most turn and drive legs tried
+    int legs;
+    //Most degrees a leg after the first turns to correct the error left
+    float correctTurn;
+    //Backs up to targets behind the robot instead of turning around
+    bool reverse;
+    //Seconds waited after a stop RPS fixes came in during, for the rest of them to catch up
+    float settle;
+
+private:
+    //Degrees turned facing along bearing to drive, turn being the turn onto it, and from it to the heading
+    float Turning(float turn, float bearing, float heading)
+    {
+        float total = fabs(PoseEstimator::Wrap(turn));
+        if (heading != GOTO_ANY_HEADING)
+        {
+            total += fabs(PoseEstimator::Wrap(heading - bearing));
+        }
+        return total;
+    }
+
+    //Turns degrees counter-clockwise, the drive's Turn() takes clockwise as positive
+    void Turn(float degrees, float speed)
+    {
+        long fixes = _pose.fixes;
+        _scheduler.Wait(_drive);
+        _drive.StartTurn(_kinematics ? _kinematics->TurnCommand(-degrees) : -degrees, speed);
+        _scheduler.Run(_drive, DRIVE_PERIOD);
+        Settle(fixes);
+    }
+
+    void Drive(float distance, float speed)
+    {
+        long fixes = _pose.fixes;
+        _scheduler.Wait(_drive);
+        _drive.StartDrive(distance, speed);
+        _scheduler.Run(_drive, DRIVE_PERIOD);
+        Settle(fixes);
+    }
+
+    //Keeps the other tasks running while RPS catches up, if any fixes came in since there were the given number
+    void Settle(long fixes)
+    {
+        double end = TimeNow() + ((_pose.fixes != fixes) ? settle : 0);
+        while (TimeNow() < end)
+        {
+            _scheduler.Poll();
+        }
+    }
+
+    Scheduler &_scheduler;
+    DriveController &_drive;
+    PoseEstimator &_pose;
+    Kinematics *_kinematics;
+};
+
+#endif
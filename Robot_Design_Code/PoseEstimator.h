@@ -0,0 +1,241 @@
+#ifndef POSEESTIMATOR_H
+#define POSEESTIMATOR_H
+
+#include <FEHIO.h>
+#include <FEHRPS.h>
+#include <FEHAccel.h>
+#include <FEHUtility.h>
+#include <math.h>
+#include "Scheduler.h"
+
+//Period of the odometry task in seconds (100 Hz)
+#define POSE_PERIOD 0.01
+//Odometry poses kept to line RPS fixes up with, enough to cover POSE_HISTORY*POSE_PERIOD seconds of RPS latency
+#define POSE_HISTORY 64
+//RPS is read once every this many odometry periods, and the accelerometer once every this many
+#define POSE_RPS_EVERY 5
+#define POSE_ACCEL_EVERY 5
+
+//Where the robot is, in RPS coordinates: inches, and degrees counter-clockwise from +x
+struct Pose
+{
+    float x, y, heading;
+};
+
+/*Keeps track of where the robot is on the course. Encoder odometry runs every POSE_PERIOD and carries
+ the pose between RPS fixes, and each fix pulls the pose part of the way towards itself.
+
+ The shaft encoders only count edges, so which way each wheel turned comes from the sign of the power it
+ was last given, through the powers function. RPS reports where the robot was latency seconds ago, so a fix
+ is compared with the odometry pose from that moment and the difference is added to the current pose.
+ Dropouts (negative readings) are skipped, a fix that hasn't changed since the last one isn't counted twice,
+ and a fix too far from the estimate is thrown out unless several in a row agree, which means the
+ estimate is the one that is wrong.
+
+ With useTilt set the accelerometer's pitch tells when the robot is on the ramp, where the wheels roll
+ further than the robot moves across the course*/
+class PoseEstimator : public Task
+{
+public:
+    //countsPerInch and track (wheel to wheel inches) are the drive's, powers gives the power each motor was last sent
+    PoseEstimator(DigitalEncoder &leftEnc, DigitalEncoder &rightEnc, float countsPerInch, float track, void (*powers)(float *, float *))
+        : _leftEnc(leftEnc), _rightEnc(rightEnc), _countsPerInch(countsPerInch), _track(track), _powers(powers)
+    {
+        latency = 0.15;
+        positionGain = 0.3;
+        headingGain = 0.3;
+        gate = 6.0;
+        useTilt = false;
+        rampTilt = 6.0;
+        tilt = 0;
+        onRamp = false;
+        Set(0, 0, 0);
+    }
+
+    //Puts the robot at a known pose and starts counting from the encoders' current counts
+    void Set(float x, float y, float heading)
+    {
+        int i;
+        pose.x = x;
+        pose.y = y;
+        pose.heading = Wrap(heading);
+        for (i = 0; i < POSE_HISTORY; i++)
+        {
+            _history[i] = pose;
+        }
+        _newest = 0;
+        _runs = 0;
+        _leftLast = _leftEnc.Counts();
+        _rightLast = _rightEnc.Counts();
+        _leftDir = _rightDir = 1;
+        _lastFix.x = _lastFix.y = _lastFix.heading = -1;
+        _misses = 0;
+        fixes = rejected = 0;
+    }
+
+    //Takes the pose straight from RPS, returns false if there is no signal
+    bool SetFromRPS()
+    {
+        float x = RPS.X(), y = RPS.Y(), heading = RPS.Heading();
+        if (x < 0 || y < 0 || heading < 0)
+        {
+            return false;
+        }
+        Set(x, y, heading);
+        return true;
+    }
+
+    //One period of odometry, and an RPS and tilt check when they are due. Runs forever as a scheduler task
+    bool Run()
+    {
+        Odometry();
+        if (useTilt && _runs % POSE_ACCEL_EVERY == 0)
+        {
+            Tilt();
+        }
+        if (_runs % POSE_RPS_EVERY == 0)
+        {
+            Fix();
+        }
+        _runs++;
+        return true;
+    }
+
+    //Changes the geometry odometry works from, to match the drive's
+    void SetGeometry(float countsPerInch, float track)
+    {
+        _countsPerInch = countsPerInch;
+        _track = track;
+    }
+
+    //Distance in inches and the heading in degrees from the current pose to a point
+    float Distance(float x, float y)
+    {
+        return hypot(x - pose.x, y - pose.y);
+    }
+
+    float Bearing(float x, float y)
+    {
+        return Wrap(atan2(y - pose.y, x - pose.x)*180.0/M_PI);
+    }
+
+    //Angle in -180 to 180 degrees
+    static float Wrap(float degrees)
+    {
+        degrees = fmod(degrees, 360.0);
+        if (degrees > 180)
+        {
+            degrees -= 360;
+        } else if (degrees <= -180)
+        {
+            degrees += 360;
+        }
+        return degrees;
+    }
+
+    //Best estimate of where the robot is now
+    Pose pose;
+    //Seconds from the robot being somewhere to RPS reporting it
+    float latency;
+    //Fraction of the way each RPS fix moves the position and the heading
+    float positionGain, headingGain;
+    //Fixes further than this many inches from the estimate are thrown out
+    float gate;
+    //Reads the accelerometer for the ramp, and the pitch in degrees past which the robot is on it
+    bool useTilt;
+    float rampTilt;
+    //Last pitch read in degrees, and whether that puts the robot on the ramp
+    float tilt;
+    bool onRamp;
+    //RPS fixes used and thrown out since the pose was last set
+    long fixes, rejected;
+
+private:
+    void Odometry()
+    {
+        float leftPower, rightPower, left, right, distance, turn, mid;
+        int leftCounts = _leftEnc.Counts(), rightCounts = _rightEnc.Counts();
+        _powers(&leftPower, &rightPower);
+        //A stopped motor keeps the direction it last turned in while the robot coasts
+        _leftDir = (leftPower > 0) ? 1 : (leftPower < 0) ? -1 : _leftDir;
+        _rightDir = (rightPower > 0) ? 1 : (rightPower < 0) ? -1 : _rightDir;
+        //Moves reset the counts when they start, anything counted since is new
+        left = _leftDir*((leftCounts >= _leftLast) ? leftCounts - _leftLast : leftCounts)/_countsPerInch;
+        right = _rightDir*((rightCounts >= _rightLast) ? rightCounts - _rightLast : rightCounts)/_countsPerInch;
+        _leftLast = leftCounts;
+        _rightLast = rightCounts;
+
+        distance = (left + right)/2;
+        if (onRamp)
+        {
+            distance *= cos(tilt*M_PI/180.0);
+        }
+        turn = (right - left)/_track*180.0/M_PI;
+        mid = (pose.heading + turn/2)*M_PI/180.0;
+        pose.x += distance*cos(mid);
+        pose.y += distance*sin(mid);
+        pose.heading = Wrap(pose.heading + turn);
+        _newest = (_newest + 1) % POSE_HISTORY;
+        _history[_newest] = pose;
+    }
+
+    void Tilt()
+    {
+        tilt = atan2(Accel.X(), Accel.Z())*180.0/M_PI;
+        onRamp = fabs(tilt) > rampTilt;
+    }
+
+    void Fix()
+    {
+        Pose fix, then;
+        float dx, dy, dh;
+        int i, back;
+        fix.x = RPS.X();
+        fix.y = RPS.Y();
+        fix.heading = RPS.Heading();
+        //No signal, or the same packet as last time
+        if (fix.x < 0 || fix.y < 0 || fix.heading < 0 ||
+            (fix.x == _lastFix.x && fix.y == _lastFix.y && fix.heading == _lastFix.heading))
+        {
+            return;
+        }
+        _lastFix = fix;
+        //Odometry's pose at the moment RPS saw the robot
+        back = (int)(latency/POSE_PERIOD + 0.5);
+        back = (back >= POSE_HISTORY) ? POSE_HISTORY - 1 : back;
+        then = _history[(_newest - back + POSE_HISTORY) % POSE_HISTORY];
+        dx = fix.x - then.x;
+        dy = fix.y - then.y;
+        dh = Wrap(fix.heading - then.heading);
+        if (hypot(dx, dy) > gate && ++_misses < 5)
+        {
+            rejected++;
+            return;
+        }
+        _misses = 0;
+        fixes++;
+        dx *= positionGain;
+        dy *= positionGain;
+        dh *= headingGain;
+        //The whole history moves with the correction so the next fix is compared against corrected poses
+        for (i = 0; i < POSE_HISTORY; i++)
+        {
+            _history[i].x += dx;
+            _history[i].y += dy;
+            _history[i].heading = Wrap(_history[i].heading + dh);
+        }
+        pose = _history[_newest];
+    }
+
+    DigitalEncoder &_leftEnc;
+    DigitalEncoder &_rightEnc;
+    float _countsPerInch, _track;
+    void (*_powers)(float *, float *);
+    Pose _history[POSE_HISTORY], _lastFix;
+    int _newest, _misses;
+    long _runs;
+    int _leftLast, _rightLast;
+    float _leftDir, _rightDir;
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef ROBOTCONFIG_H
+#define ROBOTCONFIG_H
+
+//The robot's drive and servo constants, kept here so main.cpp and Host_Sim's benches work from the same numbers
+
+/*Definition for a standard power for use with IGWAN motor movement.
+ Useful because it allows universal changes with one adjustment. Must be a value between -100 and 100.*/
+#define MOVE 50
+#define TURN 25
+//Definition for wheel diameter in inches
+#define WHEEL 2.5
+//Definition for distance between wheels (Wheel to Wheel) in inches
+#define W2W 7.5
+//Encoder counts per wheel revolution
+#define COUNTS_PER_REV 318
+
+//Defining min and max for servos
+#define SERVO_ARM_MAX 2350
+#define SERVO_ARM_MIN 500
+#define SERVO_FORK_MAX 2350
+#define SERVO_FORK_MIN 500
+//Horn speed of the servos in degrees per second, 0.23 s per 60 degrees at 4.8V
+#define SERVO_SPEED 260
+/*Seconds the fork holds the wheel over once it has turned, for the hotplate to finish falling (was a flat 2 s sleep
+ including the turn, which is what was tested). The turn is timed at the no-load SERVO_SPEED and the wheel slows the
+ horn, so this covers the turn taking twice as long plus 0.3 s for the plate to fall, with a margin on top, until the
+ flip has been timed on the table*/
+#define FLIP_HOLD 1.0
+
+#endif
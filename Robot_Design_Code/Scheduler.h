@@ -0,0 +1,300 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <FEHUtility.h>
+
+//Most tasks the scheduler can run at once
+#define SCHED_MAX 12
+
+//How a task has kept to its rate
+struct TaskStats
+{
+    //Periods the task ran in, and periods it never got to run in because it was still late from the one before
+    long runs, misses;
+    //How long after its release time the task started, in seconds
+    double totalLate, worstLate;
+    //Seconds spent inside Run()
+    double busy;
+};
+
+//Something the scheduler runs at a fixed rate. Run() does one period's worth of work and returns false once
+//the task is finished, which takes it off the scheduler
+class Task
+{
+public:
+    Task()
+    {
+        ResetStats();
+        starts = 0;
+    }
+    virtual ~Task() {}
+    virtual bool Run() = 0;
+
+    void ResetStats()
+    {
+        stats.runs = stats.misses = 0;
+        stats.totalLate = stats.worstLate = stats.busy = 0;
+    }
+
+    //Kept across every time the task is added, until the scheduler's stats are reset
+    TaskStats stats;
+    //Times the task has been added to a scheduler, tells one run of a task from the next
+    long starts;
+};
+
+//Calls a plain function every period, for periodic jobs like the display that never finish
+class FunctionTask : public Task
+{
+public:
+    FunctionTask(void (*fn)()) : _fn(fn)
+    {
+    }
+
+    bool Run()
+    {
+        _fn();
+        return true;
+    }
+
+private:
+    void (*_fn)();
+};
+
+/*Cooperative fixed-rate scheduler. Each task is released once per period from a tick source and run to
+ completion, so nothing needs locking, but a task that takes longer than the others' periods makes them
+ late. When several tasks are due the one whose deadline (its next release) comes first runs first.
+ A task that is still not running by its next release has missed that period, it's counted and skipped
+ rather than run twice back to back.
+
+ The tick is TimeNow() unless another clock is given, so a host benchmark can run it on a simulated tick.
+ Blocking helpers start a task and Wait() for it, which keeps every other task running in the meantime*/
+class Scheduler
+{
+public:
+    Scheduler(double (*tick)() = TimeNow) : _tick(tick)
+    {
+        int i;
+        for (i = 0; i < SCHED_MAX; i++)
+        {
+            _slot[i].task = 0;
+        }
+        _busy = 0;
+        _start = _tick();
+        _running = -1;
+    }
+
+    //Adds a task released every period seconds, starting now. Returns false if the scheduler is full
+    bool Add(Task &task, double period)
+    {
+        int i = Find(0);
+        if (Find(&task) >= 0)
+        {
+            return true;
+        }
+        if (i < 0)
+        {
+            return false;
+        }
+        _slot[i].task = &task;
+        task.starts++;
+        _slot[i].period = period;
+        _slot[i].next = _tick();
+        return true;
+    }
+
+    void Remove(Task &task)
+    {
+        int i = Find(&task);
+        if (i >= 0)
+        {
+            _slot[i].task = 0;
+        }
+    }
+
+    //True while the task is on the scheduler
+    bool Active(Task &task)
+    {
+        return Find(&task) >= 0;
+    }
+
+    /*Runs the most urgent task that is due, or waits until one is. Returns after running one task so
+     callers can check their own conditions between them*/
+    void Poll()
+    {
+        double now = _tick(), soonest = 0, start;
+        int i, best = -1;
+        bool any = false;
+        for (i = 0; i < SCHED_MAX; i++)
+        {
+            if (!_slot[i].task)
+            {
+                continue;
+            }
+            if (!any || _slot[i].next < soonest)
+            {
+                soonest = _slot[i].next;
+                any = true;
+            }
+            if (_slot[i].next <= now && (best < 0 || _slot[i].next + _slot[i].period < _slot[best].next + _slot[best].period))
+            {
+                best = i;
+            }
+        }
+        if (best < 0)
+        {
+            //Nothing due, idle until the next release
+            while (any && _tick() < soonest)
+            {
+            }
+            return;
+        }
+
+        Slot &s = _slot[best];
+        Task *task = s.task;
+        Late(s, now);
+        start = _tick();
+        _running = best;
+        if (!task->Run())
+        {
+            s.task = 0;
+        }
+        _running = -1;
+        start = _tick() - start;
+        task->stats.busy += start;
+        _busy += start;
+        s.next += s.period;
+    }
+
+    //Runs the scheduler until task finishes
+    void Wait(Task &task)
+    {
+        while (Active(task))
+        {
+            Poll();
+        }
+    }
+
+    /*Adds a task and waits for it to finish. If the scheduler is full the task is stepped here on its own
+     instead, see Step(), and false comes back so the caller knows nothing else ran meanwhile*/
+    bool Run(Task &task, double period)
+    {
+        if (Add(task, period))
+        {
+            Wait(task);
+            return true;
+        }
+        Step(task, period);
+        return false;
+    }
+
+    /*Runs a task at its period until it finishes without putting it on the scheduler, for a task that has
+     already started moving something and found no room. The other tasks wait until it is done*/
+    void Step(Task &task, double period)
+    {
+        double next = _tick();
+        while (task.Run())
+        {
+            next += period;
+            while (_tick() < next)
+            {
+            }
+        }
+    }
+
+    /*Seconds until any task other than the one running is released, so a task with work that can wait can
+     tell whether doing it now would hold the others up. 0 when one is already due, 1e9 when there are no others*/
+    double Slack()
+    {
+        double now = _tick(), slack = 1e9;
+        int i;
+        for (i = 0; i < SCHED_MAX; i++)
+        {
+            if (_slot[i].task && i != _running && _slot[i].next - now < slack)
+            {
+                slack = _slot[i].next - now;
+            }
+        }
+        return (slack > 0) ? slack : 0;
+    }
+
+    /*Waits seconds with every task still running, in place of Sleep() once tasks have been added. Ends at the
+     first release after the time is up, so a little late when the shortest period on the scheduler is long*/
+    void Pause(double seconds)
+    {
+        double end = _tick() + seconds;
+        while (_tick() < end)
+        {
+            Poll();
+        }
+    }
+
+    //Fraction of the time since the stats were reset that was spent inside tasks
+    double Utilisation()
+    {
+        double elapsed = _tick() - _start;
+        return (elapsed > 0) ? _busy/elapsed : 0;
+    }
+
+    //Clears the scheduler's utilisation and the stats of every task on it
+    void ResetStats()
+    {
+        int i;
+        for (i = 0; i < SCHED_MAX; i++)
+        {
+            if (_slot[i].task)
+            {
+                _slot[i].task->ResetStats();
+            }
+        }
+        _busy = 0;
+        _start = _tick();
+    }
+
+private:
+    struct Slot
+    {
+        Task *task;
+        double period, next;
+    };
+
+    int Find(Task *task)
+    {
+        int i;
+        for (i = 0; i < SCHED_MAX; i++)
+        {
+            if (_slot[i].task == task)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    //Records how late a task is starting, skipping the releases it has already missed
+    void Late(Slot &s, double now)
+    {
+        TaskStats &stats = s.task->stats;
+        double late = now - s.next;
+        long missed = (long)(late/s.period);
+        if (missed > 0)
+        {
+            stats.misses += missed;
+            s.next += missed*s.period;
+            late -= missed*s.period;
+        }
+        stats.runs++;
+        stats.totalLate += late;
+        if (late > stats.worstLate)
+        {
+            stats.worstLate = late;
+        }
+    }
+
+    double (*_tick)();
+    Slot _slot[SCHED_MAX];
+    double _start, _busy;
+    //Slot of the task inside Run(), -1 between tasks
+    int _running;
+};
+
+#endif
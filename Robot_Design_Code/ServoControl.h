@@ -0,0 +1,156 @@
+#ifndef SERVOCONTROL_H
+#define SERVOCONTROL_H
+
+#include <FEHServo.h>
+#include <FEHUtility.h>
+#include <math.h>
+#include "Scheduler.h"
+
+//Period of the servo tasks in seconds, one servo pulse frame
+#define SERVO_PERIOD 0.02
+//Pulse width change in microseconds that turns a standard servo horn one degree (1000 us to 2000 us is 90 degrees)
+#define SERVO_US_PER_DEGREE (1000.0/90.0)
+
+/*A servo that knows where it is. FEHServo::SetDegree() maps 0-180 onto the calibrated SetMin()/SetMax()
+ pulse widths, so a commanded degree turns the horn (max - min)/180 microseconds worth of real degrees, and
+ the horn turns at a fixed angular speed. From that each move gets a predicted completion time, so callers
+ only wait as long as the move physically takes instead of a fixed Sleep().
+
+ Move() jumps the command straight to the target and the servo gets there at full speed, Sweep() steps the
+ command towards it every SERVO_PERIOD at a lower speed. Either one can be waited on with Wait(), or run as
+ a scheduler Task until it is done*/
+class ServoController : public Task
+{
+public:
+    //min and max are the calibrated pulse widths in microseconds, speed is the horn's degrees per second
+    ServoController(FEHServo &servo, int min, int max, float speed) : speed(speed), _servo(servo), _min(min), _max(max)
+    {
+        //Where the horn is at power on is unknown, the first move is planned as a full sweep
+        _degree = _target = 0;
+        _known = false;
+        _rate = _hold = 0;
+        _done = _last = 0;
+    }
+
+    //Sends the calibration to the servo, call before the first move
+    void Init()
+    {
+        _servo.SetMin(_min);
+        _servo.SetMax(_max);
+    }
+
+    //Real degrees the horn turns for one commanded degree
+    float Scale()
+    {
+        return (_max - _min)/(180.0*SERVO_US_PER_DEGREE);
+    }
+
+    //Seconds the horn takes to turn between two commanded angles at full speed
+    float TravelTime(float from, float to)
+    {
+        return fabs(to - from)*Scale()/speed;
+    }
+
+    //Commands degree at once, the move finishes when the horn gets there plus hold seconds
+    void Move(float degree, float hold = 0)
+    {
+        float from = _known ? _degree : (degree < 90 ? 180 : 0);
+        degree = Clamp(degree);
+        _servo.SetDegree(degree);
+        _done = TimeNow() + TravelTime(from, degree) + hold;
+        _degree = _target = degree;
+        _rate = 0;
+        _hold = hold;
+        _known = true;
+    }
+
+    /*Turns to degree at rate commanded degrees per second or the servo's own speed if that is slower, then
+     holds for hold seconds. Run() has to be called every SERVO_PERIOD to step the command along*/
+    void Sweep(float degree, float rate, float hold = 0)
+    {
+        if (!_known || rate <= 0 || rate >= speed/Scale())
+        {
+            Move(degree, hold);
+            return;
+        }
+        _target = Clamp(degree);
+        _rate = rate;
+        _hold = hold;
+        _last = TimeNow();
+        _done = _last + fabs(_target - _degree)/rate + hold;
+    }
+
+    //Commanded angle, during a sweep this is where it has got to so far
+    float Degree()
+    {
+        return _degree;
+    }
+
+    //Seconds until the current move is predicted to be done, 0 if it already is
+    float Remaining()
+    {
+        double left = _done - TimeNow();
+        return (left > 0) ? left : 0;
+    }
+
+    bool Done()
+    {
+        return Remaining() == 0;
+    }
+
+    //Steps a sweep, returns false once the move is done
+    bool Run()
+    {
+        double now = TimeNow();
+        float step;
+        if (_degree != _target)
+        {
+            step = _rate*(now - _last);
+            if (fabs(_target - _degree) <= step)
+            {
+                _degree = _target;
+            } else
+            {
+                _degree += (_target > _degree) ? step : -step;
+            }
+            _servo.SetDegree(_degree);
+            //The last step still has to be travelled by the horn
+            if (_degree == _target)
+            {
+                _done = now + TravelTime(0, step) + _hold;
+            }
+        }
+        _last = now;
+        return now < _done;
+    }
+
+    //Waits until the move is done, stepping it on its own if it is a sweep
+    void Wait()
+    {
+        double next = TimeNow();
+        while (Run())
+        {
+            next += SERVO_PERIOD;
+            while (TimeNow() < next)
+            {
+            }
+        }
+    }
+
+    //Horn speed in real degrees per second
+    float speed;
+
+private:
+    float Clamp(float degree)
+    {
+        return (degree < 0) ? 0 : (degree > 180) ? 180 : degree;
+    }
+
+    FEHServo &_servo;
+    int _min, _max;
+    float _degree, _target, _rate, _hold;
+    bool _known;
+    double _done, _last;
+};
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef STALL_H
+#define STALL_H
+
+#include <FEHSD.h>
+#include <FEHUtility.h>
+#include <math.h>
+
+//Most stall events kept for the log
+#define STALL_LOG_SIZE 32
+
+/*Notices when the robot is pinned. Every window seconds it compares how far each wheel's encoder has
+ counted with the power that wheel was given: if every wheel with at least minPower percent has moved
+ fewer than minCounts edges, and one of them has margin percent more than that, the robot is stalled.
+ A slow push at the edge of moving is never a stall. The window starts over whenever no wheel is powered,
+ so a robot starting from rest gets a full window to get going. A wheel pinned while the other one swings
+ the robot square against a wall doesn't count as a stall, the robot is still moving. Moves meant to end
+ against something turn enabled off for as long as they push*/
+class StallDetector
+{
+public:
+    StallDetector(float window = 0.25, int minCounts = 5, float minPower = 10, float margin = 5)
+        : window(window), minCounts(minCounts), minPower(minPower), margin(margin), enabled(true)
+    {
+        Reset(0, 0);
+    }
+
+    //Starts watching from the current counts
+    void Reset(int leftCounts, int rightCounts)
+    {
+        _leftStart = leftCounts;
+        _rightStart = rightCounts;
+        _start = TimeNow();
+        _powered = false;
+    }
+
+    //Checks the latest counts against the power the wheels have had, returns true once a whole window went by stalled
+    bool Check(float leftPower, float rightPower, int leftCounts, int rightCounts)
+    {
+        bool left = fabs(leftPower) >= minPower, right = fabs(rightPower) >= minPower;
+        bool pushing = fmax(fabs(leftPower), fabs(rightPower)) >= minPower + margin;
+        bool stalled;
+        if (!enabled || (!left && !right))
+        {
+            Reset(leftCounts, rightCounts);
+            return false;
+        }
+        if (!_powered)
+        {
+            //Counts from the first period with power
+            Reset(leftCounts, rightCounts);
+            _powered = true;
+            return false;
+        }
+        if (TimeNow() - _start < window)
+        {
+            return false;
+        }
+        stalled = pushing && (!left || leftCounts - _leftStart < minCounts) && (!right || rightCounts - _rightStart < minCounts);
+        Reset(leftCounts, rightCounts);
+        _powered = true;
+        return stalled;
+    }
+
+    //Seconds of encoder counts looked at for each decision
+    float window;
+    //Fewest edges a powered wheel has to count in a window to be moving
+    int minCounts;
+    //Percent of power below which a wheel isn't expected to move
+    float minPower;
+    //Percent past minPower a wheel has to be given before not moving is a stall
+    float margin;
+    //Whether Check() looks for stalls at all
+    bool enabled;
+
+private:
+    int _leftStart, _rightStart;
+    double _start;
+    bool _powered;
+};
+
+//One stall, and what getting out of it cost
+struct StallEvent
+{
+    //Where in the run it happened, a string constant
+    const char *where;
+    //When the robot stopped moving, and when it was moving again after the recovery
+    double start, end;
+};
+
+/*Log of the stalls in a run, kept in memory while the robot is running and saved to the SD card at the end
+ so the time they cost can be looked at afterwards*/
+class StallLog
+{
+public:
+    StallLog()
+    {
+        count = 0;
+        lost = 0;
+    }
+
+    //Records a stall that started start seconds into TimeNow() and has been recovered from now
+    void Add(const char *where, double start)
+    {
+        double end = TimeNow();
+        lost += end - start;
+        if (count < STALL_LOG_SIZE)
+        {
+            events[count].where = where;
+            events[count].start = start;
+            events[count].end = end;
+        }
+        count++;
+    }
+
+    //Writes one line per stall with its times in seconds from base, and the total lost, returns false if the file can't be opened
+    bool Save(const char *filename, double base)
+    {
+        int i;
+        FEHFile *file = SD.FOpen(filename, "w");
+        if (!file)
+        {
+            return false;
+        }
+        for (i = 0; i < count && i < STALL_LOG_SIZE; i++)
+        {
+            SD.FPrintf(file, "%s %.3f %.3f %.3f\n", events[i].where, events[i].start - base, events[i].end - base, events[i].end - events[i].start);
+        }
+        SD.FPrintf(file, "total %d %.3f\n", count, lost);
+        SD.FClose(file);
+        return true;
+    }
+
+    StallEvent events[STALL_LOG_SIZE];
+    //Stalls seen, including any past the end of events
+    int count;
+    //Seconds lost to them
+    double lost;
+};
+
+#endif
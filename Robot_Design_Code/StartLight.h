@@ -0,0 +1,120 @@
+#ifndef STARTLIGHT_H
+#define STARTLIGHT_H
+
+#include <FEHIO.h>
+#include <FEHUtility.h>
+
+//Sampling period of the start light detector in seconds (1 kHz)
+#define START_PERIOD 0.001
+
+/*Waits for the start light by sampling the CdS cell at a fixed START_PERIOD. The light has come on when a
+ reading is more than delta volts below the running baseline of the room light and also below ceiling,
+ so a shadow or a blue light can't start the run. It has to stay that way for confirm samples in a row,
+ which rejects single noisy readings and keeps the worst case delay at confirm + 1 periods. Readings
+ within hysteresis volts above the trigger level don't break a run of lit samples, and only readings
+ clearly above it are folded into the baseline, so the baseline never drifts towards the light itself.
+
+ The time of the first lit sample and of the detection are kept, so the reaction time can be reported*/
+class StartLight
+{
+public:
+    StartLight(AnalogInputPin &cds, float delta = 0.8, float ceiling = 3.3, float hysteresis = 0.2, int confirm = 5)
+        : delta(delta), ceiling(ceiling), hysteresis(hysteresis), confirm(confirm), _cds(cds)
+    {
+        //Baseline follows the room light with a time constant of about a quarter of a second
+        track = START_PERIOD/0.25;
+        baseline = 0;
+        onset = detected = -1;
+        _count = 0;
+    }
+
+    //Starts watching from the current reading
+    void Arm()
+    {
+        baseline = _cds.Value();
+        onset = detected = -1;
+        _count = 0;
+    }
+
+    //Takes one reading, returns true once the light has been seen
+    bool Sample()
+    {
+        float v;
+        double t;
+        if (detected >= 0)
+        {
+            return true;
+        }
+        v = _cds.Value();
+        t = TimeNow();
+        if (v < baseline - delta && v < ceiling)
+        {
+            if (_count == 0)
+            {
+                onset = t;
+            }
+            _count++;
+        } else if (v < baseline - delta + hysteresis && _count > 0)
+        {
+            //Close to the trigger level, only counts if the light was already on
+            _count++;
+        } else
+        {
+            _count = 0;
+            if (v >= baseline - delta + hysteresis)
+            {
+                baseline += track*(v - baseline);
+            }
+        }
+        if (_count >= confirm)
+        {
+            detected = t;
+            return true;
+        }
+        return false;
+    }
+
+    /*Arms and samples at START_PERIOD until the light comes on or timeout seconds pass (0 waits forever).
+     Returns true if the light was seen*/
+    bool Wait(float timeout = 0)
+    {
+        double start, next;
+        Arm();
+        start = next = TimeNow();
+        while (!Sample())
+        {
+            if (timeout > 0 && TimeNow() - start > timeout)
+            {
+                return false;
+            }
+            next += START_PERIOD;
+            while (TimeNow() < next)
+            {
+            }
+        }
+        return true;
+    }
+
+    //Seconds from the first lit reading to the detection, -1 if the light hasn't been seen
+    double Reaction()
+    {
+        return (detected >= 0) ? detected - onset : -1;
+    }
+
+    //Volts below the baseline a reading has to drop, and the reading it also has to be under
+    float delta, ceiling;
+    float hysteresis;
+    //Lit readings in a row needed
+    int confirm;
+    //Fraction of the way the baseline moves towards each unlit reading
+    float track;
+    float baseline;
+    //Times of the first lit reading and of the detection, -1 until then
+    double onset, detected;
+
+private:
+    AnalogInputPin &_cds;
+    int _count;
+};
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef STATUSDISPLAY_H
+#define STATUSDISPLAY_H
+
+#include <FEHLCD.h>
+#include <string.h>
+#include "Scheduler.h"
+
+//Text rows and columns on the 320x240 screen with the 12x17 font
+#define DISPLAY_ROWS 14
+#define DISPLAY_COLS 26
+//Pixel height of a text row
+#define DISPLAY_ROW_HEIGHT 17
+//Most rows redrawn each time the display task runs, so no single run holds up the control tasks for long
+#define DISPLAY_ROWS_PER_RUN 3
+
+/*Buffered status text for the LCD. Posting a message only copies it into a row buffer, the screen is
+ brought up to date later by Run() from a low-rate scheduler task, which redraws just the rows whose text
+ changed and at most DISPLAY_ROWS_PER_RUN of them at a time. A full screen clear is slow, so it only
+ happens when the background color actually changes. Flush() draws everything at once for places where
+ nothing time critical is going on*/
+class StatusDisplay : public Task
+{
+public:
+    StatusDisplay()
+    {
+        int i;
+        for (i = 0; i < DISPLAY_ROWS; i++)
+        {
+            _text[i][0] = '\0';
+            _shown[i][0] = '\0';
+        }
+        _row = 0;
+        _lines = DISPLAY_ROWS;
+        _color = _shownColor = FEHLCD::Black;
+        _next = 0;
+    }
+
+    //Keeps the bottom rows for Set() only, Line() and Clear() leave them alone
+    void Reserve(int rows)
+    {
+        _lines = (rows < 0 || rows >= DISPLAY_ROWS) ? DISPLAY_ROWS : DISPLAY_ROWS - rows;
+        _row %= _lines;
+    }
+
+    //Starts a new page, the rows are blanked when the display next catches up
+    void Clear()
+    {
+        int i;
+        for (i = 0; i < _lines; i++)
+        {
+            _text[i][0] = '\0';
+        }
+        _row = 0;
+    }
+
+    //Starts a new page on a colored background
+    void Clear(FEHLCD::FEHLCDColor color)
+    {
+        Clear();
+        _color = color;
+    }
+
+    //Adds a line below the last one, like LCD.WriteLine(), wrapping back to the top row
+    void Line(const char *text)
+    {
+        Set(_row, text);
+        _row = (_row + 1) % _lines;
+    }
+
+    void Line(float value)
+    {
+        char text[DISPLAY_COLS + 1];
+        Format(value, text);
+        Line(text);
+    }
+
+    //Replaces the text of one row without moving where Line() writes next
+    void Set(int row, const char *text)
+    {
+        int i;
+        if (row < 0 || row >= DISPLAY_ROWS)
+        {
+            return;
+        }
+        //Text past the edge of the screen is cut off
+        for (i = 0; i < DISPLAY_COLS && text[i]; i++)
+        {
+            _text[row][i] = text[i];
+        }
+        _text[row][i] = '\0';
+    }
+
+    //Redraws the next few rows that changed, returns true so it can run as a scheduler task forever
+    bool Run()
+    {
+        Draw(DISPLAY_ROWS_PER_RUN);
+        return true;
+    }
+
+    //Brings the whole screen up to date now
+    void Flush()
+    {
+        Draw(DISPLAY_ROWS);
+    }
+
+    //Writes value with three decimals into text, which needs room for DISPLAY_COLS characters
+    static void Format(float value, char *text)
+    {
+        char digits[12];
+        int n = 0, i = 0;
+        long whole, frac;
+        if (value < 0)
+        {
+            text[i++] = '-';
+            value = -value;
+        }
+        whole = (long)value;
+        frac = (long)((value - whole)*1000 + 0.5);
+        if (frac >= 1000)
+        {
+            whole++;
+            frac -= 1000;
+        }
+        do
+        {
+            digits[n++] = '0' + whole % 10;
+            whole /= 10;
+        } while (whole > 0 && n < 10);
+        while (n > 0)
+        {
+            text[i++] = digits[--n];
+        }
+        text[i++] = '.';
+        text[i++] = '0' + frac/100;
+        text[i++] = '0' + frac/10 % 10;
+        text[i++] = '0' + frac % 10;
+        text[i] = '\0';
+    }
+
+private:
+    //Draws up to count changed rows, starting after the last row drawn so every row gets its turn
+    void Draw(int count)
+    {
+        char padded[DISPLAY_COLS + 1];
+        int i, row, len, old, last = -1;
+        if (_color != _shownColor)
+        {
+            LCD.Clear(_color);
+            _shownColor = _color;
+            for (i = 0; i < DISPLAY_ROWS; i++)
+            {
+                _shown[i][0] = '\0';
+            }
+            //The clear is a whole run's worth of drawing, unless everything is being drawn anyway
+            if (count < DISPLAY_ROWS)
+            {
+                return;
+            }
+        }
+        for (i = 0; i < DISPLAY_ROWS && count > 0; i++)
+        {
+            row = (_next + i) % DISPLAY_ROWS;
+            if (strcmp(_text[row], _shown[row]) == 0)
+            {
+                continue;
+            }
+            //Spaces over whatever was longer in the old text instead of clearing the row
+            len = strlen(_text[row]);
+            old = strlen(_shown[row]);
+            strcpy(padded, _text[row]);
+            while (len < old)
+            {
+                padded[len++] = ' ';
+            }
+            padded[len] = '\0';
+            LCD.WriteAt(padded, 0, row*DISPLAY_ROW_HEIGHT);
+            strcpy(_shown[row], _text[row]);
+            last = row;
+            count--;
+        }
+        //The next run starts after the last row drawn, moving it inside the loop would skip rows
+        if (last >= 0)
+        {
+            _next = (last + 1) % DISPLAY_ROWS;
+        }
+    }
+
+    char _text[DISPLAY_ROWS][DISPLAY_COLS + 1];
+    char _shown[DISPLAY_ROWS][DISPLAY_COLS + 1];
+    int _row, _next, _lines;
+    FEHLCD::FEHLCDColor _color, _shownColor;
+};
+
+#endif
@@ -0,0 +1,308 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <FEHSD.h>
+#include <FEHUtility.h>
+#include <math.h>
+#include "Scheduler.h"
+
+//Version of the log format, the first line of a log is "telemetry <version> <record bytes> <period ms>"
+#define TELEMETRY_VERSION 2
+//Bytes in one packed record
+#define TELEMETRY_RECORD 32
+//Records the RAM ring holds, 10 seconds of driving at TELEMETRY_PERIOD before it has to be written out
+#define TELEMETRY_RECORDS 1024
+//Seconds between records, the rate of the drive and pose loops
+#define TELEMETRY_PERIOD 0.01
+//Records written per line of the log, 8 is 512 hex digits, about a sector of the card per write
+#define TELEMETRY_LINE 8
+//Seconds between checks for room to write lines
+#define TELEMETRY_WRITE_PERIOD 0.01
+//Records waiting in the ring past which a line is written even without room, holding the other tasks up by a line's time
+//rather than dropping records. A quarter of the ring keeps what Close() has left to write short
+#define TELEMETRY_HIGH_WATER (TELEMETRY_RECORDS/4)
+//Guess at how long writing a line takes, until one has been timed
+#define TELEMETRY_LINE_TIME 0.003
+
+//Bits of TelemetrySample::flags, a switch's bit is set while it is pressed
+#define TELEMETRY_FRONT_LEFT 1
+#define TELEMETRY_FRONT_RIGHT 2
+#define TELEMETRY_BACK_LEFT 4
+#define TELEMETRY_BACK_RIGHT 8
+#define TELEMETRY_FORK 16
+//The drive controller has given up on a move it was pinned in
+#define TELEMETRY_STALLED 32
+//RPS had a fix, x, y and heading are -1 or -2 without one
+#define TELEMETRY_RPS 64
+
+//Everything one record keeps, as the robot read it
+struct TelemetrySample
+{
+    //Seconds since the first record
+    double time;
+    int leftCounts, rightCounts;
+    //Percent power each drive motor was last given
+    float leftPower, rightPower;
+    //Volts on the CdS cell and the three line optosensors
+    float cds, left, center, right;
+    //RPS pose, inches and degrees
+    float x, y, heading;
+    float battery;
+    //What the robot is doing, a TASK_ number from Mission.h
+    int state;
+    int flags;
+};
+
+class Telemetry;
+
+//The task that writes a Telemetry's records out, as many lines as fit before the next task is due
+class TelemetryWriter : public Task
+{
+public:
+    TelemetryWriter(Telemetry &log) : _log(log)
+    {
+    }
+
+    bool Run();
+
+private:
+    Telemetry &_log;
+};
+
+/*Records the robot's sensors and commands into RAM at a fixed rate and writes them to the SD card in the gaps
+ between the other scheduler tasks. Formatting and writing text on the card takes milliseconds, so each sample is
+ packed into a fixed TELEMETRY_RECORD byte record in a ring instead, and writer, a second scheduler task, writes
+ whole lines of records out when the scheduler has at least lineTime before another task is due. While a
+ fast loop like DriveUntil's or the line follower's is running that never happens, so once TELEMETRY_HIGH_WATER
+ records are waiting the writer writes a line anyway, making one task a line's time late every
+ TELEMETRY_LINE records. A full ring still drops new records and counts them rather than holding anything up.
+
+ FEHSD only writes text, so records go on the card as hex, TELEMETRY_LINE to a line, and Host_Sim's
+ telemetry_decode turns the log into CSV. After records have been dropped the next line written is
+ "dropped <count so far>", so a log cut off before Close() still tells how many, and the log ends with
+ "end <records> <dropped>" once Close() has written the rest of the ring. Records are little-endian:
+   0 time ms (u32)  4 left counts (i32)  8 right counts (i32)  12 left, right power % (i8, i8)  14 state (u8)
+   15 flags (u8)  16 CdS, left, center, right mV (u16 x4)  24 RPS x, y inches*100 (i16 x2)
+   28 RPS heading degrees*10 (i16)  30 battery mV (u16)*/
+class Telemetry : public Task
+{
+public:
+    //sample fills in everything but the time and state
+    Telemetry(Scheduler &scheduler, void (*sample)(TelemetrySample *))
+        : writer(*this), state(0), recorded(0), dropped(0), written(0), forced(0), writeTime(0), lineTime(TELEMETRY_LINE_TIME),
+          _scheduler(scheduler), _sample(sample), _file(0), _head(0), _count(0), _noted(0), _start(0)
+    {
+    }
+
+    //Starts a new log, returns false if the card can't be written. Open it before the run, opening takes a while
+    bool Open(const char *filename)
+    {
+        _file = SD.FOpen(filename, "w");
+        if (!_file)
+        {
+            return false;
+        }
+        SD.FPrintf(_file, "telemetry %d %d %d\n", TELEMETRY_VERSION, TELEMETRY_RECORD, (int)(1000*TELEMETRY_PERIOD + 0.5));
+        _head = _count = 0;
+        recorded = dropped = written = forced = 0;
+        _noted = 0;
+        writeTime = 0;
+        return true;
+    }
+
+    //Takes one sample, the first one is time 0
+    bool Run()
+    {
+        TelemetrySample s;
+        if (!_file)
+        {
+            return false;
+        }
+        if (recorded == 0)
+        {
+            _start = TimeNow();
+        }
+        recorded++;
+        if (_count == TELEMETRY_RECORDS)
+        {
+            dropped++;
+            return true;
+        }
+        _sample(&s);
+        s.time = TimeNow() - _start;
+        s.state = state;
+        Pack(s, _ring[(_head + _count) % TELEMETRY_RECORDS]);
+        _count++;
+        return true;
+    }
+
+    //Writes a line of records if there are enough for a full one, or any at all when all is set. Returns false if there were none
+    bool Write(bool all)
+    {
+        char text[2*TELEMETRY_LINE*TELEMETRY_RECORD + 1];
+        const char *digits = "0123456789abcdef";
+        int n = (_count < TELEMETRY_LINE) ? _count : TELEMETRY_LINE, i, j;
+        double start = TimeNow(), took;
+        if (!_file || n == 0 || (n < TELEMETRY_LINE && !all))
+        {
+            return false;
+        }
+        for (i = 0; i < n; i++)
+        {
+            const unsigned char *r = _ring[(_head + i) % TELEMETRY_RECORDS];
+            for (j = 0; j < TELEMETRY_RECORD; j++)
+            {
+                text[2*(i*TELEMETRY_RECORD + j)] = digits[r[j] >> 4];
+                text[2*(i*TELEMETRY_RECORD + j) + 1] = digits[r[j] & 15];
+            }
+        }
+        text[2*n*TELEMETRY_RECORD] = 0;
+        if (dropped != _noted)
+        {
+            SD.FPrintf(_file, "dropped %ld\n", dropped);
+            _noted = dropped;
+        }
+        SD.FPrintf(_file, "%s\n", text);
+        _head = (_head + n) % TELEMETRY_RECORDS;
+        _count -= n;
+        written += n;
+        took = TimeNow() - start;
+        writeTime += took;
+        if (took > lineTime)
+        {
+            lineTime = took;
+        }
+        return true;
+    }
+
+    //Writes out whatever is left and ends the log. Take the task off the scheduler first
+    bool Close()
+    {
+        if (!_file)
+        {
+            return false;
+        }
+        while (Write(true))
+        {
+        }
+        SD.FPrintf(_file, "end %ld %ld\n", recorded, dropped);
+        SD.FClose(_file);
+        _file = 0;
+        return true;
+    }
+
+    //Records waiting in the ring
+    int Pending()
+    {
+        return _count;
+    }
+
+    //Packs a sample into a record, see the class comment for the layout
+    static void Pack(const TelemetrySample &s, unsigned char *r)
+    {
+        Put(r, (long)(1000*s.time + 0.5), 4);
+        Put(r + 4, s.leftCounts, 4);
+        Put(r + 8, s.rightCounts, 4);
+        Put(r + 12, Scale(s.leftPower, 1, -128, 127), 1);
+        Put(r + 13, Scale(s.rightPower, 1, -128, 127), 1);
+        r[14] = (unsigned char)s.state;
+        r[15] = (unsigned char)s.flags;
+        Put(r + 16, Scale(s.cds, 1000, 0, 65535), 2);
+        Put(r + 18, Scale(s.left, 1000, 0, 65535), 2);
+        Put(r + 20, Scale(s.center, 1000, 0, 65535), 2);
+        Put(r + 22, Scale(s.right, 1000, 0, 65535), 2);
+        Put(r + 24, Scale(s.x, 100, -32768, 32767), 2);
+        Put(r + 26, Scale(s.y, 100, -32768, 32767), 2);
+        Put(r + 28, Scale(s.heading, 10, -32768, 32767), 2);
+        Put(r + 30, Scale(s.battery, 1000, 0, 65535), 2);
+    }
+
+    static void Unpack(const unsigned char *r, TelemetrySample *s)
+    {
+        s->time = Get(r, 4, false)/1000.0;
+        s->leftCounts = Get(r + 4, 4, true);
+        s->rightCounts = Get(r + 8, 4, true);
+        s->leftPower = Get(r + 12, 1, true);
+        s->rightPower = Get(r + 13, 1, true);
+        s->state = r[14];
+        s->flags = r[15];
+        s->cds = Get(r + 16, 2, false)/1000.0f;
+        s->left = Get(r + 18, 2, false)/1000.0f;
+        s->center = Get(r + 20, 2, false)/1000.0f;
+        s->right = Get(r + 22, 2, false)/1000.0f;
+        s->x = Get(r + 24, 2, true)/100.0f;
+        s->y = Get(r + 26, 2, true)/100.0f;
+        s->heading = Get(r + 28, 2, true)/10.0f;
+        s->battery = Get(r + 30, 2, false)/1000.0f;
+    }
+
+    //Writes the ring out when there's room, add it to the scheduler with the recorder
+    TelemetryWriter writer;
+    //What the robot is doing, stored in every record from now on
+    int state;
+    //Samples due since Open(), those that didn't fit in the ring, and those on the card
+    long recorded, dropped, written;
+    //Lines written past TELEMETRY_HIGH_WATER without room for them
+    long forced;
+    //Seconds spent formatting and writing lines, and the longest a line has taken
+    double writeTime, lineTime;
+
+private:
+    static void Put(unsigned char *p, long value, int bytes)
+    {
+        int i;
+        for (i = 0; i < bytes; i++)
+        {
+            p[i] = (unsigned char)(value >> (8*i));
+        }
+    }
+
+    static long Get(const unsigned char *p, int bytes, bool sign)
+    {
+        unsigned long value = 0;
+        int i;
+        for (i = 0; i < bytes; i++)
+        {
+            value |= (unsigned long)p[i] << (8*i);
+        }
+        //Sign extending from the top bit of the field
+        if (sign && bytes < 4 && (value >> (8*bytes - 1)))
+        {
+            value |= ~0UL << (8*bytes);
+        }
+        return (bytes == 4 && sign) ? (long)(int)value : (long)value;
+    }
+
+    //Rounds value*scale into the range a field can hold
+    static long Scale(float value, float scale, long low, long high)
+    {
+        long v = lroundf(value*scale);
+        return (v < low) ? low : (v > high) ? high : v;
+    }
+
+    Scheduler &_scheduler;
+    void (*_sample)(TelemetrySample *);
+    FEHFile *_file;
+    unsigned char _ring[TELEMETRY_RECORDS][TELEMETRY_RECORD];
+    int _head, _count;
+    //Drops already written to the log
+    long _noted;
+    double _start;
+
+    friend class TelemetryWriter;
+};
+
+inline bool TelemetryWriter::Run()
+{
+    while (_log._scheduler.Slack() > _log.lineTime && _log.Write(false))
+    {
+    }
+    //No room, but the ring is close to dropping records
+    while (_log._count >= TELEMETRY_HIGH_WATER && _log.Write(false))
+    {
+        _log.forced++;
+    }
+    return _log._file != 0;
+}
+
+#endif
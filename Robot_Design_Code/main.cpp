@@ -1,3 +1,11 @@
+//Uncomment for the competition build, the course is run from CourseMission.h, course.mis compiled into the program
+//by Host_Sim's mission_compile -c, instead of from the SD card or the course functions
+//#define MISSION_BUILT_IN
+#ifdef MISSION_BUILT_IN
+//No mission is read from the SD card, so no room is kept for one
+#define MISSION_MAX 1
+#endif
+
 #include <FEHLCD.h>
 #include <FEHUtility.h>
 #include <FEHIO.h>
@@ -6,45 +14,149 @@
 #include <FEHRPS.h>
 #include <FEHSD.h>
 #include <math.h>
+#include <string.h>
 #include <FEHBattery.h>
+#include "RobotConfig.h"
+#include "DriveControl.h"
+#include "MotionQueue.h"
+#include "LineFollower.h"
+#include "Scheduler.h"
+#include "AsyncMotion.h"
+#include "StatusDisplay.h"
+#include "StartLight.h"
+#include "ColorSensor.h"
+#include "DriveUntil.h"
+#include "Stall.h"
+#include "PoseEstimator.h"
+#include "Navigator.h"
+#include "Kinematics.h"
+#include "Mission.h"
+#include "Telemetry.h"
+#ifdef MISSION_BUILT_IN
+#include "CourseMission.h"
+//Steps the built-in course doesn't have are left out of missionStep(), and with them whatever only they call
+#define MISSION_USES(op) MissionUses(courseMission, COURSE_MISSION_STEPS, op)
+#else
+#define MISSION_USES(op) true
+#endif
+//A case of missionStep() that is skipped at compile time if the mission can't have the step
+#define MISSION_CASE(op) case op: if (!MISSION_USES(op)) break;
 
-//Defining pi for consistency and ease of use
-#define PI 3.1415
-/*Definition for a standard power for use with IGWAN motor movement.
- Useful because it allows universal changes with one adjustment. Must be a value between -100 and 100.*/
-#define MOVE 50
-#define TURN 25
-//Definition for wheel diameter in inches
-#define WHEEL 2.5
-//Definition for distance between wheels (Wheel to Wheel) in inches
-#define W2W 7.5
+//Drive powers, wheel geometry and servo limits are in RobotConfig.h, shared with Host_Sim's benches
+//File on the SD card the drive calibration is kept in, written by calibrateDrive()
+//WHEEL and W2W are only the defaults, the calibrated values are used whenever there is one
+#define KINEMATICS_FILE "kinematics.txt"
+//File on the SD card the course is read from as a mission, compiled from course.mis by Host_Sim's mission_compile
+//Without one the course functions below are run instead
+#define MISSION_FILE "mission.txt"
 //Definition for a rest period to be used to ensure robot makes complete stops. Defined so it can be optimized with ease later.
-#define REST 0.1
-
-//Definition for line following switch cases
-#define ON_LINE 0
-#define LINE_ON_RIGHT 1
-#define LINE_ON_LEFT 2
-#define LINE_FAR_RIGHT 3
-#define LINE_FAR_LEFT 4
-#define OFF_LINE 5
+//Moves now decelerate along a motion profile, so only a short settle is needed (was 0.1)
+#define REST 0.02
 
 //Break values for the optosensors to change line following states
 #define LEFT_BREAK 1.0 //formerly 2.4 from exploration 2
 #define CENTER_BREAK 1.27 //formerly 2.0 from exploration 2
 #define RIGHT_BREAK 2.68 //formerly 2.7 from exploration 2
+//How far each optosensor's reading moves between fully off and fully on the line, scales the line follower's error
+#define LEFT_SPAN 1.3
+#define CENTER_SPAN 1.5
+#define RIGHT_SPAN 0.8
+//Power for line following, negative because the optosensors are on the back (was 10-20)
+#define FOLLOW -50
+//Following the line back to the wall after the ice cream, the most inches and seconds before giving up on the switches
+#define FOLLOW_WALL_LIMIT 12
+#define FOLLOW_WALL_TIMEOUT 3.0
+
+//Periods in seconds of the scheduler tasks that run alongside every move, battery sampling and the status display
+#define BATTERY_PERIOD 0.05
+#define DISPLAY_PERIOD 0.5
+//Period of the task that copies posted status text to the LCD, a few rows at a time
+#define STATUS_PERIOD 0.1
+//Status row the battery voltage is shown on, the bottom one
+#define BATTERY_ROW 13
+
+//Defining color integers for CdS readings, the same numbers the ColorSensor classifies into
+#define CDSRED COLOR_RED
+#define CDSBLUE COLOR_BLUE
+#define NO_COLOR COLOR_NONE
+#define NO_READING COLOR_NO_READING
+//File on the SD card the CdS calibration table is kept in, written by calibrateCdS()
+#define CDS_CALIBRATION "cds_cal.txt"
+//Below this confidence a jukebox reading is taken again before the robot commits to a button
+#define CDS_CONFIDENCE 0.5
+//Most extra readings taken of a doubtful jukebox light
+#define CDS_RETRIES 3
+//Speed and farthest distance in inches the robot creeps forward looking for the jukebox light (was 0.1 inch steps)
+#define SCAN 20
+#define SCAN_LIMIT 6
+//Most 0.1 inch steps taken after a scan that didn't find the light
+#define SCAN_STEPS 20
+//Inches sideways from the light to either jukebox button and forward into it, what a 45 degree pivot, an inch and 3 more inches came to
+#define JUKEBOX_SHIFT 0.71
+#define JUKEBOX_PUSH 3.71
+/*Pose facing the final button from either jukebox button, inches forward and left of where the robot pushed it and degrees
+ counter-clockwise. What backing off 6, turning left, backing 6 from the red button or 8 from the blue one (it is further
+ from the final zone) and turning 45 degrees right came to, driven as one goTo()*/
+#define FINAL_BACK -6
+#define FINAL_RED_LEFT -6
+#define FINAL_BLUE_LEFT -8
+#define FINAL_TURN 45
+
+//Ice cream lanes, the lines leading up to each lever
+#define LANE_COUNT 3
+//Inches between lanes, line to line and lever to lever on the course map, and the farthest crossLanes() drives per lane
+#define LANE_SPACING 5
+//Inches the line sensors are behind the middle of the robot, so they are on a lane's line with the robot's middle that far short of it
+#define LINE_OFFSET 4
+//Speed the robot backs along the lanes at, crossing the ones before its lever without stopping (was 20 percent and a stop on every line)
+#define LANE_SPEED MOVE
+//Line checks in a row off a line before the next one counts, so the edge of one line can't be counted twice
+#define LANE_CLEAR 10
+//Inches the robot drives into a lever from below the lanes and the seconds it leans on it
+#define LEVER_PUSH 12
+#define LEVER_HOLD 1.0
+//Inches into a lever from where flipLever() backed off its lane's line, for flipping it back up
+#define LEVER_REPUSH 6
+//Inches to back away from the levers after flipping one back up, so the drive across to the wall by the ticket clears the wall tray() squares up on
+#define TICKET_BACK_OFF 5
+//Farthest in inches the wall by the ticket can be, the robot comes at it from as far as the last lane
+#define TICKET_WALL 32
+
+//Events a DriveUntil drive can wait for, the argument of driveEvent()
+#define EVENT_FRONT_ANY 0
+#define EVENT_FRONT_BOTH 1
+#define EVENT_BACK_ANY 2
+#define EVENT_BACK_BOTH 3
+#define EVENT_FORK 4
+#define EVENT_LINE 5
+#define EVENT_COLOR 6
+//Running into a wall, the most seconds to wait for the switches, and the power and seconds to push for
+//once one switch is pressed so both end up pressed and the robot is square with the wall
+#define WALL_TIMEOUT 4.0
+#define SQUARE 20
+#define SQUARE_TIMEOUT 1.0
+//Recovering from a stall, inches to back off before trying again and the most tries
+#define BACK_OFF 1.0
+#define STALL_TRIES 3
+//File on the SD card the stalls of the last run are written to
+#define STALL_FILE "stalls.txt"
+//File on the SD card the telemetry of the last run is logged to, Host_Sim's telemetry_decode turns it into CSV
+#define TELEMETRY_FILE "telemetry.txt"
 
-//Defining color integers for CdS readings
-#define CDSRED 0
-#define CDSBLUE 1
-#define NO_COLOR 2
-#define NO_READING 3
+//Start light detection, how far below the room light the CdS reading has to drop and the reading it has to be under,
+//between the red (under 0.9) and blue (over 1.3) readings so only the red start light counts
+#define START_DELTA 0.8
+#define START_CEILING 1.1
 
-//Defining min and max for servos
-#define SERVO_ARM_MAX 2350
-#define SERVO_ARM_MIN 500
-#define SERVO_FORK_MAX 2350
-#define SERVO_FORK_MIN 500
+//Servo numbers in mission steps
+#define SERVO_ARM 0
+#define SERVO_FORK 1
+
+//Runs the drive and line following control loops and the background tasks at their fixed rates
+Scheduler scheduler;
+
+//Status text is posted here and drawn on the LCD later by a scheduler task, so printing never holds up a move
+StatusDisplay status;
 
 //Declarations for IGWAN motors with their max voltage of 9V
 FEHMotor leftMotor(FEHMotor::Motor3,9);
@@ -54,13 +166,28 @@ FEHMotor rightMotor(FEHMotor::Motor2,9);
 DigitalEncoder leftEncoder(FEHIO::P0_0);
 DigitalEncoder rightEncoder(FEHIO::P0_1);
 
+//Effective wheel size, track width and turn error of this robot, loaded from the SD card at startup
+Kinematics kinematics(WHEEL, W2W, COUNTS_PER_REV);
+//Closed-loop controller that runs linear moves and pivots along motion profiles using both shaft encoders
+DriveController drive(leftMotor, rightMotor, leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W);
+//Queue for running several moves back to back without stopping between them, stepped by the scheduler
+MotionQueue motion(drive, &scheduler);
+
 //Declaration for the CdS sensor
 AnalogInputPin CdS(FEHIO::P0_2);
+//Watches the CdS cell for the start light at a fixed rate
+StartLight startLight(CdS, START_DELTA, START_CEILING);
+//Classifies the light on the CdS cell from a filtered burst of readings against the calibration table
+ColorSensor cdsSensor(CdS);
 
 //Declaration of optosensors for line following
 AnalogInputPin leftLine(FEHIO::P1_0);
 AnalogInputPin centerLine(FEHIO::P1_1);
 AnalogInputPin rightLine(FEHIO::P1_2);
+//Reads all three optosensors at once so each loop does one set of conversions
+LineSensors lineSensors(leftLine, centerLine, rightLine, LEFT_BREAK, CENTER_BREAK, RIGHT_BREAK, LEFT_SPAN, CENTER_SPAN, RIGHT_SPAN);
+//PID line follower steering on the continuous line offset from those sensors
+LineFollower follower(leftMotor, rightMotor, lineSensors);
 
 //Declaration of digital inputs for the microswitches
 DigitalInputPin frontLeftSwitch(FEHIO::P2_0);
@@ -72,26 +199,130 @@ DigitalInputPin forkSwitch(FEHIO::P2_2);
 //Delcaring servos
 FEHServo servo_arm(FEHServo::Servo0);
 FEHServo servo_fork(FEHServo::Servo1);
+//Servo calibration and motion model, predicts when each servo move is done and can run while the robot drives
+ServoController armMove(servo_arm, SERVO_ARM_MIN, SERVO_ARM_MAX, SERVO_SPEED);
+ServoController forkMove(servo_fork, SERVO_FORK_MIN, SERVO_FORK_MAX, SERVO_SPEED);
+//Starts drive and servo moves without waiting so they can overlap
+AsyncMotion async(scheduler, drive);
+//Drives until a sensor condition comes true, checking it much faster than the drive loop runs
+DriveUntil until(scheduler, drive);
+
+//Every stall in the run and how long getting out of it took
+StallLog stallLog;
+
+//Function prototype for the power each drive motor was last given, whichever controller is driving them
+//The pose estimator takes which way the wheels turn from it, the encoders can't tell
+void motorPowers(float *left, float *right);
+
+//Where the robot is on the course, from the encoders between RPS fixes
+PoseEstimator poseEstimate(leftEncoder, rightEncoder, COUNTS_PER_REV/(WHEEL*M_PI), W2W, motorPowers);
+
+//Drives to points on the course with the pose estimate checking where each leg ended
+Navigator navigator(scheduler, drive, poseEstimate, &kinematics);
+
+//Function prototype for running one step of a mission, returns the color or lever reading for the steps that take one
+int missionStep(const MissionStep &step);
+
+//The course as a list of steps on the SD card, so it can be changed without building and flashing the robot code,
+//or compiled in for the competition build
+Mission mission(missionStep);
+//Servo moves mission steps have started without waiting for them, by servo number
+Motion missionServos[2];
+
+//Battery voltage averaged by the sampling task
+float batteryVolts = 0;
+
+//Function prototype for filling in a telemetry record from the sensors and motor commands
+void sampleTelemetry(TelemetrySample *s);
+
+//Records the run at the drive loop's rate, the task number marks which course task each record was part of
+Telemetry telemetry(scheduler, sampleTelemetry);
+
+//Lines a crossLanes() drive has counted, and the line checks since it was last on one
+int lanesCrossed = 0;
+int laneClear = 0;
+//Ice cream lane the middle of the robot is on, counted from the first, kept by crossLanes() and set where a task knows it
+int lane = 0;
+
+//Limits of the lineFollow() running, in encoder counts from where it started and the time to give up at (0 for none),
+//and whether it hit one of them
+int followCounts = 0, followLeft = 0, followRight = 0;
+double followStart = 0, followEnd = 0;
+bool followStopped = false;
 
 //Function prototype for moving a linear distance, returns nothing, accepts a distance in inches
 void linearMove(float distance, float speed);
 
+/*Function prototype for driving to a point on the course, returns how close it got and how long it took.
+ Accepts RPS coordinates in inches and the heading to end at in degrees counter-clockwise, or GOTO_ANY_HEADING*/
+GoToResult goTo(float x, float y, float heading);
+
 /*Function prototype for pivoting on a spot, returns nothing.
  Accepts a degree amount to turn from -360 to 360, with negative numbers turning left and positive turning right.*/
 void pivot(float degrees, float speed);
 
-//Function prototype for checking what color the CdS cell sees, returns 0 for red, 1 for blue, 2 for black/no color
-//If it returns a 3, it could not get any reading from the CdS cell, or some other error has occured
-int cdsColor();
+/*Function prototype for driving along a circle, returns nothing. Accepts the radius in inches (negative backs up)
+ and the degrees to turn, with negative numbers turning left and positive turning right like pivot()*/
+void arc(float radius, float degrees, float speed);
+
+/*Function prototype for shifting sideways while moving forward, returns nothing. Accepts inches to the right
+ (negative is left) and the inches forward to do it in, the robot ends facing the way it started*/
+void sidestep(float right, float forward, float speed);
+
+//Function prototype for checking what color the CdS cell sees, returns the color as 0 for red, 1 for blue, 2 for black/no color
+//and how confident the reading is from 0 to 1
+//If the color is 3, it could not get any reading from the CdS cell, or some other error has occured
+ColorReading cdsColor();
 
 //Function prototype for testing the CdS cell readings
 void testCdS();
 
+//Function prototype for reading the jukebox light, creeping up to it and reading a doubtful light again
+ColorReading readJukebox();
+
+//Function prototype for checking a single CdS reading for a red or blue light, the argument is unused
+//Made to be the condition of a DriveUntil drive
+bool cdsLit(int unused);
+
+//Function prototype for checking one of the EVENT_ conditions, returns true once it has happened
+//Made to be the condition of a DriveUntil drive
+bool driveEvent(int event);
+
+/*Function prototype for running into a wall, accepts 0 for the front or 1 for the back, the speed, and the farthest distance in inches to look for it.
+ Drives until either switch on that side is pressed, then pushes gently until both are, which isn't watched for stalls. If the robot stalls
+ on the way it backs off and tries again, up to STALL_TRIES times. Returns how the last drive to the wall ended*/
+UntilResult hitWall(int side, float speed, float limit);
+
+/*Function prototype for pushing with both motors at power percent (negative backs up) until one of the EVENT_ conditions, for at most timeout seconds.
+ If the robot stalls first it backs off and tries again, up to STALL_TRIES times. Returns how the last push ended*/
+UntilResult pushUntil(float power, int event, float timeout);
+
+//Function prototype for turning stall detection off for the moves that follow, accepts true before a move that ends against a lever or button
+//on purpose and false after it. A move held up short of its distance ends DriveGains::lean seconds after its profile instead
+void contact(bool on);
+
+//Function prototype for backing away from whatever the robot stalled on, accepts the direction it was driving (1 forward, -1 back) and where it stalled
+//Logs the stall once the robot is free
+void recoverStall(float dir, const char *where);
+
+//Function prototype for capturing the CdS readings under each light on the robot and saving them to the SD card
+void calibrateCdS();
+
+//Function prototype for measuring the drive against RPS and saving the fitted wheel size, track width and turn error to the SD card
+void calibrateDrive();
+
+//Function prototype for setting the drive and pose estimate up with the calibration
+void useKinematics();
+
 //Function prototype for line following, accepts integers to determine its end conition, 0 is indefinite, 1 is microswitches, 2 is screen touch
-void lineFollow(int condition);
+//Gives up after limit inches or timeout seconds when they aren't 0, returns true if the end condition was met
+bool lineFollow(int condition, float limit = 0, float timeout = 0);
+
+//Function prototype for testing a lineFollow()'s end condition along with its distance and time limits
+bool followCheck(int end, LineSnapshot line);
 
-//Function prototype for testing line following end conditions
-bool checkCondition(int end);
+//Function prototype for testing line following end conditions, accepts the end condition and the latest line sensor snapshot
+bool checkCondition(int end, LineSnapshot line);
 
 //Function prototype for finding a line assuming the robot is near one but not quite on it
 void findLine();
@@ -99,7 +330,7 @@ void findLine();
 //Function prototype for checking if a side's microswitches are pressed, accepts an int, 0 for front side, 1 for back side microswitches to be checked
 bool microSwitchCheck(int side);
 
-//Function prototype for pressing the jukebox button
+//Function prototype for pressing the jukebox button and turning to face the final button
 void jukebox();
 
 //Function prototype for dumping the tray into the sink
@@ -111,6 +342,18 @@ void ticket();
 //Function prototype for burger flip
 void burger();
 
+//Function prototype for backing along the ice cream lanes, crossing lanes lines at speed, and stopping with the middle of the robot
+//on the lanes-th lane on from the one it is on. Negative lanes drives forward instead. Keeps lane up to date
+void crossLanes(int lanes);
+
+//Function prototype for counting the lanes a crossLanes() drive has come onto, true once it is on the lanes-th one
+//Made to be the condition of a DriveUntil drive
+bool laneReached(int lanes);
+
+//Function prototype for flipping the lever at the end of the lane the robot is on, facing back along the lanes, accepts how far it is to
+//drive into the lever once turned towards it. Backs off along the lane's line afterwards
+void flipLever(float push);
+
 //Function prototype for the first icecream flip
 void icecream_1(int lever);
 
@@ -120,6 +363,12 @@ void icecream_2(int lever);
 //Function prototype for moving from jukebox to final button
 void jBox2Final();
 
+//Function prototypes for the background scheduler tasks, sampling the battery and showing it on the bottom line of the LCD
+void sampleBattery();
+void showBattery();
+FunctionTask batterySampler(sampleBattery);
+FunctionTask batteryDisplay(showBattery);
+
 //Function prototype for performance tests
 void p1();
 void p2();
@@ -131,196 +380,509 @@ int main(void)
     float x,y;
     float bat_v = 0, m = 0;
     int icecreamLever;
+    bool scripted;
 
     //Setting up RPS
     RPS.InitializeTouchMenu();
 
     //Setting servo max and mins
-    servo_arm.SetMax(SERVO_ARM_MAX);
-    servo_arm.SetMin(SERVO_ARM_MIN);
-    servo_fork.SetMax(SERVO_FORK_MAX);
-    servo_fork.SetMin(SERVO_FORK_MIN);
+    armMove.Init();
+    forkMove.Init();
 
     //Pre-run setup
     //Resetting servo positions
-    servo_arm.SetDegree(0.0);
-    servo_fork.SetDegree(0.0);
+    armMove.Move(0.0);
+    forkMove.Move(0.0);
+
+    //Loading the CdS calibration, the default ranges are used if there isn't one on the SD card
+    cdsSensor.Load(CDS_CALIBRATION);
+    //Loading the drive calibration the same way, WHEEL and W2W are used without one
+    kinematics.Load(KINEMATICS_FILE);
+    useKinematics();
+    //Opening the course mission, the course functions are run if there isn't one
+#ifdef MISSION_BUILT_IN
+    scripted = mission.Use(courseMission, COURSE_MISSION_STEPS);
+#else
+    scripted = mission.Open(MISSION_FILE);
+#endif
+    //Starting the telemetry log now, opening a file on the SD card is too slow to do once the run has started
+    telemetry.Open(TELEMETRY_FILE);
 
-    //Waiting for a touch input
+    //Waiting for the operator to pick a calibration or the run, the screen is split into thirds top to bottom
     LCD.Clear(FEHLCD::Black);
     LCD.SetFontColor(FEHLCD::White);
-    LCD.WriteLine("Waiting for touch input to continue");
-    LCD.WriteAt("BATT:        V", 0, 222);
+    status.Reserve(1);
+    status.Line("Touch top: calibrate CdS");
+    status.Line("Touch middle: start run");
+    status.Line("Touch bottom: cal. drive");
+    status.Line(scripted ? "Running mission from SD" : "Running built-in course");
     while(true)
     {
+        if(LCD.Touch(&x,&y))
+        {
+            if (y < 80)
+            {
+                calibrateCdS();
+            } else if (y >= 160)
+            {
+                calibrateDrive();
+            } else
+            {
+                //Starting only once the finger is off the screen, so the robot isn't moved as it's let go
+                while(LCD.Touch(&x,&y))
+                {
+                }
+                status.Clear(FEHLCD::Black);
+                break;
+            }
+            //The calibration's results stay up under the reminder
+            status.Line("Touch middle: start run");
+        }
+
         //Writing battery voltage to screen
         bat_v = ((bat_v*m)+Battery.Voltage());
         bat_v = bat_v/(++m);
-        LCD.WriteAt(bat_v, 72, 222);
-
-        if(microSwitchCheck(0))
-        {
-            LCD.Clear(FEHLCD::Black);
-            break;
-        }
+        batteryVolts = bat_v;
+        showBattery();
+        status.Flush();
     }
 
-    //Waiting for start light
-    LCD.WriteLine("Waiting for light to continue");
-    while(true)
-    {
-        if(cdsColor() == CDSRED)
-        {
-            break;
-        }
-    }
+    //Waiting for start light, the message is drawn before the wait so nothing slows the sampling down
+    status.Line("Waiting for start light");
+    status.Flush();
+    startLight.Wait();
+    //Showing how long the detector took to confirm the light
+    status.Clear(FEHLCD::Red);
+    status.Line("Start light reaction (ms)");
+    status.Line(1000*startLight.Reaction());
 
     //Obtaining ice cream lever value now that the run has started.
     icecreamLever = RPS.GetIceCream();
 
-    //Course functions
-    tray();
-    lineFollow(2);
-    icecream_1(icecreamLever);
-    burger();
-    icecream_2(icecreamLever);
-    ticket();
-    jukebox();
-    jBox2Final();
+    //Starting the background tasks, they run whenever a move or line follow is waiting on the scheduler
+    scheduler.Add(status, STATUS_PERIOD);
+    scheduler.Add(batterySampler, BATTERY_PERIOD);
+    scheduler.Add(batteryDisplay, DISPLAY_PERIOD);
+    //Tracking the robot's pose from where RPS first sees it, watching the tilt for the ramp
+    poseEstimate.SetFromRPS();
+    poseEstimate.useTilt = true;
+    scheduler.Add(poseEstimate, POSE_PERIOD);
+    //Recording the run, and writing it out to the SD card between the other tasks
+    scheduler.Add(telemetry, TELEMETRY_PERIOD);
+    scheduler.Add(telemetry.writer, TELEMETRY_WRITE_PERIOD);
+
+    if (scripted)
+    {
+        //Course mission, a step that can't be run stops the robot there
+        if (!mission.Run())
+        {
+            status.Clear(FEHLCD::Black);
+            status.Line("Mission stopped at step");
+            status.Line(mission.failed);
+        }
+    } else
+    {
+        //Course functions, each marked in the telemetry
+        telemetry.state = TASK_TRAY;
+        tray();
+        lineFollow(2);
+        telemetry.state = TASK_ICECREAM;
+        icecream_1(icecreamLever);
+        telemetry.state = TASK_BURGER;
+        burger();
+        telemetry.state = TASK_ICECREAM;
+        icecream_2(icecreamLever);
+        telemetry.state = TASK_TICKET;
+        ticket();
+        telemetry.state = TASK_JUKEBOX;
+        jukebox();
+        telemetry.state = TASK_FINAL;
+        jBox2Final();
+    }
 
 
-    //Printing statement to show code completion
-    LCD.Clear(FEHLCD::Black);
-    LCD.WriteLine("Done.");
+    //Printing statement to show code completion, with what stalls cost the run
+    status.Clear(FEHLCD::Black);
+    status.Line("Done.");
+    status.Line("Stalls and seconds lost");
+    status.Line(stallLog.count);
+    status.Line(stallLog.lost);
+    if (scripted)
+    {
+        //Seconds the mission spent on reading and dispatching steps rather than moving
+        status.Line("Mission steps, overhead ms");
+        status.Line(mission.executed);
+        status.Line(1000*mission.overhead);
+    }
+    //Writing out the rest of the telemetry, records the ring had no room for were dropped
+    scheduler.Remove(telemetry);
+    scheduler.Remove(telemetry.writer);
+    telemetry.Close();
+    status.Line("Telemetry kept, dropped");
+    status.Line(telemetry.recorded);
+    status.Line(telemetry.dropped);
+    status.Flush();
+    stallLog.Save(STALL_FILE, startLight.detected);
     return 0;
 }
 
 //Function definition for moving a linear distance, input is a linear distance
 void linearMove(float distance, float speed)
 {
-    //Temp variable
-    float x;
-    //Converts distance input into the number of counts for the shaft encoder to move for
-    x = (318.0/(WHEEL*PI))*abs(distance);
-    //Reset counts for safety
-    leftEncoder.ResetCounts();
-    rightEncoder.ResetCounts();
     //Displaying goal
-    LCD.Clear(FEHLCD::Black);
-    LCD.WriteLine("Moving");
-    LCD.WriteLine(distance);
-    //Checks if forward or backwards distance is requested
-    if (distance>0)
-    {
-        //Move forward for number of counts
-        rightMotor.SetPercent(speed);
-        leftMotor.SetPercent(speed);
-        while(leftEncoder.Counts() < x)
-        {
-        }
-    }else if (distance<0)
+    status.Clear();
+    status.Line("Moving");
+    status.Line(distance);
+    //Drives the distance with the closed-loop controller, which holds the heading straight and follows an accelerate, cruise, decelerate profile
+    //The controller is a scheduler task stepped every DRIVE_PERIOD, the background tasks run in between
+    async.Await(async.Drive(distance, speed));
+    //A move pinned against something ends early instead of pushing on, logged as a stall
+    if (drive.stalled)
     {
-        //Move backward for number of counts
-        rightMotor.SetPercent(-speed);
-        leftMotor.SetPercent(-speed);
-        while(leftEncoder.Counts() < x)
-        {
-        }
+        status.Line("Move stalled");
+        stallLog.Add("move", drive.stallStart);
     }
-    //Stop motors
-    leftMotor.Stop();
-    rightMotor.Stop();
     //Reset counts
-    LCD.WriteLine("Actual movement:");
-    LCD.WriteLine(leftEncoder.Counts()/(318.0/(WHEEL*PI)));
-    LCD.WriteLine(rightEncoder.Counts()/(318.0/(WHEEL*PI)));
+    status.Line("Actual movement:");
+    status.Line(leftEncoder.Counts()/kinematics.CountsPerInch());
+    status.Line(rightEncoder.Counts()/kinematics.CountsPerInch());
     leftEncoder.ResetCounts();
     rightEncoder.ResetCounts();
     //Rest to ensure momentum stops
-    Sleep(REST);
+    scheduler.Pause(REST);
 }
 
 //Function definition for pivoting
 void pivot(float degrees, float speed)
 {
-    //Temp variable
-    float x;
-    //Converts degree input to number of counts the motors need to turn in opposite directions for
-    x = ((318*W2W)/(360*WHEEL))*abs(degrees);
-    //Reset counts for safety
+    //Displaying goal
+    status.Clear();
+    status.Line("Turning");
+    status.Line(degrees);
+    //Turns with the closed-loop controller along a motion profile, with both wheels held to the same count
+    //Asks for a little less or more than degrees to make up for what the calibration says pivots overshoot by
+    async.Await(async.Turn(kinematics.TurnCommand(degrees), speed));
+    if (drive.stalled)
+    {
+        status.Line("Turn stalled");
+        stallLog.Add("turn", drive.stallStart);
+    }
+    //Reset counts
+    status.Line("Actual turn:");
+    status.Line(leftEncoder.Counts()/(kinematics.CountsPerInch()*M_PI*kinematics.track/360));
+    status.Line(rightEncoder.Counts()/(kinematics.CountsPerInch()*M_PI*kinematics.track/360));
+    leftEncoder.ResetCounts();
+    rightEncoder.ResetCounts();
+    //Rest to insure momentum stops
+    scheduler.Pause(REST);
+}
+
+//Function definition for driving along an arc
+void arc(float radius, float degrees, float speed)
+{
+    //Displaying goal
+    status.Clear();
+    status.Line("Arcing");
+    status.Line(radius);
+    status.Line(degrees);
+    //Both wheels follow one profile at the ratio the radius needs, the heading PID keeps them to it
+    async.Await(async.Arc(radius, degrees, speed));
+    if (drive.stalled)
+    {
+        status.Line("Arc stalled");
+        stallLog.Add("arc", drive.stallStart);
+    }
+    //Reset counts
     leftEncoder.ResetCounts();
     rightEncoder.ResetCounts();
+    //Rest to ensure momentum stops
+    scheduler.Pause(REST);
+}
+
+//Function definition for shifting sideways
+void sidestep(float right, float forward, float speed)
+{
+    float turn, radius;
     //Displaying goal
-    LCD.Clear(FEHLCD::Black);
-    LCD.WriteLine("Turning");
-    LCD.WriteLine(degrees);
-    //Checks for negative (left) or positive (right) turn
-    if (degrees > 0)
-    {
-        //Turn right for the number of counts
-        rightMotor.SetPercent(-speed);
-        leftMotor.SetPercent(speed);
-        while ((leftEncoder.Counts()) <= x)
+    status.Clear();
+    status.Line("Sidestepping");
+    status.Line(right);
+    //Two equal arcs turning opposite ways make an S that ends parallel to the start, right inches over and forward inches on
+    //(was a pivot, a short move and a pivot back, three stops)
+    turn = 2*atan2(fabs(right), fabs(forward));
+    if (turn < 0.001)
+    {
+        linearMove(forward, speed);
+        return;
+    }
+    radius = fabs(forward)/(2*sin(turn));
+    turn = turn*180.0/M_PI;
+    radius = (forward < 0) ? -radius : radius;
+    //Backing up turns the other way to end up on the same side
+    turn = (right*forward < 0) ? -turn : turn;
+    //Queued so the robot rolls from one arc into the other without stopping
+    motion.Arc(radius, turn, speed);
+    motion.Arc(radius, -turn, speed);
+    motion.Run();
+    leftEncoder.ResetCounts();
+    rightEncoder.ResetCounts();
+    //Rest to ensure momentum stops
+    scheduler.Pause(REST);
+}
+
+//Function definition for driving to a point
+GoToResult goTo(float x, float y, float heading)
+{
+    GoToResult result;
+    //Displaying goal
+    status.Clear();
+    status.Line("Going to");
+    status.Line(x);
+    status.Line(y);
+    //Turns to face the point, drives to it and checks the pose estimate, with up to two more legs to make up what the first missed
+    result = navigator.GoTo(x, y, heading, MOVE, TURN);
+    if (drive.stalled)
+    {
+        status.Line("Go to stalled");
+        stallLog.Add("goto", drive.stallStart);
+    }
+    //How close it got and how long it took
+    status.Line("Off by:");
+    status.Line(result.error);
+    status.Line(result.elapsed);
+    leftEncoder.ResetCounts();
+    rightEncoder.ResetCounts();
+    return result;
+}
+
+//Function definition for checking the color that the CdS cell sees
+ColorReading cdsColor()
+{
+    /*Classifies the median of a burst of readings against the calibrated levels, so one noisy reading can't change the color.
+    Will change the LCD display to match the color it detects, once the status display catches up*/
+    ColorReading light = cdsSensor.Read();
+    switch(light.color)
+    {
+    case CDSRED:
+        status.Clear(FEHLCD::Red);
+        break;
+    case CDSBLUE:
+        status.Clear(FEHLCD::Blue);
+        break;
+    case NO_COLOR:
+        status.Clear(FEHLCD::Black);
+        status.Line("No colored light detected");
+        break;
+    default:
+        return light;
+    }
+    status.Line("CdS volts and confidence");
+    status.Line(light.volts);
+    status.Line(light.confidence);
+    return light;
+}
+
+//Function definition for checking one CdS reading against the calibrated levels
+bool cdsLit(int unused)
+{
+    return cdsSensor.Colored(CdS.Value());
+}
+
+//Function definition for checking the events a drive can wait for
+bool driveEvent(int event)
+{
+    switch(event)
+    {
+    case EVENT_FRONT_ANY:
+        return frontLeftSwitch.Value() == false || frontRightSwitch.Value() == false;
+    case EVENT_FRONT_BOTH:
+        return !microSwitchCheck(0);
+    case EVENT_BACK_ANY:
+        return backLeftSwitch.Value() == false || backRightSwitch.Value() == false;
+    case EVENT_BACK_BOTH:
+        return !microSwitchCheck(1);
+    case EVENT_FORK:
+        return forkSwitch.Value() == false;
+    case EVENT_LINE:
+        return lineSensors.OnLine();
+    case EVENT_COLOR:
+        return cdsLit(0);
+    default:
+        //An unknown event is taken as having happened so the robot doesn't drive off
+        return true;
+    }
+}
+
+//Function definition for running into a wall and squaring up against it
+UntilResult hitWall(int side, float speed, float limit)
+{
+    UntilResult hit;
+    //The back of the robot is the negative direction
+    float dir = (side == 1) ? -1 : 1;
+    int i;
+    for (i = 0; i < STALL_TRIES; i++)
+    {
+        hit = until.Drive(dir*limit, speed, driveEvent, side == 0 ? EVENT_FRONT_ANY : EVENT_BACK_ANY, WALL_TIMEOUT);
+        if (hit.reason == UNTIL_STALL)
+        {
+            //Pinned on something short of the wall
+            recoverStall(dir, "wall");
+            continue;
+        }
+        if (hit.reason != UNTIL_FOUND)
         {
+            status.Line("No wall, driven (in)");
+            status.Line(hit.distance);
+            return hit;
         }
-    } else if (degrees < 0)
+        //Pushing on slowly so the other switch catches up, for SQUARE_TIMEOUT at most if it never does
+        until.Square(SQUARE, driveEvent, side == 0 ? EVENT_FRONT_BOTH : EVENT_BACK_BOTH, SQUARE_TIMEOUT);
+        return hit;
+    }
+    return hit;
+}
+
+//Function definition for pushing until an event, getting free and trying again after a stall
+UntilResult pushUntil(float power, int event, float timeout)
+{
+    UntilResult push;
+    int i;
+    for (i = 0; i < STALL_TRIES; i++)
     {
-        //Turn left for the number of counts
-        rightMotor.SetPercent(speed);
-        leftMotor.SetPercent(-speed);
-        while ((rightEncoder.Counts()) <= x)
+        push = until.Push(power, driveEvent, event, timeout);
+        if (push.reason != UNTIL_STALL)
         {
+            break;
         }
+        recoverStall((power < 0) ? -1 : 1, event == EVENT_FORK ? "fork" : "push");
     }
-    //Stop motors
-    leftMotor.Stop();
-    rightMotor.Stop();
-    //Reset counts
-    LCD.WriteLine("Actual turn:");
-    LCD.WriteLine(leftEncoder.Counts()/((318*W2W)/(360*WHEEL)));
-    LCD.WriteLine(rightEncoder.Counts()/((318*W2W)/(360*WHEEL)));
-    leftEncoder.ResetCounts();
-    rightEncoder.ResetCounts();
-    //Rest to insure momentum stops
-    Sleep(REST);
+    return push;
 }
 
-//Function definition for checking the color that the CdS cell sees
-int cdsColor()
+//Function definition for switching stall detection for moves into something
+void contact(bool on)
+{
+    drive.stall.enabled = !on;
+}
+
+//Function definition for getting free after a stall
+void recoverStall(float dir, const char *where)
+{
+    double start = drive.stallStart;
+    status.Line("Stalled, backing off");
+    linearMove(-dir*BACK_OFF, MOVE);
+    stallLog.Add(where, start);
+}
+
+//Function definition for calibrating the CdS cell, the robot is held over each light in turn and the screen touched to take the reading
+void calibrateCdS()
+{
+    const char *names[COLOR_COUNT] = {"red light", "blue light", "no colored light"};
+    float x,y;
+    int i;
+    for (i = 0; i < COLOR_COUNT; i++)
+    {
+        //Waiting for the last touch to end so one touch doesn't capture every color
+        while(LCD.Touch(&x,&y))
+        {
+        }
+        status.Clear(FEHLCD::Black);
+        status.Line("Put the CdS cell over the");
+        status.Line(names[i]);
+        status.Line("and touch the screen");
+        status.Flush();
+        while(!LCD.Touch(&x,&y))
+        {
+        }
+        status.Line(cdsSensor.Capture(i));
+        status.Flush();
+    }
+    //Only a table in the right order is kept, otherwise the one on the SD card is read back
+    if (cdsSensor.Valid() && cdsSensor.Save(CDS_CALIBRATION))
+    {
+        status.Line("Calibration saved");
+    } else
+    {
+        status.Line("Bad calibration, not saved");
+        cdsSensor.Load(CDS_CALIBRATION);
+    }
+    status.Flush();
+    while(LCD.Touch(&x,&y))
+    {
+    }
+}
+
+//Function definition for calibrating the drive, the robot drives and pivots in the open while RPS watches
+void calibrateDrive()
 {
-    /*Simple if checks to determine what color the CdS cell sees based off of measured ranges.
-    Will change the LCD display to match the color it detects*/
-    if (CdS.Value() > 0 && CdS.Value() <= 0.90)
+    //Drives there and back so the robot ends near where it started, and pivots of several sizes each way for the turn error
+    const float drives[] = {12, -12, 24, -24};
+    const float turns[] = {90, -90, 180, -180, 45, -45, 20, -20};
+    KinematicCalibration cal(drive);
+    float x,y;
+    int i;
+    while(LCD.Touch(&x,&y))
     {
-        LCD.Clear(FEHLCD::Red);
-        return CDSRED;
-    } else if (CdS.Value() > 0.90 && CdS.Value() <= 1.8)
+    }
+    status.Clear(FEHLCD::Black);
+    status.Line("Put the robot in the open");
+    status.Line("with 2 ft of room ahead");
+    status.Line("and touch the screen");
+    status.Flush();
+    while(!LCD.Touch(&x,&y))
+    {
+    }
+    //Measuring with the geometry there is now, the fit corrects it
+    status.Line("Calibrating drive");
+    status.Flush();
+    for (i = 0; i < (int)(sizeof(drives)/sizeof(drives[0])); i++)
+    {
+        cal.Straight(drives[i], MOVE);
+    }
+    for (i = 0; i < (int)(sizeof(turns)/sizeof(turns[0])); i++)
     {
-        LCD.Clear(FEHLCD::Blue);
-        return CDSBLUE;
-    } else if (CdS.Value() > 1.80 && CdS.Value() <= 3.3)
+        cal.Pivot(turns[i], TURN);
+    }
+    //Only a fit that makes sense is kept, otherwise the one on the SD card is read back
+    if (cal.Fit(kinematics) && kinematics.Save(KINEMATICS_FILE))
     {
-        LCD.Clear(FEHLCD::Black);
-        LCD.Write("No colored light detected");
-        return NO_COLOR;
+        status.Line("Wheel, track, turn offset:");
+        status.Line(kinematics.wheel);
+        status.Line(kinematics.track);
+        status.Line(kinematics.turnOffset);
     } else
     {
-        return NO_READING;
+        status.Line("Bad calibration, not saved");
+        kinematics.Load(KINEMATICS_FILE);
+    }
+    useKinematics();
+    status.Flush();
+    while(LCD.Touch(&x,&y))
+    {
     }
 }
 
+//Function definition for setting up the drive geometry
+void useKinematics()
+{
+    drive.SetGeometry(kinematics.CountsPerInch(), kinematics.track);
+    poseEstimate.SetGeometry(kinematics.CountsPerInch(), kinematics.track);
+}
+
 //Funtion for testing the CdS cell values
 void testCdS()
 {
     float x,y;
-    LCD.Clear(FEHLCD::Black);
-        LCD.WriteLine("Checking CdS Cell function");
+    status.Clear(FEHLCD::Black);
+        status.Line("Checking CdS Cell function");
         while(true)
         {
-            LCD.WriteLine(CdS.Value());
+            status.Line(CdS.Value());
+            status.Flush();
             if(LCD.Touch(&x,&y))
             {
-                LCD.WriteLine("Ending CdS reading...");
+                status.Line("Ending CdS reading...");
+                status.Flush();
                 Sleep(1.0);
                 break;
             }
@@ -329,97 +891,49 @@ void testCdS()
 }
 
 //Function definition for following a line
-void lineFollow(int condition)
+bool lineFollow(int condition, float limit, float timeout)
 {
-    //initilizing state variable
-    int state, time = 0;
-
     //print statement to show what robot is doing
-    LCD.Clear(FEHLCD::Black);
-    LCD.WriteLine("Looking for line");
+    status.Clear();
+    status.Line("Looking for line");
     findLine();
-    LCD.Clear(FEHLCD::Black);
-    LCD.WriteLine("Following Line");
+    status.Clear();
+    status.Line("Following Line");
 
-    //This loop will call the checkCondition function to determine when to break, with condition 0 running indefinitly, 1 running until a microswitch input, 2 a touchscreen input
-    while(checkCondition(condition))
+    //The follower calls the checkCondition function to determine when to break, with condition 0 running indefinitly, 1 running until a microswitch input, 2 a touchscreen input
+    //Each period it steers with a PID on where the line is across the optosensors, as a scheduler task at LINE_PERIOD
+    follower.gains.speed = FOLLOW;
+    followCounts = limit*kinematics.CountsPerInch();
+    followStart = TimeNow();
+    followEnd = (timeout > 0) ? followStart + timeout : 0;
+    followStopped = false;
+    followLeft = leftEncoder.Counts();
+    followRight = rightEncoder.Counts();
+    follower.Begin(followCheck, condition);
+    scheduler.Run(follower, LINE_PERIOD);
+    if (followStopped)
     {
-        //Updating state to turn based on optosensor inputs. > means that the sensor is seeing dark, < is the sensor seeing light
-        if(rightLine.Value() < RIGHT_BREAK && centerLine.Value() > CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
-        {
-            state = ON_LINE;
-            if(time == 0)
-            {
-                time = TimeNow();
-            }
-        } else if (rightLine.Value() > RIGHT_BREAK && centerLine.Value() > CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
-        {
-            state = LINE_ON_RIGHT;
-            time = 0;
-        }else if (rightLine.Value() < RIGHT_BREAK && centerLine.Value() > CENTER_BREAK && leftLine.Value() > LEFT_BREAK)
-        {
-            state = LINE_ON_LEFT;
-            time = 0;
-        }else if (rightLine.Value() > RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
-        {
-            state = LINE_FAR_RIGHT;
-            time = 0;
-        }else if (rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() > LEFT_BREAK)
-        {
-            state = LINE_FAR_LEFT;
-            time = 0;
-        }else if (rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
-        {
-            state = OFF_LINE;
-            time = 0;
-        }
+        status.Line("Line follow cut short");
+        status.Line(TimeNow() - followStart);
+    }
+    return !followStopped;
+}
 
-        //Setting state of line based on where sensors are located in relationship to the line
-        switch(state)
-        {
-        case ON_LINE:
-            if(TimeNow() - time < 2.0)
-            {
-                rightMotor.SetPercent(-10);
-                leftMotor.SetPercent(-10);
-            }else if (TimeNow() - time >= 2.0)
-            {
-                rightMotor.SetPercent(-20);
-                leftMotor.SetPercent(-20);
-            }
-            break;
-        case LINE_ON_RIGHT:
-            rightMotor.SetPercent(-20);
-            leftMotor.SetPercent(-10);
-            break;
-        case LINE_ON_LEFT:
-            rightMotor.SetPercent(-10);
-            leftMotor.SetPercent(-20);
-            break;
-        case LINE_FAR_RIGHT:
-            rightMotor.SetPercent(-30);
-            leftMotor.SetPercent(-10);
-            break;
-        case LINE_FAR_LEFT:
-            rightMotor.SetPercent(-10);
-            leftMotor.SetPercent(-30);
-            break;
-        case OFF_LINE:
-            rightMotor.Stop();
-            leftMotor.Stop();
-            break;
-        default:
-            rightMotor.Stop();
-            leftMotor.Stop();
-            break;
-        }
+//Function definition for stopping a lineFollow() at its limits before checking its end condition
+bool followCheck(int end, LineSnapshot line)
+{
+    if ((followCounts > 0 && (leftEncoder.Counts() - followLeft + rightEncoder.Counts() - followRight)/2 >= followCounts) ||
+        (followEnd > 0 && TimeNow() >= followEnd))
+    {
+        followStopped = true;
+        return false;
     }
+    return checkCondition(end, line);
 }
 
 //Function definition for checking if the desired end condition for the line following is met
-bool checkCondition(int end)
+bool checkCondition(int end, LineSnapshot line)
 {
-    float x,y;
     switch(end)
     {
     case 0:
@@ -436,7 +950,7 @@ bool checkCondition(int end)
         }
     case 2:
         //Off of the line
-        if (rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
+        if (line.mask == 0)
         {
             return false;
         }else
@@ -444,8 +958,8 @@ bool checkCondition(int end)
             return true;
         }
     default:
-        LCD.WriteLine("No ending condition for line following entered");
-        LCD.WriteLine("Skipping line following");
+        status.Line("No line follow end given");
+        status.Line("Skipping line following");
         return false;
     }
 }
@@ -456,7 +970,7 @@ void findLine()
     int i;
     for (i = 1; i < 7; i++)
     {
-        if (rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
+        if (!lineSensors.OnLine())
         {
             if (i % 2 == 0)
             {
@@ -497,151 +1011,131 @@ bool microSwitchCheck(int side)
             return true;
         }
     default:
-        LCD.WriteLine("Improper integer input for checking microswitches");
+        status.Line("Bad microswitch selection");
         Sleep(3.0);
         return false;
     }
 }
 
-void jukebox()
+//Function definition for reading the jukebox light
+ColorReading readJukebox()
 {
-    //Moving unill the robot runs into the wall
-    leftMotor.SetPercent(MOVE);
-    rightMotor.SetPercent(MOVE);
-    while(microSwitchCheck(0))
+    ColorReading light;
+    UntilResult scan;
+    int i;
+    //Creeping forward untill the CdS cell reads a red or blue light, stopping as soon as it does
+    status.Clear();
+    status.Line("Scanning for jukebox light");
+    scan = until.Drive(SCAN_LIMIT, SCAN, driveEvent, EVENT_COLOR);
+    if (scan.reason == UNTIL_FOUND)
+    {
+        status.Line("Light found at (in)");
+        status.Line(scan.distance);
+    }
+    scheduler.Pause(REST);
+    light = cdsColor();
+    //Moving forward in small increments if the scan stopped short of the light, giving up after SCAN_STEPS and going for the blue button
+    for (i = 0; i < SCAN_STEPS && light.color == NO_COLOR; i++)
     {
+        linearMove(0.1, MOVE);
+        scheduler.Pause(REST);
+        light = cdsColor();
     }
-    leftMotor.Stop();
-    rightMotor.Stop();
+    //Reading a doubtful light again in place, a wrong button costs a penalty and a retry
+    for (i = 0; i < CDS_RETRIES && light.confidence < CDS_CONFIDENCE; i++)
+    {
+        light = cdsColor();
+    }
+    return light;
+}
+
+//Function definition for pressing the jukebox button
+void jukebox()
+{
+    ColorReading light;
+    Pose to;
+    //Moving unill the robot runs into the wall
+    hitWall(0, MOVE, 24);
     //Backing up off the wall
     linearMove(-4, MOVE);
     //Turning to face the jukebox
     pivot(-90, TURN);
-    //Moving forward in small increments untill the CdS cell reads a red or blue light
-    do
-    {
-        linearMove(0.1, MOVE);
-        Sleep(REST);
-    } while(cdsColor() == NO_COLOR);
-    //Switch case for red and blue lights
-    switch(cdsColor())
+    light = readJukebox();
+    //Switch case for red and blue lights, decided from the one reading
+    switch(light.color)
     {
     case CDSRED:
-        //Turn left a bit
-        pivot(45, TURN);
-        //Move forward an inch
-        linearMove(1, MOVE);
-        //Re-align with the jukebox's red button
-        pivot(-45, TURN);
-        //Run into red button
-        linearMove(3, MOVE);
-        //Back off of button
-        linearMove(-6, MOVE);
-        //Turn towards the final zone
-        pivot(-90, TURN);
-        //Move towards the final zone
-        linearMove(-6, MOVE);
+        //Shift over to the jukebox's red button and run into it in one S-shaped move
+        //(was a 45 degree pivot, an inch, a pivot back and 3 inches)
+        contact(true);
+        sidestep(JUKEBOX_SHIFT, JUKEBOX_PUSH, MOVE);
+        contact(false);
+        //Back off of button and swing around to face the final button in one drive
+        to = Navigator::Offset(poseEstimate.pose, FINAL_BACK, FINAL_RED_LEFT, FINAL_TURN);
+        goTo(to.x, to.y, to.heading);
+        break;
     case CDSBLUE:
-        //Turn right a bit
-        pivot(-45, TURN);
-        //Move for an inch
-        linearMove(1, MOVE);
-        //Re-align with the jukebox's blue button
-        pivot(45, TURN);
-        //Run into blue button
-        linearMove(3, MOVE);
-        //Back off of button
-        linearMove(-6, MOVE);
-        //Turn towards final zone
-        pivot(-90, TURN);
-        //Move towards final zone (red and move movements are different because the blue is further away from the final zone)
-        linearMove(-8, MOVE);
+        //Shift over to the jukebox's blue button and run into it in one S-shaped move
+        contact(true);
+        sidestep(-JUKEBOX_SHIFT, JUKEBOX_PUSH, MOVE);
+        contact(false);
+        //Back off of button and swing around to face the final button in one drive
+        to = Navigator::Offset(poseEstimate.pose, FINAL_BACK, FINAL_BLUE_LEFT, FINAL_TURN);
+        goTo(to.x, to.y, to.heading);
+        break;
     default:
         //default is blue
-        //Turn right a bit
-        pivot(-45, TURN);
-        //Move for an inch
-        linearMove(1, MOVE);
-        //Re-align with the jukebox's blue button
-        pivot(45, TURN);
-        //Run into blue button
-        linearMove(3, MOVE);
-        //Back off of button
-        linearMove(-6, MOVE);
-        //Turn towards final zone
-        pivot(-90, TURN);
-        //Move towards final zone (red and move movements are different because the blue is further away from the final zone)
-        linearMove(-8, MOVE);
+        //Shift over to the jukebox's blue button and run into it in one S-shaped move
+        contact(true);
+        sidestep(-JUKEBOX_SHIFT, JUKEBOX_PUSH, MOVE);
+        contact(false);
+        //Back off of button and swing around to face the final button in one drive
+        to = Navigator::Offset(poseEstimate.pose, FINAL_BACK, FINAL_BLUE_LEFT, FINAL_TURN);
+        goTo(to.x, to.y, to.heading);
     }
 }
 
 //Function definition for dumping the tray
 void tray()
 {
-    //This float is exclusively required to go up the ramp at a high speed but slow down to a slower speed without stopping to prevent the tray from flying off, the value in abs() is the distance being traveled
-    float start = (318.0/(WHEEL*PI))*abs(2);
-    float ramp = (318.0/(WHEEL*PI))*abs(22);
     //This function is set up to start at the beginning of the course and move the robot up the ramp and dump the tray at the sink
-    //Going up ramp from starting position
-    rightMotor.SetPercent(0.65*MOVE);
-    leftMotor.SetPercent(0.65*MOVE);
-    while(leftEncoder.Counts() < start)
-    {
-    }
-    linearMove(8, MOVE);
-    pivot(45, TURN);
-    //A chunk of the linearMove function is used here in order to move a set distance to get up the ramp, however, it is modified to not stop the motors so that the robot can
-    //instead switch to a slower speed without stopping in order to prevent the tray from flying off of the robot
-    rightMotor.SetPercent(1.5*MOVE);
-    leftMotor.SetPercent(1.5*MOVE);
-    while(leftEncoder.Counts() < ramp)
-    {
-    }
-    linearMove(9, MOVE);
+    //Going up ramp from starting position, the queue changes speed between moves without stopping so the tray doesn't fly off
+    motion.Line(2, 0.65*MOVE);
+    //Stopping before the turn so the robot is square with the ramp
+    motion.Line(8, MOVE, true);
+    motion.Pivot(45, TURN);
+    //Going up the ramp at a high speed, then slowing down for the top without stopping
+    motion.Line(22, 1.5*MOVE);
+    motion.Line(9, MOVE);
     //Turning towards the sink
-    pivot(-90, 0.75*TURN);
+    motion.Pivot(-90, 0.75*TURN);
+    motion.Run();
     //Running into the side wall next to the sink, checking for front microswitch inputs
-    leftMotor.SetPercent(0.75*MOVE);
-    rightMotor.SetPercent(0.75*MOVE);
-    while(microSwitchCheck(0))
-    {
-    }
-    leftMotor.Stop();
-    rightMotor.Stop();
+    hitWall(0, 0.75*MOVE, 24);
     //Backing up to align with the sink
     linearMove(-3, 0.75*MOVE);
     //Turning to face sink
     pivot(-90, TURN);
     //Running into sink at a high speed in order to dump tray by checking for front microswitch inputs
-    leftMotor.SetPercent(1.5*MOVE);
-    rightMotor.SetPercent(1.5*MOVE);
-    while(microSwitchCheck(0))
-    {
-    }
-    leftMotor.Stop();
-    rightMotor.Stop();
-    Sleep(REST);
+    hitWall(0, 1.5*MOVE, 18);
+    scheduler.Pause(REST);
 }
 
 //Function definition for moving the ticket using the servo arm
 void ticket()
 {
+    Motion turn, arm;
     //Moving untill the robot hits the wall by the ticket
-    leftMotor.SetPercent(MOVE);
-    rightMotor.SetPercent(MOVE);
-    while(microSwitchCheck(0))
-    {
-    }
-    leftMotor.Stop();
-    rightMotor.Stop();
+    hitWall(0, MOVE, TICKET_WALL);
     //Backing up off the wall
     linearMove(-6.5, MOVE);
     //Turning to position the servo arm
     pivot(90, TURN);
     linearMove(13, MOVE);
-    pivot(45, TURN);
-    //Deploying the servo arm
-    servo_arm.SetDegree(100);
+    //Deploying the servo arm while turning towards the ticket
+    turn = async.Turn(45, TURN);
+    arm = async.Servo(armMove, 100);
+    async.AllOf(turn, arm);
     //Inserting the servo arm into the ticket slot
     pivot(30, TURN);
     linearMove(-2,MOVE);
@@ -650,12 +1144,11 @@ void ticket()
     linearMove(5, MOVE);
     //Removing the servo arm from the ticket slot
     pivot(-45, TURN);
-    //Reseting the servo arm
-    servo_arm.SetDegree(0);
-    //Re-aligning the robot
+    //Reseting the servo arm while re-aligning the robot and moving towards the ramp
+    arm = async.Servo(armMove, 0);
     pivot(45, TURN);
-    //Moving towards the ramp
     linearMove(8, MOVE);
+    async.Await(arm);
     //Turning to face the ramp
     pivot(90, TURN);
     //Going down the ramp
@@ -664,202 +1157,253 @@ void ticket()
 
 void burger()
 {
-    float t;
+    Motion fork, back;
     //Backing off of the wall
     linearMove(-2.2,MOVE);
     //Turning so that the back of the robot is facing the burger station
     pivot(90, TURN);
     //Moving the robot up to the burger staton
     //Slowly moving forward until the microswitch on the fork is activated or it times out at 5 seconds, indicating that the fork is inserted into the wheel
-    t = TimeNow();
-    rightMotor.SetPercent(-10);
-    leftMotor.SetPercent(-10);
-    while((forkSwitch.Value() == true) && (TimeNow() - t < 5.0))
-    {
-    }
-    rightMotor.Stop();
-    leftMotor.Stop();
-    Sleep(REST);
-    //Rotating the fork and wheel
-    servo_fork.SetDegree(95);
-    Sleep(2.0);
-    //Resetting the hotplate position
-    servo_fork.SetDegree(0);
-    //Backing away from the hotplate
-    linearMove(0.5, MOVE);
-    //Turning to face the line that leads to the icecream machine
+    //If the robot stalls against the station without the fork in the wheel it pulls away and tries again
+    pushUntil(-10, EVENT_FORK, 5.0);
+    scheduler.Pause(REST);
+    //Rotating the fork and wheel, then holding it over
+    async.Await(async.Servo(forkMove, 95, FLIP_HOLD));
+    //Resetting the hotplate position while backing away from the hotplate
+    fork = async.Servo(forkMove, 0);
+    back = async.Drive(0.5, MOVE);
+    async.AllOf(fork, back);
+    //Turning to face back along the ice cream lanes
     pivot(-90, TURN);
-    //Following line over to ice cream machine
-    lineFollow(2);
+    //The robot is between the first two lanes with its sensors past the second lane's line, as far as they can tell it is
+    //on the second lane, and crossing that line forward leaves it on the first for icecream_2() to count from
+    lane = 1;
+    crossLanes(-1);
 }
 
 //Function definition for flipping the proper lever down
 void icecream_1(int lever)
 {
-    //Depending on the lever reading from rps, the robot will navigate to the correct line to then run into the lever
-    if (lever == 0)
-    {
-        //Already in line for the first lever, so turn to face it
-        pivot(90, TURN);
-        //Run into the lever
-        linearMove(12, MOVE);
-        Sleep(1.0);
-        //Back off of the lever using line following
-        lineFollow(2);
-        //Turn to face the burger area
-        pivot(-90, TURN);
-        //Move to the second icecream line
-        rightMotor.SetPercent(-20);
-        leftMotor.SetPercent(-20);
-        while(rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
-        {
-        }
-        rightMotor.Stop();
-        leftMotor.Stop();
-        //Move to the third icecream line
-        rightMotor.SetPercent(-20);
-        leftMotor.SetPercent(-20);
-        while(rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
-        {
-        }
-        rightMotor.Stop();
-        leftMotor.Stop();
-    }else if (lever == 1)
-    {
-        //Move from the first icecream line to the second
-        rightMotor.SetPercent(-20);
-        leftMotor.SetPercent(-20);
-        while(rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
-        {
-        }
-        rightMotor.Stop();
-        leftMotor.Stop();
-        //Turn to face the lever
-        pivot(90, TURN);
-        //Run into the lever
-        linearMove(12, MOVE);
-        Sleep(1.0);
-        //Back off of the lever using line following
-        lineFollow(2);
-        //Turn to face the burger area
-        pivot(-90, TURN);
-        //Move to the third icecream line
-        rightMotor.SetPercent(-20);
-        leftMotor.SetPercent(-20);
-        while(rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
-        {
-        }
-        rightMotor.Stop();
-        leftMotor.Stop();
-    }else if (lever == 2)
-    {
-        //Move from the first icecream line to the second
-        rightMotor.SetPercent(-20);
-        leftMotor.SetPercent(-20);
-        while(rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
-        {
-        }
-        rightMotor.Stop();
-        leftMotor.Stop();
-        //Move to the third icecream line
-        rightMotor.SetPercent(-20);
-        leftMotor.SetPercent(-20);
-        while(rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
-        {
-        }
-        rightMotor.Stop();
-        leftMotor.Stop();
-        //Turn and face the lever
-        pivot(90, TURN);
-        //Run into the lever
-        linearMove(12, MOVE);
-        Sleep(1.0);
-        //Back off of the lever using line following
-        lineFollow(2);
-        //Turn and face the burger area
-        pivot(-90, TURN);
-    }
-    //Follow the line unill the microswitches are pressed
-    lineFollow(1);
+    //The robot starts on the first lane, backs up to the lever's one and flips it
+    lane = 0;
+    crossLanes(lever);
+    flipLever(LEVER_PUSH);
+    //Turn to face the burger area and come back to the first lane
+    pivot(-90, TURN);
+    crossLanes(-lever);
+    //Backing until the sensors are on a line, where burger() lines up from (the old loops only ever moved this far)
+    until.Drive(-LANE_SPACING, LANE_SPEED, driveEvent, EVENT_LINE);
+    //Follow the line unill the microswitches are pressed, giving up short of driving into the wall for good
+    lineFollow(1, FOLLOW_WALL_LIMIT, FOLLOW_WALL_TIMEOUT);
 }
 
 //Function definition for flipping the proper lever back up
 void icecream_2(int lever)
 {
-    if (lever == 0)
+    //Backing along the lanes from the one burger() left the robot on to the lever's, facing the same way as icecream_1()
+    crossLanes(lever - lane);
+    flipLever(LEVER_REPUSH);
+    //Back away from the lever to the height of the wall by the ticket
+    linearMove(-TICKET_BACK_OFF, MOVE);
+    //Turn to have the bumper face the wall
+    pivot(-90, TURN);
+}
+
+//Function definition for crossing the ice cream lanes
+void crossLanes(int lanes)
+{
+    UntilResult crossed;
+    if (lanes == 0)
     {
-        //Move from the third icecream line to the second
-        rightMotor.SetPercent(-20);
-        leftMotor.SetPercent(-20);
-        while(rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
-        {
-        }
-        rightMotor.Stop();
-        leftMotor.Stop();
-        //Move to the first icecream line
-        rightMotor.SetPercent(-20);
-        leftMotor.SetPercent(-20);
-        while(rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
-        {
-        }
-        rightMotor.Stop();
-        leftMotor.Stop();
-        //Turn and face the lever
-        pivot(-90, TURN);
-        //Run into the lever
-        linearMove(12, MOVE);
-        Sleep(1.0);
-        //Back off of the lever using line following
-        lineFollow(2);
-        //Move to line up with the wall by the ticket
-        linearMove(-6, MOVE);
-        //Turn to have the bumper face the wall
-        pivot(135, TURN);
-    }else if (lever == 1)
-    {
-        //Move from the first icecream line to the second
-        rightMotor.SetPercent(-20);
-        leftMotor.SetPercent(-20);
-        while(rightLine.Value() < RIGHT_BREAK && centerLine.Value() < CENTER_BREAK && leftLine.Value() < LEFT_BREAK)
-        {
-        }
-        rightMotor.Stop();
-        leftMotor.Stop();
-        //Turn to face the lever
-        pivot(90, TURN);
-        //Run into the lever
-        linearMove(12, MOVE);
-        Sleep(1.0);
-        //Back off of the lever using line following
-        lineFollow(2);
-        //Move to line up with the wall by the ticket
-        linearMove(-11, MOVE);
-        //Turn to have the bumper face the wall
-        pivot(135, TURN);
-    }else if (lever == 2)
-    {
-        //Already in line for the third lever, so turn to face it
-        pivot(90, TURN);
-        //Run into the lever
-        linearMove(12, MOVE);
-        Sleep(1.0);
-        //Back off of the lever using line following
-        lineFollow(2);
-        //Move to line up with the wall by the ticket
-        linearMove(-15, MOVE);
-        //Turn to have the bumper face the wall
-        pivot(135, TURN);
+        return;
+    }
+    status.Clear();
+    status.Line("Crossing lanes");
+    status.Line(lanes);
+    //One drive across all of them, the line the robot starts on doesn't count. It goes no further than the
+    //target lane, so a line the sensors miss leaves the robot where the lane should be rather than past it
+    lanesCrossed = 0;
+    laneClear = lineSensors.OnLine() ? 0 : LANE_CLEAR;
+    crossed = until.Drive(-lanes*LANE_SPACING, LANE_SPEED, laneReached, abs(lanes));
+    lane += lanes;
+    if (crossed.reason != UNTIL_FOUND)
+    {
+        status.Line("No lane, driven (in)");
+        status.Line(crossed.distance);
+        return;
+    }
+    //The sensors are on the last line counted, behind the robot's middle. Backing up that is the target lane's line,
+    //going forward it is the line of the lane before, so the middle has the rest of a lane to go
+    linearMove((lanes > 0) ? -LINE_OFFSET : LANE_SPACING - LINE_OFFSET, MOVE);
+}
+
+//Function definition for counting lanes as the robot crosses them
+bool laneReached(int lanes)
+{
+    if (!lineSensors.OnLine())
+    {
+        laneClear++;
+        return false;
+    }
+    //Each line counts once, as the sensors come onto it clear of the last one
+    if (laneClear >= LANE_CLEAR)
+    {
+        lanesCrossed++;
     }
+    laneClear = 0;
+    return lanesCrossed >= lanes;
+}
+
+//Function definition for flipping a lever
+void flipLever(float push)
+{
+    //Turn to face the lever
+    pivot(90, TURN);
+    //Run into the lever, which stops the robot on purpose
+    contact(true);
+    linearMove(push, MOVE);
+    contact(false);
+    scheduler.Pause(LEVER_HOLD);
+    //Back off of the lever using line following
+    lineFollow(2);
 }
 
 //Function definition for hitting final button
 void jBox2Final()
 {
-    //Turn and align with the final button
-    pivot(45, TURN);
-    //Run into the finish button
+    //jukebox() left the robot facing the final button, run into it
+    contact(true);
     linearMove(13, MOVE);
-    Sleep(REST);
+    contact(false);
+    scheduler.Pause(REST);
+}
+
+//Function definition for running a mission step, each one does what the course functions above do with the same numbers
+int missionStep(const MissionStep &step)
+{
+    const char *tasks[TASK_COUNT] = MISSION_TASK_NAMES;
+    ServoController &servo = (step.arg == SERVO_FORK) ? forkMove : armMove;
+    Pose to;
+    switch(step.op)
+    {
+    MISSION_CASE(OP_MOVE)
+        contact(step.arg == 1);
+        linearMove(step.a, step.b);
+        contact(false);
+        break;
+    MISSION_CASE(OP_PIVOT)
+        pivot(step.a, step.b);
+        break;
+    MISSION_CASE(OP_ARC)
+        arc(step.a, step.b, step.c);
+        break;
+    MISSION_CASE(OP_SIDESTEP)
+        contact(step.arg == 1);
+        sidestep(step.a, step.b, step.c);
+        contact(false);
+        break;
+    MISSION_CASE(OP_QLINE)
+        motion.Line(step.a, step.b, step.arg == 1);
+        break;
+    MISSION_CASE(OP_QPIVOT)
+        motion.Pivot(step.a, step.b, step.arg == 1);
+        break;
+    MISSION_CASE(OP_QRUN)
+        motion.Run();
+        break;
+    MISSION_CASE(OP_GOTO)
+        to = Navigator::Offset(poseEstimate.pose, step.a, step.b, step.c);
+        goTo(to.x, to.y, to.heading);
+        break;
+    MISSION_CASE(OP_SERVO)
+        async.Await(async.Servo(servo, step.a, step.b));
+        break;
+    MISSION_CASE(OP_SERVO_START)
+        //Kept so a later sync can wait for it, the drive steps in between run alongside
+        missionServos[step.arg == SERVO_FORK] = async.Servo(servo, step.a, step.b);
+        break;
+    MISSION_CASE(OP_SYNC)
+        async.AllOf(missionServos[SERVO_ARM], missionServos[SERVO_FORK]);
+        break;
+    MISSION_CASE(OP_WALL)
+        hitWall(step.arg, step.a, step.b);
+        break;
+    MISSION_CASE(OP_UNTIL)
+        until.Drive(step.a, step.b, driveEvent, step.arg, step.c);
+        break;
+    MISSION_CASE(OP_PUSH)
+        pushUntil(step.a, step.arg, step.b);
+        break;
+    MISSION_CASE(OP_LANES)
+        crossLanes(step.arg);
+        break;
+    MISSION_CASE(OP_FOLLOW)
+        lineFollow(step.arg, step.a, step.b);
+        break;
+    MISSION_CASE(OP_SLEEP)
+        scheduler.Pause(step.a);
+        break;
+    MISSION_CASE(OP_COLOR)
+        return readJukebox().color;
+    MISSION_CASE(OP_LEVER)
+        return RPS.GetIceCream();
+    MISSION_CASE(OP_TASK)
+        status.Clear();
+        status.Line("Task");
+        status.Line((step.arg >= 0 && step.arg < TASK_COUNT) ? tasks[step.arg] : "unknown");
+        telemetry.state = step.arg;
+        break;
+    }
+    return 0;
+}
+
+//Function definition for the motor powers, the line follower drives both wheels the way its speed points
+void motorPowers(float *left, float *right)
+{
+    if (scheduler.Active(follower))
+    {
+        *left = *right = follower.gains.speed;
+    } else
+    {
+        *left = drive.LeftPower();
+        *right = drive.RightPower();
+    }
+}
+
+//Function definition for filling in a telemetry record, the line sensors and CdS cell are read once each
+void sampleTelemetry(TelemetrySample *s)
+{
+    float heading = RPS.Heading();
+    s->leftCounts = leftEncoder.Counts();
+    s->rightCounts = rightEncoder.Counts();
+    motorPowers(&s->leftPower, &s->rightPower);
+    s->cds = CdS.Value();
+    s->left = leftLine.Value();
+    s->center = centerLine.Value();
+    s->right = rightLine.Value();
+    s->x = RPS.X();
+    s->y = RPS.Y();
+    s->heading = heading;
+    s->battery = batteryVolts;
+    //Switches read low when pressed
+    s->flags = !frontLeftSwitch.Value()*TELEMETRY_FRONT_LEFT | !frontRightSwitch.Value()*TELEMETRY_FRONT_RIGHT
+             | !backLeftSwitch.Value()*TELEMETRY_BACK_LEFT | !backRightSwitch.Value()*TELEMETRY_BACK_RIGHT
+             | !forkSwitch.Value()*TELEMETRY_FORK | drive.stalled*TELEMETRY_STALLED | (heading >= 0)*TELEMETRY_RPS;
+}
+
+//Function definition for the battery sampling task, a running average that settles in about a second
+void sampleBattery()
+{
+    batteryVolts += 0.05*(Battery.Voltage() - batteryVolts);
+}
+
+//Function definition for the battery display task, posts the battery voltage to the bottom status row
+void showBattery()
+{
+    char text[DISPLAY_COLS + 1] = "BATT: ";
+    StatusDisplay::Format(batteryVolts, text + 6);
+    strcat(text, " V");
+    status.Set(BATTERY_ROW, text);
 }
 
 //Functions for performance tests
@@ -876,22 +1420,10 @@ void p2()
     //Backing up off of the sink in order to allow for easy movement
     linearMove(-10, MOVE);
     pivot(-90, TURN);
-    leftMotor.SetPercent(-MOVE);
-    rightMotor.SetPercent(-MOVE);
-    while(microSwitchCheck(1))
-    {
-    }
-    leftMotor.Stop();
-    rightMotor.Stop();
+    hitWall(1, MOVE, 24);
 
     ticket();
-    rightMotor.SetPercent(-MOVE);
-    leftMotor.SetPercent(-MOVE);
-    while(backLeftSwitch.Value() == true)
-    {
-    }
-    rightMotor.Stop();
-    leftMotor.Stop();
+    until.Drive(-24, MOVE, driveEvent, EVENT_BACK_ANY, WALL_TIMEOUT);
     linearMove(2,MOVE);
     pivot(90, TURN);
     linearMove(20,MOVE);
@@ -899,37 +1431,19 @@ void p2()
 
 void p3()
 {
-    //This float is exclusively required to go up the ramp at a high speed but slow down to a slower speed without stopping to prevent the tray from flying off, the value in abs() is the distance being traveled
-    float start = (318.0/(WHEEL*PI))*abs(2);
-    float ramp = (318.0/(WHEEL*PI))*abs(22);
     //Performance test 3 code
     //This function is set up to start at the beginning of the course and move the robot up the ramp and dump the tray at the sink
-    //Going up ramp from starting position
-    rightMotor.SetPercent(0.65*MOVE);
-    leftMotor.SetPercent(0.65*MOVE);
-    while(leftEncoder.Counts() < start)
-    {
-    }
-    linearMove(8, MOVE);
-    pivot(45, TURN);
-    //A chunk of the linearMove function is used here in order to move a set distance to get up the ramp, however, it is modified to not stop the motors so that the robot can
-    //instead switch to a slower speed without stopping in order to prevent the tray from flying off of the robot
-    rightMotor.SetPercent(1.5*MOVE);
-    leftMotor.SetPercent(1.5*MOVE);
-    while(leftEncoder.Counts() < ramp)
-    {
-    }
-    linearMove(18, MOVE);
+    //Going up ramp from starting position, the queue changes speed between moves without stopping so the tray doesn't fly off
+    motion.Line(2, 0.65*MOVE);
+    motion.Line(8, MOVE, true);
+    motion.Pivot(45, TURN);
+    motion.Line(22, 1.5*MOVE);
+    motion.Line(18, MOVE);
     //Turning towards ticket
-    pivot(90, TURN);
+    motion.Pivot(90, TURN);
+    motion.Run();
     //Moving until the front microswitches activate off of the wall
-    leftMotor.SetPercent(MOVE);
-    rightMotor.SetPercent(MOVE);
-    while(microSwitchCheck(0))
-    {
-    }
-    leftMotor.Stop();
-    rightMotor.Stop();
+    hitWall(0, MOVE, 24);
     burger();
     pivot(-135, TURN);
     linearMove(12, MOVE);